@@ -3,12 +3,17 @@
 //#include "EngineMinimal.h"
 #include "Engine/Engine.h"
 #include "CoreMinimal.h"
+#include "OpenInputPlugin.h"
+#include "OpenInputSkeletalBackend.h"
+#include "OpenInputSkeletalActionRegistry.h"
+#include "OpenInputSamplingThread.h"
+#include "HAL/IConsoleManager.h"
 //#include "IXRTrackingSystem.h"
 //#include "IHeadMountedDisplay.h"
 
 
 //General Log
-//DEFINE_LOG_CATEGORY(OpenVRExpansionFunctionLibraryLog);
+DEFINE_LOG_CATEGORY(OpenInputFunctionLibraryLog);
 
 UOpenInputFunctionLibrary::UOpenInputFunctionLibrary(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -23,3 +28,658 @@ UOpenInputFunctionLibrary::~UOpenInputFunctionLibrary()
 	//	UnloadOpenVRModule();
 #endif
 }
+
+// Returns the active backend if it can currently service queries
+static IOpenInputSkeletalBackend * GetAvailableSkeletalBackend()
+{
+	IOpenInputSkeletalBackend * Backend = FOpenInputPluginModule::GetSkeletalBackend();
+	return (Backend && Backend->IsAvailable()) ? Backend : nullptr;
+}
+
+// Runtime side bone scratch space, sized so the standard hand skeleton never touches the heap
+typedef TArray<vr::VRBoneTransform_t, TInlineAllocator<(uint32)EVROpenInputBones::eBone_Count>> FOpenInputBoneTransformBuffer;
+
+// Moves the current transforms into the old slot and sizes the current ones for the new pose.
+// Swapping instead of copying means neither array allocates once both have grown to the skeleton size.
+static void RotateSkeletalTransforms(FBPOpenVRActionInfo & Action)
+{
+	if (Action.SkeletalData.SkeletalTransforms.Num() > 0)
+	{
+		Swap(Action.OldSkeletalTransforms, Action.SkeletalData.SkeletalTransforms);
+	}
+
+	Action.SkeletalData.SkeletalTransforms.SetNumUninitialized(Action.BoneCount, false);
+	Action.NotifyPoseChanged();
+}
+
+// Parent of each EVROpenInputBones bone in the OpenVR hand skeleton, for actions that never got a hierarchy from the runtime (remote hands)
+static const int8 OpenInputDefaultBoneParents[(uint8)EVROpenInputBones::eBone_Count] =
+{
+	-1, // Root
+	0, // Wrist
+	1, 2, 3, 4, // Thumb
+	1, 6, 7, 8, 9, // Index
+	1, 11, 12, 13, 14, // Middle
+	1, 16, 17, 18, 19, // Ring
+	1, 21, 22, 23, 24, // Pinky
+	1, 1, 1, 1, 1 // Aux
+};
+
+const TArray<FTransform> & FBPOpenVRActionInfo::GetComponentSpaceTransforms() const
+{
+	FOpenInputBoneSpaceCache & Cache = BoneSpaceCache;
+
+	if (Cache.ComponentSpaceSerial == PoseSerial)
+		return Cache.ComponentSpaceTransforms;
+
+	const TArray<FTransform> & Transforms = SkeletalData.SkeletalTransforms;
+	const int32 NumBones = Transforms.Num();
+
+	Cache.ComponentSpaceSerial = PoseSerial;
+	Cache.ComponentSpaceTransforms.SetNumUninitialized(NumBones, false);
+
+	const bool bHasHierarchy = BoneParentIndexes.Num() == NumBones;
+	if (!bHasHierarchy && NumBones > (uint8)EVROpenInputBones::eBone_Count)
+	{
+		// No way to know how an unknown skeleton hangs together
+		Cache.ComponentSpaceTransforms = Transforms;
+		return Cache.ComponentSpaceTransforms;
+	}
+
+	// The runtime hands out parents before children, so a single forward pass normally does it.
+	// Anything out of order is picked up by further passes once its parent is resolved.
+	Cache.ResolvedBones.Init(false, NumBones);
+	int32 NumResolved = 0;
+
+	while (NumResolved < NumBones)
+	{
+		const int32 ResolvedBefore = NumResolved;
+
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			if (Cache.ResolvedBones[BoneIndex])
+				continue;
+
+			const int32 ParentIndex = bHasHierarchy ? BoneParentIndexes[BoneIndex] : OpenInputDefaultBoneParents[BoneIndex];
+
+			if (ParentIndex < 0 || ParentIndex >= NumBones || ParentIndex == BoneIndex)
+			{
+				Cache.ComponentSpaceTransforms[BoneIndex] = Transforms[BoneIndex];
+			}
+			else if (Cache.ResolvedBones[ParentIndex])
+			{
+				Cache.ComponentSpaceTransforms[BoneIndex] = Transforms[BoneIndex] * Cache.ComponentSpaceTransforms[ParentIndex];
+			}
+			else
+			{
+				continue;
+			}
+
+			Cache.ResolvedBones[BoneIndex] = true;
+			++NumResolved;
+		}
+
+		// A cycle in the hierarchy, leave the rest in parent space rather than spin
+		if (NumResolved == ResolvedBefore)
+		{
+			for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+			{
+				if (!Cache.ResolvedBones[BoneIndex])
+					Cache.ComponentSpaceTransforms[BoneIndex] = Transforms[BoneIndex];
+			}
+			break;
+		}
+	}
+
+	return Cache.ComponentSpaceTransforms;
+}
+
+const TArray<FTransform> & FBPOpenVRActionInfo::GetWorldSpaceTransforms(const FTransform & ComponentToWorld) const
+{
+	FOpenInputBoneSpaceCache & Cache = BoneSpaceCache;
+
+	if (Cache.WorldSpaceSerial == PoseSerial && Cache.WorldSpaceBase.Equals(ComponentToWorld, 0.f))
+		return Cache.WorldSpaceTransforms;
+
+	const TArray<FTransform> & ComponentSpace = GetComponentSpaceTransforms();
+
+	Cache.WorldSpaceSerial = PoseSerial;
+	Cache.WorldSpaceBase = ComponentToWorld;
+	Cache.WorldSpaceTransforms.SetNumUninitialized(ComponentSpace.Num(), false);
+
+	for (int32 BoneIndex = 0; BoneIndex < ComponentSpace.Num(); ++BoneIndex)
+	{
+		Cache.WorldSpaceTransforms[BoneIndex] = ComponentSpace[BoneIndex] * ComponentToWorld;
+	}
+
+	return Cache.WorldSpaceTransforms;
+}
+
+static TAutoConsoleVariable<int32> CVarOpenInputScalarBoneConversion(
+	TEXT("vr.OpenInput.ScalarBoneConversion"),
+	0,
+	TEXT("1 converts runtime bones with the scalar reference path instead of the vectorized kernel"),
+	ECVF_Default);
+
+// How MIRROR_OPENINPUT_BONES treats each bone, indexed by EVROpenInputBones
+namespace OpenInputBoneMirror
+{
+	enum Type : uint8
+	{
+		None,
+		TranslationOnly,
+		Full,
+		Partial
+	};
+
+	static const uint8 Kinds[(uint8)EVROpenInputBones::eBone_Count] =
+	{
+		None,											// Root
+		Partial,										// Wrist
+		Full, TranslationOnly, TranslationOnly, TranslationOnly,		// Thumb
+		Full, TranslationOnly, TranslationOnly, TranslationOnly, TranslationOnly,	// Index
+		Full, TranslationOnly, TranslationOnly, TranslationOnly, TranslationOnly,	// Middle
+		Full, TranslationOnly, TranslationOnly, TranslationOnly, TranslationOnly,	// Ring
+		Full, TranslationOnly, TranslationOnly, TranslationOnly, TranslationOnly,	// Pinky
+		Partial, Partial, Partial, Partial, Partial		// Aux
+	};
+}
+
+void UOpenInputFunctionLibrary::CONVERT_STEAMTRANS_TO_FTRANS_BATCH_Scalar(const vr::VRBoneTransform_t * InTransforms, FTransform * OutTransforms, int32 BoneCount, float WorldToMeters, bool bMirrorLeftRight)
+{
+	if (bMirrorLeftRight)
+	{
+		FOpenInputBoneTransformBuffer MirroredTransforms;
+		MirroredTransforms.Append(InTransforms, BoneCount);
+		MIRROR_OPENINPUT_BONES(MirroredTransforms);
+
+		for (int i = 0; i < BoneCount; ++i)
+			OutTransforms[i] = CONVERT_STEAMTRANS_TO_FTRANS(MirroredTransforms[i], WorldToMeters);
+	}
+	else
+	{
+		for (int i = 0; i < BoneCount; ++i)
+			OutTransforms[i] = CONVERT_STEAMTRANS_TO_FTRANS(InTransforms[i], WorldToMeters);
+	}
+}
+
+void UOpenInputFunctionLibrary::CONVERT_STEAMTRANS_TO_FTRANS_BATCH(const vr::VRBoneTransform_t * InTransforms, FTransform * OutTransforms, int32 BoneCount, float WorldToMeters, bool bMirrorLeftRight)
+{
+#if ENABLE_VECTORIZED_TRANSFORM
+	if (CVarOpenInputScalarBoneConversion.GetValueOnAnyThread() != 0)
+#endif
+	{
+		CONVERT_STEAMTRANS_TO_FTRANS_BATCH_Scalar(InTransforms, OutTransforms, BoneCount, WorldToMeters, bMirrorLeftRight);
+		return;
+	}
+
+#if ENABLE_VECTORIZED_TRANSFORM
+	// Runtime quats are stored (w, x, y, z), positions (x, y, z, pad).
+	// Every mirror case reduces to one swizzle and one sign / scale multiply per component:
+	//		None / TranslationOnly	Rot = ( -z,  x,  y, -w )
+	//		Full					Rot = (  y, -w,  z, -x )
+	//		Partial					Rot = (  z,  x, -y, -w )
+	// and positions always come out as (z, x, y) with per case signs folded into the world scale.
+	const VectorRegister RotSignsDefault = MakeVectorRegister(-1.f, 1.f, 1.f, -1.f);
+	const VectorRegister RotSignsFull = MakeVectorRegister(1.f, -1.f, 1.f, -1.f);
+	const VectorRegister RotSignsPartial = MakeVectorRegister(1.f, 1.f, -1.f, -1.f);
+
+	const VectorRegister PosScaleDefault = MakeVectorRegister(-WorldToMeters, WorldToMeters, WorldToMeters, 0.f);
+	const VectorRegister PosScaleTranslationOnly = MakeVectorRegister(WorldToMeters, -WorldToMeters, -WorldToMeters, 0.f);
+	const VectorRegister PosScaleMirrored = MakeVectorRegister(-WorldToMeters, -WorldToMeters, WorldToMeters, 0.f);
+
+	FQuat OutRotation;
+	FVector OutTranslation;
+
+	for (int i = 0; i < BoneCount; ++i)
+	{
+		const vr::VRBoneTransform_t & InTrans = InTransforms[i];
+
+		VectorRegister Rotation = VectorLoad(&InTrans.orientation.w);
+		VectorRegister Translation = VectorSwizzle(VectorLoad(&InTrans.position.v[0]), 2, 0, 1, 3);
+
+		uint8 MirrorKind = (bMirrorLeftRight && i < (int32)EVROpenInputBones::eBone_Count) ? OpenInputBoneMirror::Kinds[i] : OpenInputBoneMirror::None;
+
+		switch (MirrorKind)
+		{
+		case OpenInputBoneMirror::Full:
+		{
+			Rotation = VectorMultiply(VectorSwizzle(Rotation, 2, 0, 3, 1), RotSignsFull);
+			Translation = VectorMultiply(Translation, PosScaleMirrored);
+		}break;
+		case OpenInputBoneMirror::Partial:
+		{
+			Rotation = VectorMultiply(VectorSwizzle(Rotation, 3, 1, 2, 0), RotSignsPartial);
+			Translation = VectorMultiply(Translation, PosScaleMirrored);
+		}break;
+		case OpenInputBoneMirror::TranslationOnly:
+		{
+			Rotation = VectorMultiply(VectorSwizzle(Rotation, 3, 1, 2, 0), RotSignsDefault);
+			Translation = VectorMultiply(Translation, PosScaleTranslationOnly);
+		}break;
+		default:
+		{
+			Rotation = VectorMultiply(VectorSwizzle(Rotation, 3, 1, 2, 0), RotSignsDefault);
+			Translation = VectorMultiply(Translation, PosScaleDefault);
+		}break;
+		}
+
+		VectorStoreAligned(Rotation, &OutRotation);
+		VectorStoreFloat3(Translation, &OutTranslation);
+		OutTransforms[i].SetComponents(OutRotation, OutTranslation, FVector::OneVector);
+	}
+#endif
+}
+
+static FAutoConsoleCommand CVarOpenInputBenchmarkBoneConversion(
+	TEXT("vr.OpenInput.BenchmarkBoneConversion"),
+	TEXT("Times the vectorized bone conversion against the scalar path, OpenInput.Conversion.BatchMatchesScalar checks they match. Optional arg: iteration count"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100000;
+
+		FOpenInputSyntheticHandFrame Frame;
+		FOpenInputSyntheticSkeletalBackend::GenerateHandFrame(0.37, 2.f, true, Frame);
+		const int32 BoneCount = Frame.BoneTransforms.Num();
+
+		TArray<FTransform> ScalarOut, VectorOut;
+		ScalarOut.SetNum(BoneCount);
+		VectorOut.SetNum(BoneCount);
+
+		for (int32 Mirror = 0; Mirror < 2; ++Mirror)
+		{
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+				UOpenInputFunctionLibrary::CONVERT_STEAMTRANS_TO_FTRANS_BATCH_Scalar(Frame.BoneTransforms.GetData(), ScalarOut.GetData(), BoneCount, 100.f, Mirror != 0);
+			double ScalarTime = FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+				UOpenInputFunctionLibrary::CONVERT_STEAMTRANS_TO_FTRANS_BATCH(Frame.BoneTransforms.GetData(), VectorOut.GetData(), BoneCount, 100.f, Mirror != 0);
+			double VectorTime = FPlatformTime::Seconds() - StartTime;
+
+			UE_LOG(OpenInputFunctionLibraryLog, Display, TEXT("Bone conversion (%s): scalar %.3fms, batch %.3fms, %.2fx over %d iterations"),
+				Mirror ? TEXT("mirrored") : TEXT("unmirrored"), ScalarTime * 1000.0, VectorTime * 1000.0, VectorTime > 0.0 ? ScalarTime / VectorTime : 0.0, Iterations);
+		}
+	}));
+
+// Only re-copies the bone count / hierarchy / tracking level when the registry reloaded them
+static void CopyRegistryMetadata(FBPOpenVRActionInfo & Action, const FOpenInputSkeletalActionEntry & Entry)
+{
+	if (Action.RegistrySerial != Entry.Serial)
+	{
+		Action.BoneCount = Entry.BoneCount;
+		Action.BoneParentIndexes = Entry.BoneParentIndexes;
+		Action.SkeletalTrackingLevel = Entry.TrackingLevel;
+		Action.RegistrySerial = Entry.Serial;
+	}
+}
+
+static void FillGestureValues(FBPOpenVRActionInfo & Action, const float * FingerCurls, const float * FingerSplays)
+{
+	Action.PoseFingerData.PoseFingerCurls.Reset(vr::VRFinger_Count);
+	for (int i = 0; i < vr::VRFinger_Count; ++i)
+	{
+		Action.PoseFingerData.PoseFingerCurls.Add(FingerCurls[i]);
+	}
+
+	if (Action.SkeletalTrackingLevel == EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full)
+	{
+		Action.PoseFingerData.PoseFingerSplays.Reset(vr::VRFingerSplay_Count);
+		for (int i = 0; i < vr::VRFingerSplay_Count; ++i)
+		{
+			Action.PoseFingerData.PoseFingerSplays.Add(FingerSplays[i]);
+		}
+	}
+}
+
+const FString & UOpenInputFunctionLibrary::GetDefaultSkeletalActionName(EVRActionHand TargetHand)
+{
+	return TargetHand == EVRActionHand::EActionHand_Left ? OpenInputFunctionLibraryStatics::LeftHand_SkeletalActionName : OpenInputFunctionLibraryStatics::RightHand_SkeletalActionName;
+}
+
+const int8 * UOpenInputFunctionLibrary::GetDefaultBoneParents()
+{
+	return OpenInputDefaultBoneParents;
+}
+
+bool UOpenInputFunctionLibrary::DecompressSkeletalData(FBPOpenVRActionInfo & Action, UWorld * WorldToUseForScale)
+{
+	if (Action.CompressedTransforms.Num() < 1 || !WorldToUseForScale)
+		return false;
+
+	IOpenInputSkeletalBackend * Backend = GetAvailableSkeletalBackend();
+
+	Action.bHasValidData = false;
+
+	if (!Backend)
+		return false;
+
+	FOpenInputBoneTransformBuffer BoneTransforms;
+	BoneTransforms.AddZeroed(Action.BoneCount);
+
+	Action.CompressedSize = Action.CompressedTransforms.Num();
+
+	vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
+	InputError = Backend->DecompressSkeletalBoneData(Action.CompressedTransforms.GetData(), Action.CompressedSize, BoneTransforms.GetData(), Action.BoneCount);
+
+	if (InputError != vr::EVRInputError::VRInputError_None)
+		return false;
+
+	RotateSkeletalTransforms(Action);
+
+	float WorldToMeters = Action.SkeletalData.WorldScaleOverride > 0.0f ? Action.SkeletalData.WorldScaleOverride : ((WorldToUseForScale != nullptr) ? WorldToUseForScale->GetWorldSettings()->WorldToMeters : 100.f);
+
+	CONVERT_STEAMTRANS_TO_FTRANS_BATCH(BoneTransforms.GetData(), Action.SkeletalData.SkeletalTransforms.GetData(), BoneTransforms.Num(), WorldToMeters, Action.SkeletalData.bMirrorLeftRight);
+	Action.SampleTime = FPlatformTime::Seconds();
+
+	Action.bHasValidData = true;
+	return true;
+}
+
+EOpenInputPoseProducts UOpenInputFunctionLibrary::MakePoseProducts(bool bGetBones, bool bGetGestureValues, bool bGetCompressedData)
+{
+	EOpenInputPoseProducts Products = EOpenInputPoseProducts::TrackingLevel;
+
+	if (bGetBones)
+		Products |= EOpenInputPoseProducts::Bones;
+
+	if (bGetGestureValues)
+		Products |= EOpenInputPoseProducts::Summary;
+
+	if (bGetCompressedData)
+		Products |= EOpenInputPoseProducts::Compressed;
+
+	return Products;
+}
+
+bool UOpenInputFunctionLibrary::GetActionPose(FBPOpenVRActionInfo & Action, UObject* WorldContextObject, bool bGetCompressedData, bool bGetGestureValues)
+{
+	return GetActionPoseProducts(Action, WorldContextObject, MakePoseProducts(true, bGetGestureValues, bGetCompressedData));
+}
+
+bool UOpenInputFunctionLibrary::GetActionPoseProducts(FBPOpenVRActionInfo & Action, UObject* WorldContextObject, EOpenInputPoseProducts Products)
+{
+	IOpenInputSkeletalBackend * Backend = GetAvailableSkeletalBackend();
+	FOpenInputSkeletalActionRegistry * Registry = FOpenInputPluginModule::GetActionRegistry();
+
+	Action.bHasValidData = false;
+
+	if (!Backend || !Registry)
+		return false;
+
+	vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
+
+	// Not filling in the field as that is a waste, just assuming from the data sent in
+	// Still allowing overriding manually though
+	if (Action.ActionName.IsEmpty())
+	{
+		Action.ActionName = GetDefaultSkeletalActionName(Action.SkeletalData.TargetHand);
+	}
+
+	FOpenInputSkeletalActionEntry * Entry = Registry->ResolveAction(Backend, Action.ActionName, Action.RegistryIndex);
+	if (!Entry)
+	{
+		Action.ActionHandleContainer.ActionHandle = vr::k_ulInvalidActionHandle;
+		return false;
+	}
+
+	Action.ActionHandleContainer.ActionHandle = Entry->ActionHandle;
+
+	vr::InputSkeletalActionData_t SkeletalData;
+	InputError = Backend->GetSkeletalActionData(Action.ActionHandleContainer.ActionHandle, SkeletalData);
+
+	// If the handle doesn't map to a correct action handle anymore, have it looked up again next time
+	if (InputError == vr::EVRInputError::VRInputError_InvalidHandle)
+	{
+		Registry->InvalidateHandle(*Entry);
+		Action.ActionHandleContainer.ActionHandle = vr::k_ulInvalidActionHandle;
+		return false;
+	}
+
+	if (InputError != vr::EVRInputError::VRInputError_None || !SkeletalData.bActive)
+		return false;
+
+	// Swapping controllers changes the origin, which drops the cached skeleton for this action
+	Registry->NotifyActiveOrigin(*Entry, SkeletalData.activeOrigin);
+
+	if (!Registry->EnsureMetadata(Backend, *Entry))
+		return false;
+
+	CopyRegistryMetadata(Action, *Entry);
+
+	// If we are supposed to get gesture values, load them too
+	if (EnumHasAnyFlags(Products, EOpenInputPoseProducts::Summary))
+	{
+		vr::VRSkeletalSummaryData_t SkeletalSummaryData;
+		InputError = Backend->GetSkeletalSummaryData(Action.ActionHandleContainer.ActionHandle, SkeletalSummaryData);
+
+		if (InputError != vr::EVRInputError::VRInputError_None)
+			return false;
+
+		FillGestureValues(Action, SkeletalSummaryData.flFingerCurl, SkeletalSummaryData.flFingerSplay);
+	}
+
+	FOpenInputBoneTransformBuffer BoneTransforms;
+	const bool bGetBones = EnumHasAnyFlags(Products, EOpenInputPoseProducts::Bones);
+
+	vr::EVRSkeletalMotionRange MotionTypeToGet = Action.bGetSkeletalTransforms_WithController ? vr::EVRSkeletalMotionRange::VRSkeletalMotionRange_WithController : vr::EVRSkeletalMotionRange::VRSkeletalMotionRange_WithoutController;
+
+	if (bGetBones)
+	{
+		BoneTransforms.AddZeroed(Action.BoneCount);
+		InputError = Backend->GetSkeletalBoneData(Action.ActionHandleContainer.ActionHandle, MotionTypeToGet, BoneTransforms.GetData(), Action.BoneCount);
+	}
+
+	if (InputError != vr::EVRInputError::VRInputError_None)
+		return false;
+
+	// We got the transforms normally for the local player as they don't have the artifacts, but we get the compressed ones for remote sending
+	if (EnumHasAnyFlags(Products, EOpenInputPoseProducts::Compressed))
+	{
+		// Write straight into the persistent buffer and trim to what was used, keeping the slack for next time
+		int32 MaxArraySize = ((sizeof(vr::VRBoneTransform_t) * Action.BoneCount) + 2);
+		Action.CompressedTransforms.SetNumUninitialized(MaxArraySize, false);
+
+		InputError = Backend->GetSkeletalBoneDataCompressed(Action.ActionHandleContainer.ActionHandle, MotionTypeToGet, Action.CompressedTransforms.GetData(), MaxArraySize, &Action.CompressedSize);
+
+		if (InputError != vr::EVRInputError::VRInputError_None)
+			Action.CompressedSize = 0;
+
+		Action.CompressedTransforms.SetNumUninitialized(FMath::Min<int32>(Action.CompressedSize, MaxArraySize), false);
+	}
+
+	if (InputError != vr::EVRInputError::VRInputError_None)
+		return false;
+
+	if (bGetBones)
+	{
+		RotateSkeletalTransforms(Action);
+
+		UWorld* World = (WorldContextObject) ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+		float WorldToMeters = Action.SkeletalData.WorldScaleOverride > 0.0f ? Action.SkeletalData.WorldScaleOverride : ((World != nullptr) ? World->GetWorldSettings()->WorldToMeters : 100.f);
+
+		CONVERT_STEAMTRANS_TO_FTRANS_BATCH(BoneTransforms.GetData(), Action.SkeletalData.SkeletalTransforms.GetData(), BoneTransforms.Num(), WorldToMeters, Action.SkeletalData.bMirrorLeftRight);
+		Action.SampleTime = FPlatformTime::Seconds();
+	}
+
+	Action.bHasValidData = true;
+	return true;
+}
+
+bool UOpenInputFunctionLibrary::ApplyRawPoseSample(FBPOpenVRActionInfo & Action, const FOpenInputRawPoseSample & Sample, UObject* WorldContextObject, bool bGetGestureValues)
+{
+	IOpenInputSkeletalBackend * Backend = GetAvailableSkeletalBackend();
+	FOpenInputSkeletalActionRegistry * Registry = FOpenInputPluginModule::GetActionRegistry();
+
+	Action.bHasValidData = false;
+
+	if (!Backend || !Registry || !Sample.bActive)
+		return false;
+
+	if (Action.ActionName.IsEmpty())
+	{
+		Action.ActionName = GetDefaultSkeletalActionName(Action.SkeletalData.TargetHand);
+	}
+
+	// Samples outlive handle changes, only take ones taken against what the registry currently has
+	FOpenInputSkeletalActionEntry * Entry = Registry->ResolveAction(Backend, Action.ActionName, Action.RegistryIndex);
+	if (!Entry || Entry->ActionHandle != Sample.ActionHandle)
+		return false;
+
+	Action.ActionHandleContainer.ActionHandle = Entry->ActionHandle;
+	Registry->NotifyActiveOrigin(*Entry, Sample.ActiveOrigin);
+
+	if (!Registry->EnsureMetadata(Backend, *Entry))
+		return false;
+
+	CopyRegistryMetadata(Action, *Entry);
+
+	if (Sample.BoneCount != (uint32)Action.BoneCount)
+		return false;
+
+	if (bGetGestureValues)
+	{
+		FillGestureValues(Action, Sample.FingerCurls, Sample.FingerSplays);
+	}
+
+	Action.CompressedSize = 0;
+	Action.CompressedTransforms.Reset();
+
+	RotateSkeletalTransforms(Action);
+
+	UWorld* World = (WorldContextObject) ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	float WorldToMeters = Action.SkeletalData.WorldScaleOverride > 0.0f ? Action.SkeletalData.WorldScaleOverride : ((World != nullptr) ? World->GetWorldSettings()->WorldToMeters : 100.f);
+
+	CONVERT_STEAMTRANS_TO_FTRANS_BATCH(Sample.BoneTransforms, Action.SkeletalData.SkeletalTransforms.GetData(), Sample.BoneCount, WorldToMeters, Action.SkeletalData.bMirrorLeftRight);
+	Action.SampleTime = Sample.Timestamp;
+
+	Action.bHasValidData = true;
+	return true;
+}
+
+bool UOpenInputFunctionLibrary::GetReferencePose(FBPOpenVRActionInfo & BlankActionToFill, FBPOpenVRActionHandle ActionHandleToQuery, UObject* WorldContextObject, EVROpenInputReferencePose PoseTypeToRetreive)
+{
+	IOpenInputSkeletalBackend * Backend = GetAvailableSkeletalBackend();
+
+	BlankActionToFill.bHasValidData = false;
+	//BlankActionToFill.SkeletalData.bGetTransformsInParentSpace = bGetTransformsInParentSpace;
+	BlankActionToFill.ActionHandleContainer = ActionHandleToQuery;
+
+	if (!Backend)
+		return false;
+
+	vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
+
+	uint32 boneCount = 0;
+	InputError = Backend->GetBoneCount(BlankActionToFill.ActionHandleContainer.ActionHandle, boneCount);
+
+	// If the handle doesn't map to a correct action handle
+	// Should likely throw an error here and stop getting a handle
+	if (InputError == vr::EVRInputError::VRInputError_InvalidHandle)
+	{
+		BlankActionToFill.ActionHandleContainer.ActionHandle = vr::k_ulInvalidActionHandle;
+		return false;
+	}
+
+	vr::InputSkeletalActionData_t SkeletalData;
+	InputError = Backend->GetSkeletalActionData(BlankActionToFill.ActionHandleContainer.ActionHandle, SkeletalData);
+
+	if (InputError != vr::EVRInputError::VRInputError_None || !SkeletalData.bActive || boneCount < 1)
+		return false;
+
+	// Set bone count so we can reference it later
+	BlankActionToFill.BoneCount = boneCount;
+
+	FOpenInputBoneTransformBuffer BoneTransforms;
+	BoneTransforms.AddZeroed(BlankActionToFill.BoneCount);
+
+	{
+		InputError = Backend->GetSkeletalReferenceTransforms(
+			BlankActionToFill.ActionHandleContainer.ActionHandle,
+			(vr::EVRSkeletalReferencePose)PoseTypeToRetreive,
+			BoneTransforms.GetData(),
+			BlankActionToFill.BoneCount);
+
+		BlankActionToFill.CompressedSize = 0;
+		BlankActionToFill.CompressedTransforms.Reset();
+	}
+
+	if (InputError != vr::EVRInputError::VRInputError_None)
+		return false;
+
+	RotateSkeletalTransforms(BlankActionToFill);
+
+	UWorld* World = (WorldContextObject) ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	float WorldToMeters = BlankActionToFill.SkeletalData.WorldScaleOverride > 0.0f ? BlankActionToFill.SkeletalData.WorldScaleOverride : ((World != nullptr) ? World->GetWorldSettings()->WorldToMeters : 100.f);
+
+	CONVERT_STEAMTRANS_TO_FTRANS_BATCH(BoneTransforms.GetData(), BlankActionToFill.SkeletalData.SkeletalTransforms.GetData(), BoneTransforms.Num(), WorldToMeters, BlankActionToFill.SkeletalData.bMirrorLeftRight);
+
+	BlankActionToFill.bHasValidData = true;
+	return true;
+}
+
+bool UOpenInputFunctionLibrary::GetHandCurlAndSplayValues(EVRActionHand TargetHand, FBPOpenVRGesturePoseData & CurlAndSplayValuesOut, UObject* WorldContextObject, FString OptionalCustomActionName)
+{
+	IOpenInputSkeletalBackend * Backend = GetAvailableSkeletalBackend();
+	FOpenInputSkeletalActionRegistry * Registry = FOpenInputPluginModule::GetActionRegistry();
+
+	if (!Backend || !Registry)
+		return false;
+
+	vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
+
+	int32 RegistryIndex = INDEX_NONE;
+	FOpenInputSkeletalActionEntry * Entry = Registry->ResolveAction(Backend, OptionalCustomActionName.IsEmpty() ? GetDefaultSkeletalActionName(TargetHand) : OptionalCustomActionName, RegistryIndex);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	vr::VRSkeletalSummaryData_t SkeletalSummaryData;
+	InputError = Backend->GetSkeletalSummaryData(Entry->ActionHandle, SkeletalSummaryData);
+
+	if (InputError == vr::EVRInputError::VRInputError_InvalidHandle)
+		Registry->InvalidateHandle(*Entry);
+
+	if (InputError != vr::EVRInputError::VRInputError_None)
+		return false;
+
+	CurlAndSplayValuesOut.PoseFingerCurls.Reset(vr::VRFinger_Count);
+	for (int i = 0; i < vr::VRFinger_Count; ++i)
+	{
+		CurlAndSplayValuesOut.PoseFingerCurls.Add(SkeletalSummaryData.flFingerCurl[i]);
+	}
+
+	CurlAndSplayValuesOut.PoseFingerSplays.Reset(vr::VRFingerSplay_Count);
+	for (int i = 0; i < vr::VRFingerSplay_Count; ++i)
+	{
+		CurlAndSplayValuesOut.PoseFingerSplays.Add(SkeletalSummaryData.flFingerSplay[i]);
+	}
+
+	return true;
+}
+
+bool UOpenInputFunctionLibrary::GetSkeletalTrackingLevel(EVROpenInputSkeletalTrackingLevel & SkeletalTrackingLevelOut, EVRActionHand HandToRetreive)
+{
+	IOpenInputSkeletalBackend * Backend = GetAvailableSkeletalBackend();
+	FOpenInputSkeletalActionRegistry * Registry = FOpenInputPluginModule::GetActionRegistry();
+
+	SkeletalTrackingLevelOut = EVROpenInputSkeletalTrackingLevel::VRSkeletalTrackingLevel_Max;
+
+	if (!Backend || !Registry)
+		return false;
+
+	// Nothing else may be pulling action data for this hand, so make sure a controller swap is noticed
+	Registry->PollDeviceChanges(Backend);
+
+	int32 RegistryIndex = INDEX_NONE;
+	FOpenInputSkeletalActionEntry * Entry = Registry->ResolveAction(Backend, GetDefaultSkeletalActionName(HandToRetreive), RegistryIndex);
+	if (!Entry || !Registry->EnsureMetadata(Backend, *Entry))
+	{
+		return false;
+	}
+
+	SkeletalTrackingLevelOut = Entry->TrackingLevel;
+	return true;
+}
@@ -0,0 +1,1015 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputGestureMatcher.h"
+#include "OpenInputSkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/Sort.h"
+#include "Math/RandomStream.h"
+
+// Threshold given to values a gesture never recorded, they always pass and don't add to the distance
+static const float OpenInputUncheckedThreshold = MAX_flt;
+
+// Shared by every compiled set so a fresh one never reuses a serial a recognizer has already seen
+static uint32 OpenInputDynamicGestureSerial = 0;
+
+int32 FOpenInputGestureTable::FindFirstMatch(const float * HandValues, int32 NumLanesToTest) const
+{
+	for (int32 Column = 0; Column < NumPadded; Column += 4)
+	{
+		VectorRegister Matches = GlobalVectorConstants::AllMask;
+
+		for (int32 Lane = 0; Lane < NumLanesToTest; ++Lane)
+		{
+			const int32 Offset = Lane * NumPadded + Column;
+			const VectorRegister Delta = VectorAbs(VectorSubtract(VectorLoad(&Values[Offset]), VectorLoadFloat1(&HandValues[Lane])));
+
+			// Same test as FMath::IsNearlyEqual, within or equal to the threshold
+			Matches = VectorBitwiseAnd(Matches, VectorCompareGE(VectorLoad(&Thresholds[Offset]), Delta));
+
+			if (!VectorMaskBits(Matches))
+				break;
+		}
+
+		if (const int32 MatchBits = VectorMaskBits(Matches))
+		{
+			return Column + (int32)FMath::CountTrailingZeros((uint32)MatchBits);
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+static void FillGestureTable(FOpenInputGestureTable & Table, const TArray<FOpenInputGesture> & Gestures, bool bUseSplays)
+{
+	const int32 NumLanes = FOpenInputGestureTable::NumLanes;
+
+	Table.NumGestures = Table.GestureIndices.Num();
+	Table.NumPadded = Align(Table.NumGestures, 4);
+
+	// Padding columns get a negative threshold so they never match
+	Table.Values.Init(0.f, NumLanes * Table.NumPadded);
+	Table.Thresholds.Init(-1.f, NumLanes * Table.NumPadded);
+
+	for (int32 Column = 0; Column < Table.NumGestures; ++Column)
+	{
+		const FOpenInputGesture & Gesture = Gestures[Table.GestureIndices[Column]];
+
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			const int32 Offset = Lane * Table.NumPadded + Column;
+
+			if (Lane < Gesture.FingerValues.Num() && (bUseSplays || Lane < vr::VRFinger_Count))
+			{
+				Table.Values[Offset] = Gesture.FingerValues[Lane].Value;
+				Table.Thresholds[Offset] = Gesture.FingerValues[Lane].Threshold;
+			}
+			else
+			{
+				// Values the gesture never recorded aren't checked
+				Table.Thresholds[Offset] = OpenInputUncheckedThreshold;
+			}
+		}
+	}
+}
+
+// Within threshold on every tested lane, and the squared distance over the lanes the gesture recorded
+static FORCEINLINE bool TestGestureColumn(const FOpenInputGestureTable & Table, int32 Column, const float * HandValues, int32 NumLanesToTest, float & OutDistSq)
+{
+	OutDistSq = 0.f;
+
+	for (int32 Lane = 0; Lane < NumLanesToTest; ++Lane)
+	{
+		const int32 Offset = Lane * Table.NumPadded + Column;
+		const float Threshold = Table.Thresholds[Offset];
+
+		if (Threshold == OpenInputUncheckedThreshold)
+			continue;
+
+		const float Delta = FMath::Abs(HandValues[Lane] - Table.Values[Offset]);
+		if (Delta > Threshold)
+			return false;
+
+		OutDistSq += Delta * Delta;
+	}
+
+	return true;
+}
+
+static FORCEINLINE void KeepBestMatch(int32 SourceIndex, float DistSq, int32 & InOutBestIndex, float & InOutBestDistSq)
+{
+	if (DistSq < InOutBestDistSq || (DistSq == InOutBestDistSq && (InOutBestIndex == INDEX_NONE || SourceIndex < InOutBestIndex)))
+	{
+		InOutBestIndex = SourceIndex;
+		InOutBestDistSq = DistSq;
+	}
+}
+
+void FOpenInputGestureKDTree::Build(const FOpenInputGestureTable & Table)
+{
+	Reset();
+
+	if (Table.NumGestures < 1)
+		return;
+
+	Columns.SetNumUninitialized(Table.NumGestures);
+	for (int32 Column = 0; Column < Table.NumGestures; ++Column)
+		Columns[Column] = Column;
+
+	Nodes.Reserve(2 * FMath::DivideAndRoundUp(Table.NumGestures, LeafSize));
+	Nodes.AddUninitialized();
+	BuildNode(Table, 0, 0, Table.NumGestures);
+}
+
+void FOpenInputGestureKDTree::BuildNode(const FOpenInputGestureTable & Table, int32 NodeIndex, int32 Start, int32 Count)
+{
+	const int32 NumLanes = FOpenInputGestureTable::NumLanes;
+
+	{
+		FNode & Node = Nodes[NodeIndex];
+		Node.FirstChild = INDEX_NONE;
+		Node.Start = Start;
+		Node.Count = Count;
+
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			Node.ValueMin[Lane] = Node.ReachMin[Lane] = MAX_flt;
+			Node.ValueMax[Lane] = Node.ReachMax[Lane] = -MAX_flt;
+		}
+
+		for (int32 i = Start; i < Start + Count; ++i)
+		{
+			for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+			{
+				const int32 Offset = Lane * Table.NumPadded + Columns[i];
+				const float Value = Table.Values[Offset];
+				const float Threshold = Table.Thresholds[Offset];
+
+				if (Threshold == OpenInputUncheckedThreshold)
+				{
+					// Matches anywhere and adds nothing to the distance, so nothing can be pruned on this lane
+					Node.ValueMin[Lane] = Node.ReachMin[Lane] = -MAX_flt;
+					Node.ValueMax[Lane] = Node.ReachMax[Lane] = MAX_flt;
+					continue;
+				}
+
+				Node.ValueMin[Lane] = FMath::Min(Node.ValueMin[Lane], Value);
+				Node.ValueMax[Lane] = FMath::Max(Node.ValueMax[Lane], Value);
+				Node.ReachMin[Lane] = FMath::Min(Node.ReachMin[Lane], Value - Threshold);
+				Node.ReachMax[Lane] = FMath::Max(Node.ReachMax[Lane], Value + Threshold);
+			}
+		}
+	}
+
+	if (Count <= LeafSize)
+		return;
+
+	// Split at the median of the lane the values are most spread out on
+	int32 SplitLane = 0;
+	float BestSpread = -1.f;
+
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		float MinValue = MAX_flt;
+		float MaxValue = -MAX_flt;
+
+		for (int32 i = Start; i < Start + Count; ++i)
+		{
+			const float Value = Table.Values[Lane * Table.NumPadded + Columns[i]];
+			MinValue = FMath::Min(MinValue, Value);
+			MaxValue = FMath::Max(MaxValue, Value);
+		}
+
+		if (MaxValue - MinValue > BestSpread)
+		{
+			BestSpread = MaxValue - MinValue;
+			SplitLane = Lane;
+		}
+	}
+
+	const float * LaneValues = &Table.Values[SplitLane * Table.NumPadded];
+	Algo::Sort(MakeArrayView(Columns.GetData() + Start, Count), [LaneValues](int32 A, int32 B)
+	{
+		return LaneValues[A] < LaneValues[B];
+	});
+
+	const int32 FirstChild = Nodes.Num();
+	Nodes.AddUninitialized(2);
+	Nodes[NodeIndex].FirstChild = FirstChild;
+
+	const int32 LeftCount = Count / 2;
+	BuildNode(Table, FirstChild, Start, LeftCount);
+	BuildNode(Table, FirstChild + 1, Start + LeftCount, Count - LeftCount);
+}
+
+// Squared distance from the pose to the nodes value box, negative if the pose is outside its reach
+static FORCEINLINE float GetNodeLowerBound(const FOpenInputGestureKDTree::FNode & Node, const float * HandValues, int32 NumLanesToTest)
+{
+	float LowerBound = 0.f;
+
+	for (int32 Lane = 0; Lane < NumLanesToTest; ++Lane)
+	{
+		const float Value = HandValues[Lane];
+
+		if (Value < Node.ReachMin[Lane] || Value > Node.ReachMax[Lane])
+			return -1.f;
+
+		const float Delta = Value < Node.ValueMin[Lane] ? Node.ValueMin[Lane] - Value : (Value > Node.ValueMax[Lane] ? Value - Node.ValueMax[Lane] : 0.f);
+		LowerBound += Delta * Delta;
+	}
+
+	return LowerBound;
+}
+
+void FOpenInputGestureKDTree::FindBestMatch(const FOpenInputGestureTable & Table, const float * HandValues, int32 NumLanesToTest, int32 & InOutBestIndex, float & InOutBestDistSq) const
+{
+	if (Nodes.Num() > 0)
+		SearchNode(Table, 0, HandValues, NumLanesToTest, InOutBestIndex, InOutBestDistSq);
+}
+
+void FOpenInputGestureKDTree::SearchNode(const FOpenInputGestureTable & Table, int32 NodeIndex, const float * HandValues, int32 NumLanesToTest, int32 & InOutBestIndex, float & InOutBestDistSq) const
+{
+	const FNode & Node = Nodes[NodeIndex];
+
+	if (Node.FirstChild == INDEX_NONE)
+	{
+		for (int32 i = Node.Start; i < Node.Start + Node.Count; ++i)
+		{
+			float DistSq;
+			if (TestGestureColumn(Table, Columns[i], HandValues, NumLanesToTest, DistSq))
+				KeepBestMatch(Table.GestureIndices[Columns[i]], DistSq, InOutBestIndex, InOutBestDistSq);
+		}
+
+		return;
+	}
+
+	// Nearer child first so the farther one is more likely to be pruned, equal bounds are kept for the index tie break
+	float ChildBounds[2];
+	ChildBounds[0] = GetNodeLowerBound(Nodes[Node.FirstChild], HandValues, NumLanesToTest);
+	ChildBounds[1] = GetNodeLowerBound(Nodes[Node.FirstChild + 1], HandValues, NumLanesToTest);
+
+	const int32 First = (ChildBounds[1] >= 0.f && (ChildBounds[0] < 0.f || ChildBounds[1] < ChildBounds[0])) ? 1 : 0;
+
+	for (int32 i = 0; i < 2; ++i)
+	{
+		const int32 Child = i == 0 ? First : 1 - First;
+
+		if (ChildBounds[Child] >= 0.f && ChildBounds[Child] <= InOutBestDistSq)
+			SearchNode(Table, Node.FirstChild + Child, HandValues, NumLanesToTest, InOutBestIndex, InOutBestDistSq);
+	}
+}
+
+// Five curls then the splays, returns how many splays the pose has
+static int32 FillHandValues(const FBPOpenVRGesturePoseData & PoseData, float * HandValues)
+{
+	FMemory::Memcpy(HandValues, PoseData.PoseFingerCurls.GetData(), vr::VRFinger_Count * sizeof(float));
+
+	const int32 NumSplays = FMath::Min(PoseData.PoseFingerSplays.Num(), (int32)vr::VRFingerSplay_Count);
+	for (int32 i = 0; i < FOpenInputGestureTable::NumLanes - vr::VRFinger_Count; ++i)
+	{
+		HandValues[vr::VRFinger_Count + i] = i < NumSplays ? PoseData.PoseFingerSplays[i] : 0.f;
+	}
+
+	return NumSplays;
+}
+
+void FOpenInputCompiledGestureSet::Compile(const TArray<FOpenInputGesture> & Gestures, bool bBuildSpatialIndex)
+{
+	CurlOnly.Reset();
+	CurlAndSplay.Reset();
+	CurlOnlyTree.Reset();
+	CurlAndSplayTree.Reset();
+	SourceGestureCount = Gestures.Num();
+	Names.Reset(Gestures.Num());
+	HoldSettings.Reset(Gestures.Num());
+	ContextNames.Reset();
+	ContextMasks.Reset(Gestures.Num());
+	DisabledContextBits = 0;
+
+	for (int32 GestureIndex = 0; GestureIndex < Gestures.Num(); ++GestureIndex)
+	{
+		const FOpenInputGesture & Gesture = Gestures[GestureIndex];
+		Names.Add(Gesture.Name);
+
+		uint64 & ContextMask = ContextMasks.Add_GetRef(0);
+		for (const FName & Context : Gesture.Contexts)
+		{
+			if (Context == NAME_None)
+				continue;
+
+			int32 ContextIndex = ContextNames.Find(Context);
+			if (ContextIndex == INDEX_NONE)
+			{
+				if (ContextNames.Num() >= MaxContexts)
+				{
+					UE_LOG(OpenInputFunctionLibraryLog, Warning, TEXT("Gesture %s: more than %d gesture contexts in one database, %s is ignored"), *Gesture.Name.ToString(), MaxContexts, *Context.ToString());
+					continue;
+				}
+
+				ContextIndex = ContextNames.Add(Context);
+			}
+
+			ContextMask |= 1ull << ContextIndex;
+		}
+
+		FOpenInputGestureHoldSettings & Hold = HoldSettings.AddDefaulted_GetRef();
+		Hold.ExitThresholdScale = FMath::Max(Gesture.ExitThresholdScale, 1.f);
+		Hold.MinHoldTime = FMath::Max(Gesture.MinHoldTime, 0.f);
+		Hold.Cooldown = FMath::Max(Gesture.Cooldown, 0.f);
+
+		// Can never match a hand reporting all five curls
+		if (Gesture.FingerValues.Num() < vr::VRFinger_Count)
+			continue;
+
+		(Gesture.bUseFingerCurlOnly ? CurlOnly : CurlAndSplay).GestureIndices.Add(GestureIndex);
+	}
+
+	FillGestureTable(CurlOnly, Gestures, false);
+	FillGestureTable(CurlAndSplay, Gestures, true);
+
+	bHasSpatialIndex = bBuildSpatialIndex;
+	if (bHasSpatialIndex)
+	{
+		CurlOnlyTree.Build(CurlOnly);
+		CurlAndSplayTree.Build(CurlAndSplay);
+	}
+}
+
+// Copies over the columns of Source whose gestures Filter still has active, in their original order
+static void FilterGestureTable(FOpenInputGestureTable & Table, const FOpenInputGestureTable & Source, const FOpenInputCompiledGestureSet & Filter)
+{
+	const int32 NumLanes = FOpenInputGestureTable::NumLanes;
+
+	Table.Reset();
+
+	TArray<int32, TInlineAllocator<64>> SourceColumns;
+	for (int32 Column = 0; Column < Source.NumGestures; ++Column)
+	{
+		if (Filter.IsGestureActive(Source.GestureIndices[Column]))
+		{
+			SourceColumns.Add(Column);
+			Table.GestureIndices.Add(Source.GestureIndices[Column]);
+		}
+	}
+
+	Table.NumGestures = Table.GestureIndices.Num();
+	Table.NumPadded = Align(Table.NumGestures, 4);
+	Table.Values.Init(0.f, NumLanes * Table.NumPadded);
+	Table.Thresholds.Init(-1.f, NumLanes * Table.NumPadded);
+
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		for (int32 Column = 0; Column < Table.NumGestures; ++Column)
+		{
+			const int32 SourceOffset = Lane * Source.NumPadded + SourceColumns[Column];
+			Table.Values[Lane * Table.NumPadded + Column] = Source.Values[SourceOffset];
+			Table.Thresholds[Lane * Table.NumPadded + Column] = Source.Thresholds[SourceOffset];
+		}
+	}
+}
+
+void FOpenInputCompiledGestureSet::CompileFiltered(const FOpenInputCompiledGestureSet & Source, uint64 InDisabledContextBits)
+{
+	SourceGestureCount = Source.SourceGestureCount;
+	Names = Source.Names;
+	HoldSettings = Source.HoldSettings;
+	ContextNames = Source.ContextNames;
+	ContextMasks = Source.ContextMasks;
+	DisabledContextBits = InDisabledContextBits;
+
+	FilterGestureTable(CurlOnly, Source.CurlOnly, *this);
+	FilterGestureTable(CurlAndSplay, Source.CurlAndSplay, *this);
+
+	CurlOnlyTree.Reset();
+	CurlAndSplayTree.Reset();
+
+	bHasSpatialIndex = Source.bHasSpatialIndex;
+	if (bHasSpatialIndex)
+	{
+		CurlOnlyTree.Build(CurlOnly);
+		CurlAndSplayTree.Build(CurlAndSplay);
+	}
+}
+
+uint64 FOpenInputCompiledGestureSet::GetContextBits(const TArray<FName> & Contexts) const
+{
+	uint64 Bits = 0;
+
+	for (const FName & Context : Contexts)
+	{
+		const int32 ContextIndex = ContextNames.Find(Context);
+		if (ContextIndex != INDEX_NONE)
+			Bits |= 1ull << ContextIndex;
+	}
+
+	return Bits;
+}
+
+// Names of the contexts a gesture belongs to, for rebuilding source gestures
+static void ExpandGestureContexts(const FOpenInputCompiledGestureSet & Set, int32 GestureIndex, TArray<FName> & OutContexts)
+{
+	OutContexts.Reset();
+
+	if (!Set.ContextMasks.IsValidIndex(GestureIndex))
+		return;
+
+	const uint64 Mask = Set.ContextMasks[GestureIndex];
+	for (int32 ContextIndex = 0; ContextIndex < Set.ContextNames.Num(); ++ContextIndex)
+	{
+		if (Mask & (1ull << ContextIndex))
+			OutContexts.Add(Set.ContextNames[ContextIndex]);
+	}
+}
+
+static void ExpandGestureColumn(const FOpenInputGestureTable & Table, int32 Column, bool bCurlOnly, FOpenInputGesture & OutGesture)
+{
+	OutGesture.bUseFingerCurlOnly = bCurlOnly;
+	OutGesture.FingerValues.Reset();
+	OutGesture.InitPoseValues();
+
+	for (int32 Lane = 0; Lane < OutGesture.FingerValues.Num(); ++Lane)
+	{
+		const int32 Offset = Lane * Table.NumPadded + Column;
+
+		if (Table.Thresholds[Offset] != OpenInputUncheckedThreshold)
+		{
+			OutGesture.FingerValues[Lane].Value = Table.Values[Offset];
+			OutGesture.FingerValues[Lane].Threshold = Table.Thresholds[Offset];
+		}
+	}
+}
+
+bool FOpenInputCompiledGestureSet::IsPoseWithinGesture(int32 GestureIndex, const FBPOpenVRGesturePoseData & PoseData, float ThresholdScale) const
+{
+	if (PoseData.PoseFingerCurls.Num() != vr::VRFinger_Count)
+		return false;
+
+	float HandValues[FOpenInputGestureTable::NumLanes];
+	const int32 NumSplays = FillHandValues(PoseData, HandValues);
+
+	const FOpenInputGestureTable * Table = &CurlOnly;
+	int32 Column = CurlOnly.GestureIndices.Find(GestureIndex);
+	int32 NumLanesToTest = vr::VRFinger_Count;
+
+	if (Column == INDEX_NONE)
+	{
+		Table = &CurlAndSplay;
+		Column = CurlAndSplay.GestureIndices.Find(GestureIndex);
+		NumLanesToTest += NumSplays;
+
+		if (Column == INDEX_NONE)
+			return false;
+	}
+
+	for (int32 Lane = 0; Lane < NumLanesToTest; ++Lane)
+	{
+		const int32 Offset = Lane * Table->NumPadded + Column;
+		const float Threshold = Table->Thresholds[Offset];
+
+		if (Threshold != OpenInputUncheckedThreshold && FMath::Abs(Table->Values[Offset] - HandValues[Lane]) > Threshold * ThresholdScale)
+			return false;
+	}
+
+	return true;
+}
+
+bool FOpenInputCompiledGestureSet::ExpandGesture(int32 GestureIndex, FOpenInputGesture & OutGesture) const
+{
+	if (!Names.IsValidIndex(GestureIndex))
+		return false;
+
+	OutGesture = FOpenInputGesture();
+	OutGesture.Name = Names[GestureIndex];
+
+	if (HoldSettings.IsValidIndex(GestureIndex))
+	{
+		OutGesture.ExitThresholdScale = HoldSettings[GestureIndex].ExitThresholdScale;
+		OutGesture.MinHoldTime = HoldSettings[GestureIndex].MinHoldTime;
+		OutGesture.Cooldown = HoldSettings[GestureIndex].Cooldown;
+	}
+
+	ExpandGestureContexts(*this, GestureIndex, OutGesture.Contexts);
+
+	// Columns are in source order, so this is only ever a short scan on small sets
+	const int32 CurlOnlyColumn = CurlOnly.GestureIndices.Find(GestureIndex);
+	if (CurlOnlyColumn != INDEX_NONE)
+	{
+		ExpandGestureColumn(CurlOnly, CurlOnlyColumn, true, OutGesture);
+		return true;
+	}
+
+	const int32 SplayColumn = CurlAndSplay.GestureIndices.Find(GestureIndex);
+	if (SplayColumn != INDEX_NONE)
+	{
+		ExpandGestureColumn(CurlAndSplay, SplayColumn, false, OutGesture);
+	}
+
+	return true;
+}
+
+void FOpenInputCompiledGestureSet::ExpandGestures(TArray<FOpenInputGesture> & OutGestures) const
+{
+	OutGestures.Reset(Names.Num());
+	OutGestures.AddDefaulted(Names.Num());
+
+	for (int32 i = 0; i < Names.Num(); ++i)
+	{
+		OutGestures[i].Name = Names[i];
+
+		if (HoldSettings.IsValidIndex(i))
+		{
+			OutGestures[i].ExitThresholdScale = HoldSettings[i].ExitThresholdScale;
+			OutGestures[i].MinHoldTime = HoldSettings[i].MinHoldTime;
+			OutGestures[i].Cooldown = HoldSettings[i].Cooldown;
+		}
+
+		ExpandGestureContexts(*this, i, OutGestures[i].Contexts);
+	}
+
+	for (int32 Column = 0; Column < CurlOnly.NumGestures; ++Column)
+		ExpandGestureColumn(CurlOnly, Column, true, OutGestures[CurlOnly.GestureIndices[Column]]);
+
+	for (int32 Column = 0; Column < CurlAndSplay.NumGestures; ++Column)
+		ExpandGestureColumn(CurlAndSplay, Column, false, OutGestures[CurlAndSplay.GestureIndices[Column]]);
+}
+
+void FOpenInputGestureTable::Serialize(FArchive & Ar)
+{
+	Ar << NumGestures;
+	Ar << NumPadded;
+	Ar << Values;
+	Ar << Thresholds;
+	Ar << GestureIndices;
+
+	// A table that doesn't add up would read off the end of its arrays while matching
+	if (Ar.IsLoading() && (NumGestures < 0 || NumPadded != Align(NumGestures, 4) || GestureIndices.Num() != NumGestures ||
+		Values.Num() != NumLanes * NumPadded || Thresholds.Num() != NumLanes * NumPadded))
+	{
+		Ar.SetError();
+		Reset();
+	}
+}
+
+void FOpenInputGestureKDTree::Serialize(FArchive & Ar)
+{
+	int32 NumNodes = Nodes.Num();
+	Ar << NumNodes;
+
+	if (Ar.IsLoading())
+	{
+		if (NumNodes < 0 || NumNodes * (int64)sizeof(FNode) > Ar.TotalSize() - Ar.Tell())
+		{
+			Ar.SetError();
+			Reset();
+			return;
+		}
+
+		Nodes.SetNumUninitialized(NumNodes);
+	}
+
+	// Nodes are plain floats and ints, cooked data is always for a little endian target
+	Ar.Serialize(Nodes.GetData(), NumNodes * sizeof(FNode));
+	Ar << Columns;
+}
+
+void FOpenInputCompiledGestureSet::Serialize(FArchive & Ar)
+{
+	Ar << SourceGestureCount;
+	CurlOnly.Serialize(Ar);
+	CurlAndSplay.Serialize(Ar);
+
+	if (Ar.CustomVer(FOpenInputGestureDatabaseVersion::GUID) >= FOpenInputGestureDatabaseVersion::GestureHoldSettings)
+	{
+		Ar << HoldSettings;
+	}
+	else if (Ar.IsLoading())
+	{
+		HoldSettings.Reset();
+		HoldSettings.AddDefaulted(FMath::Max(SourceGestureCount, 0));
+	}
+
+	if (Ar.CustomVer(FOpenInputGestureDatabaseVersion::GUID) >= FOpenInputGestureDatabaseVersion::GestureContexts)
+	{
+		Ar << ContextMasks;
+	}
+	else if (Ar.IsLoading())
+	{
+		ContextMasks.Init(0, FMath::Max(SourceGestureCount, 0));
+	}
+
+	Ar << bHasSpatialIndex;
+	if (bHasSpatialIndex)
+	{
+		CurlOnlyTree.Serialize(Ar);
+		CurlAndSplayTree.Serialize(Ar);
+	}
+	else if (Ar.IsLoading())
+	{
+		CurlOnlyTree.Reset();
+		CurlAndSplayTree.Reset();
+	}
+}
+
+int32 FOpenInputCompiledGestureSet::FindFirstMatch(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel) const
+{
+	if (PoseData.PoseFingerCurls.Num() != vr::VRFinger_Count || SourceGestureCount != Gestures.Num())
+		return FindFirstMatchScalar(Gestures, PoseData, TrackingLevel, this);
+
+	return FindFirstMatchCompiled(PoseData, TrackingLevel);
+}
+
+int32 FOpenInputCompiledGestureSet::FindBestMatch(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, float & OutDistance) const
+{
+	OutDistance = 0.f;
+
+	// Non standard hands only get first match, there is nothing to compare a distance against
+	if (PoseData.PoseFingerCurls.Num() != vr::VRFinger_Count || SourceGestureCount != Gestures.Num())
+		return FindFirstMatchScalar(Gestures, PoseData, TrackingLevel, this);
+
+	return FindBestMatchCompiled(PoseData, TrackingLevel, bHasSpatialIndex, OutDistance);
+}
+
+int32 FOpenInputCompiledGestureSet::FindBestMatchLinear(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, float & OutDistance) const
+{
+	OutDistance = 0.f;
+
+	if (PoseData.PoseFingerCurls.Num() != vr::VRFinger_Count || SourceGestureCount != Gestures.Num())
+		return FindFirstMatchScalar(Gestures, PoseData, TrackingLevel, this);
+
+	return FindBestMatchCompiled(PoseData, TrackingLevel, false, OutDistance);
+}
+
+int32 FOpenInputCompiledGestureSet::FindFirstMatchCompiled(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel) const
+{
+	float HandValues[FOpenInputGestureTable::NumLanes];
+	const int32 NumSplays = FillHandValues(PoseData, HandValues);
+
+	int32 BestIndex = INDEX_NONE;
+
+	const int32 CurlOnlyColumn = CurlOnly.FindFirstMatch(HandValues, vr::VRFinger_Count);
+	if (CurlOnlyColumn != INDEX_NONE)
+		BestIndex = CurlOnly.GestureIndices[CurlOnlyColumn];
+
+	// Splay gestures are skipped on fully tracked hands
+	if (TrackingLevel != EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full)
+	{
+		const int32 SplayColumn = CurlAndSplay.FindFirstMatch(HandValues, vr::VRFinger_Count + NumSplays);
+		if (SplayColumn != INDEX_NONE && (BestIndex == INDEX_NONE || CurlAndSplay.GestureIndices[SplayColumn] < BestIndex))
+			BestIndex = CurlAndSplay.GestureIndices[SplayColumn];
+	}
+
+	return BestIndex;
+}
+
+int32 FOpenInputCompiledGestureSet::FindBestMatchCompiled(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, bool bUseSpatialIndex, float & OutDistance) const
+{
+	OutDistance = 0.f;
+
+	float HandValues[FOpenInputGestureTable::NumLanes];
+	const int32 NumSplays = FillHandValues(PoseData, HandValues);
+
+	int32 BestIndex = INDEX_NONE;
+	float BestDistSq = MAX_flt;
+	const bool bTestSplays = TrackingLevel != EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full;
+
+	if (bUseSpatialIndex && bHasSpatialIndex)
+	{
+		CurlOnlyTree.FindBestMatch(CurlOnly, HandValues, vr::VRFinger_Count, BestIndex, BestDistSq);
+
+		if (bTestSplays)
+			CurlAndSplayTree.FindBestMatch(CurlAndSplay, HandValues, vr::VRFinger_Count + NumSplays, BestIndex, BestDistSq);
+	}
+	else
+	{
+		float DistSq;
+
+		for (int32 Column = 0; Column < CurlOnly.NumGestures; ++Column)
+		{
+			if (TestGestureColumn(CurlOnly, Column, HandValues, vr::VRFinger_Count, DistSq))
+				KeepBestMatch(CurlOnly.GestureIndices[Column], DistSq, BestIndex, BestDistSq);
+		}
+
+		if (bTestSplays)
+		{
+			for (int32 Column = 0; Column < CurlAndSplay.NumGestures; ++Column)
+			{
+				if (TestGestureColumn(CurlAndSplay, Column, HandValues, vr::VRFinger_Count + NumSplays, DistSq))
+					KeepBestMatch(CurlAndSplay.GestureIndices[Column], DistSq, BestIndex, BestDistSq);
+			}
+		}
+	}
+
+	if (BestIndex != INDEX_NONE)
+		OutDistance = FMath::Sqrt(BestDistSq);
+
+	return BestIndex;
+}
+
+int32 FOpenInputCompiledGestureSet::FindFirstMatchScalar(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, const FOpenInputCompiledGestureSet * ActiveFilter)
+{
+	for (int32 GestureIndex = 0; GestureIndex < Gestures.Num(); ++GestureIndex)
+	{
+		const FOpenInputGesture & Gesture = Gestures[GestureIndex];
+
+		if (ActiveFilter && !ActiveFilter->IsGestureActive(GestureIndex))
+			continue;
+
+		// If not enough indexs to match curl values, or if this gesture requires finger splay and the controller can't do it
+		if (Gesture.FingerValues.Num() < PoseData.PoseFingerCurls.Num() ||
+			(!Gesture.bUseFingerCurlOnly && TrackingLevel == EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full)
+			)
+			continue;
+
+		bool bDetectedPose = true;
+		for (int i = 0; i < PoseData.PoseFingerCurls.Num(); ++i)
+		{
+			if (!FMath::IsNearlyEqual(PoseData.PoseFingerCurls[i], Gesture.FingerValues[i].Value, Gesture.FingerValues[i].Threshold))
+			{
+				bDetectedPose = false;
+				break;
+			}
+		}
+
+		if (bDetectedPose && !Gesture.bUseFingerCurlOnly && PoseData.PoseFingerSplays.Num())
+		{
+			for (int i = 0; i < PoseData.PoseFingerSplays.Num() && (i + vr::VRFinger_Count) < Gesture.FingerValues.Num(); ++i)
+			{
+				if (!FMath::IsNearlyEqual(PoseData.PoseFingerSplays[i], Gesture.FingerValues[i + vr::VRFinger_Count].Value, Gesture.FingerValues[i + vr::VRFinger_Count].Threshold))
+				{
+					bDetectedPose = false;
+					break;
+				}
+			}
+		}
+
+		if (bDetectedPose)
+			return GestureIndex;
+	}
+
+	return INDEX_NONE;
+}
+
+// Random database where roughly one in four gestures records splays, queries are perturbed copies of database entries
+static void GenerateBenchmarkGestures(FRandomStream & Stream, int32 NumGestures, TArray<FOpenInputGesture> & OutGestures)
+{
+	OutGestures.Reset(NumGestures);
+
+	for (int32 i = 0; i < NumGestures; ++i)
+	{
+		FOpenInputGesture Gesture(Stream.FRand() < 0.75f);
+
+		for (FOpenInputGestureFingerPosition & FingerValue : Gesture.FingerValues)
+		{
+			FingerValue.Value = Stream.FRand();
+			FingerValue.Threshold = Stream.FRandRange(0.05f, 0.15f);
+		}
+
+		OutGestures.Add(Gesture);
+	}
+}
+
+static FAutoConsoleCommand CVarOpenInputBenchmarkGestureIndex(
+	TEXT("vr.OpenInput.BenchmarkGestureIndex"),
+	TEXT("Times first match, linear closest match and the spatial index over random databases of 10 - 10k gestures, OpenInput.Gestures.CompiledMatchesLinear checks they agree. Optional arg: queries per size"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumQueries = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+		const int32 DatabaseSizes[] = { 10, 100, 1000, 10000 };
+
+		FRandomStream Stream(0x4f49);
+		TArray<FOpenInputGesture> Gestures;
+		TArray<FBPOpenVRGesturePoseData> Queries;
+
+		for (int32 NumGestures : DatabaseSizes)
+		{
+			GenerateBenchmarkGestures(Stream, NumGestures, Gestures);
+
+			FOpenInputCompiledGestureSet Compiled;
+			double StartTime = FPlatformTime::Seconds();
+			Compiled.Compile(Gestures, true);
+			const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+			Queries.Reset(NumQueries);
+			for (int32 i = 0; i < NumQueries; ++i)
+			{
+				const FOpenInputGesture & Source = Gestures[Stream.RandHelper(NumGestures)];
+				FBPOpenVRGesturePoseData & Query = Queries.AddDefaulted_GetRef();
+
+				for (int32 Finger = 0; Finger < vr::VRFinger_Count; ++Finger)
+					Query.PoseFingerCurls.Add(FMath::Clamp(Source.FingerValues[Finger].Value + Stream.FRandRange(-0.1f, 0.1f), 0.f, 1.f));
+
+				for (int32 Splay = 0; Splay < vr::VRFingerSplay_Count; ++Splay)
+					Query.PoseFingerSplays.Add(Stream.FRand());
+			}
+
+			const EVROpenInputSkeletalTrackingLevel TrackingLevel = EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Partial;
+			int32 FirstMatches = 0;
+			int32 LinearMatches = 0;
+			int32 IndexMatches = 0;
+			float Distance;
+
+			StartTime = FPlatformTime::Seconds();
+			for (const FBPOpenVRGesturePoseData & Query : Queries)
+				FirstMatches += Compiled.FindFirstMatch(Gestures, Query, TrackingLevel) != INDEX_NONE;
+			const double FirstMatchTime = FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			for (const FBPOpenVRGesturePoseData & Query : Queries)
+				LinearMatches += Compiled.FindBestMatchLinear(Gestures, Query, TrackingLevel, Distance) != INDEX_NONE;
+			const double LinearTime = FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			for (const FBPOpenVRGesturePoseData & Query : Queries)
+				IndexMatches += Compiled.FindBestMatch(Gestures, Query, TrackingLevel, Distance) != INDEX_NONE;
+			const double IndexTime = FPlatformTime::Seconds() - StartTime;
+
+			UE_LOG(OpenInputFunctionLibraryLog, Display, TEXT("Gestures %5d: build %.3fms, first match %.3fus, linear closest %.3fus, indexed closest %.3fus (%.2fx), %d/%d/%d of %d matched"),
+				NumGestures, BuildTime * 1000.0, FirstMatchTime * 1000000.0 / NumQueries, LinearTime * 1000000.0 / NumQueries, IndexTime * 1000000.0 / NumQueries,
+				IndexTime > 0.0 ? LinearTime / IndexTime : 0.0, FirstMatches, LinearMatches, IndexMatches, NumQueries);
+		}
+	}));
+
+void FOpenInputCompiledDynamicGestures::Compile(const TArray<FOpenInputDynamicGesture> & Gestures)
+{
+	const int32 NumLanes = FOpenInputGestureTable::NumLanes;
+
+	Templates.Reset();
+	Values.Reset();
+	StateSize = 0;
+	SourceGestureCount = Gestures.Num();
+
+	// Zero is what a new recognizer starts out with
+	if (++OpenInputDynamicGestureSerial == 0)
+		++OpenInputDynamicGestureSerial;
+
+	Serial = OpenInputDynamicGestureSerial;
+
+	for (int32 GestureIndex = 0; GestureIndex < Gestures.Num(); ++GestureIndex)
+	{
+		const FOpenInputDynamicGesture & Gesture = Gestures[GestureIndex];
+
+		// A single sample is just a static gesture
+		if (Gesture.Samples.Num() < 2)
+			continue;
+
+		FOpenInputDynamicGestureTemplate & Template = Templates.AddDefaulted_GetRef();
+		Template.GestureIndex = GestureIndex;
+		Template.NumSamples = Gesture.Samples.Num();
+		Template.bUseFingerCurlOnly = Gesture.bUseFingerCurlOnly;
+		Template.MaxCost = Gesture.MatchThreshold * Template.NumSamples;
+		Template.ValueOffset = Values.Num();
+		Template.StateOffset = StateSize;
+
+		StateSize += Template.NumSamples + 1;
+
+		for (const FBPOpenVRGesturePoseData & Sample : Gesture.Samples)
+		{
+			float * SampleValues = &Values[Values.AddZeroed(NumLanes)];
+
+			for (int32 i = 0; i < vr::VRFinger_Count && i < Sample.PoseFingerCurls.Num(); ++i)
+				SampleValues[i] = Sample.PoseFingerCurls[i];
+
+			for (int32 i = 0; i < vr::VRFingerSplay_Count && i < Sample.PoseFingerSplays.Num(); ++i)
+				SampleValues[vr::VRFinger_Count + i] = Sample.PoseFingerSplays[i];
+		}
+	}
+}
+
+void FOpenInputDynamicGestureRecognizer::Reset(const FOpenInputCompiledDynamicGestures & Compiled)
+{
+	Costs.Init(MAX_flt, Compiled.StateSize);
+	Starts.Init(0, Compiled.StateSize);
+
+	PendingCost.Init(MAX_flt, Compiled.Templates.Num());
+	PendingStart.Init(0, Compiled.Templates.Num());
+	PendingEnd.Init(0, Compiled.Templates.Num());
+
+	FrameNumber = 0;
+	CompiledSerial = Compiled.Serial;
+}
+
+void FOpenInputDynamicGestureRecognizer::AddFrame(const FOpenInputCompiledDynamicGestures & Compiled, const FBPOpenVRGesturePoseData & PoseData, TArray<int32> & OutRecognized)
+{
+	if (CompiledSerial != Compiled.Serial || Costs.Num() != Compiled.StateSize)
+		Reset(Compiled);
+
+	const int32 NumLanes = FOpenInputGestureTable::NumLanes;
+
+	float HandValues[FOpenInputGestureTable::NumLanes];
+	FMemory::Memzero(HandValues);
+
+	for (int32 i = 0; i < vr::VRFinger_Count && i < PoseData.PoseFingerCurls.Num(); ++i)
+		HandValues[i] = PoseData.PoseFingerCurls[i];
+
+	const int32 NumSplays = FMath::Min(PoseData.PoseFingerSplays.Num(), (int32)vr::VRFingerSplay_Count);
+	for (int32 i = 0; i < NumSplays; ++i)
+		HandValues[vr::VRFinger_Count + i] = PoseData.PoseFingerSplays[i];
+
+	const int32 Frame = ++FrameNumber;
+
+	for (int32 TemplateIndex = 0; TemplateIndex < Compiled.Templates.Num(); ++TemplateIndex)
+	{
+		const FOpenInputDynamicGestureTemplate & Template = Compiled.Templates[TemplateIndex];
+		const int32 NumLanesToTest = Template.bUseFingerCurlOnly ? (int32)vr::VRFinger_Count : vr::VRFinger_Count + NumSplays;
+
+		float * Cost = &Costs[Template.StateOffset];
+		int32 * Start = &Starts[Template.StateOffset];
+
+		// Cell 0 is free to enter on any frame, that is what lets a match start anywhere in the stream
+		float PrevOldCost = 0.f;
+		int32 PrevOldStart = Frame;
+		Cost[0] = 0.f;
+		Start[0] = Frame;
+
+		for (int32 i = 1; i <= Template.NumSamples; ++i)
+		{
+			const float * SampleValues = &Compiled.Values[Template.ValueOffset + (i - 1) * NumLanes];
+
+			float DistSq = 0.f;
+			for (int32 Lane = 0; Lane < NumLanesToTest; ++Lane)
+				DistSq += FMath::Square(HandValues[Lane] - SampleValues[Lane]);
+
+			const float OldCost = Cost[i];
+			const int32 OldStart = Start[i];
+
+			// Best of stretching the template, stretching the stream, or stepping both
+			float BestCost = Cost[i - 1];
+			int32 BestStart = Start[i - 1];
+
+			if (OldCost < BestCost)
+			{
+				BestCost = OldCost;
+				BestStart = OldStart;
+			}
+
+			if (PrevOldCost < BestCost)
+			{
+				BestCost = PrevOldCost;
+				BestStart = PrevOldStart;
+			}
+
+			Cost[i] = BestCost == MAX_flt ? MAX_flt : BestCost + FMath::Sqrt(DistSq);
+			Start[i] = BestStart;
+
+			PrevOldCost = OldCost;
+			PrevOldStart = OldStart;
+		}
+
+		// Report the pending match once no path still in progress could beat it or overlaps it
+		if (PendingCost[TemplateIndex] <= Template.MaxCost)
+		{
+			bool bCanImprove = false;
+			for (int32 i = 1; i <= Template.NumSamples && !bCanImprove; ++i)
+			{
+				bCanImprove = Cost[i] < PendingCost[TemplateIndex] && Start[i] <= PendingEnd[TemplateIndex];
+			}
+
+			if (!bCanImprove)
+			{
+				OutRecognized.Add(Template.GestureIndex);
+
+				// Paths overlapping the reported match can't be reported again
+				for (int32 i = 1; i <= Template.NumSamples; ++i)
+				{
+					if (Start[i] <= PendingEnd[TemplateIndex])
+						Cost[i] = MAX_flt;
+				}
+
+				PendingCost[TemplateIndex] = MAX_flt;
+			}
+		}
+
+		const float EndCost = Cost[Template.NumSamples];
+		if (EndCost <= Template.MaxCost && EndCost < PendingCost[TemplateIndex])
+		{
+			PendingCost[TemplateIndex] = EndCost;
+			PendingStart[TemplateIndex] = Start[Template.NumSamples];
+			PendingEnd[TemplateIndex] = Frame;
+		}
+	}
+}
+
+void FOpenInputGestureJob::Run()
+{
+	Results.SetNum(Hands.Num());
+
+	for (int32 i = 0; i < Hands.Num(); ++i)
+	{
+		const FHandInput & Hand = Hands[i];
+		FHandResult & Result = Results[i];
+
+		Result.StaticMatch = INDEX_NONE;
+		Result.DynamicMatches.Reset();
+
+		if (Hand.bDetectStatic && CompiledGestures.IsValid())
+		{
+			float Distance = 0.f;
+			Result.StaticMatch = bUseClosestMatch ?
+				CompiledGestures->FindBestMatchCompiled(Hand.PoseData, Hand.TrackingLevel, true, Distance) :
+				CompiledGestures->FindFirstMatchCompiled(Hand.PoseData, Hand.TrackingLevel);
+		}
+
+		if (Hand.bFeedDynamic && CompiledDynamicGestures.IsValid() && Recognizers.IsValidIndex(Hand.ActionIndex))
+		{
+			Recognizers[Hand.ActionIndex].AddFrame(*CompiledDynamicGestures, Hand.PoseData, Result.DynamicMatches);
+		}
+	}
+}
@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputHandLOD.h"
+#include "OpenInputSkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/CoreNet.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hand LOD Pass"), STAT_OpenInputHandLOD, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hand LOD Full"), STAT_OpenInputHandLODFull, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hand LOD Curl And Splay"), STAT_OpenInputHandLODCurlAndSplay, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hand LOD Curl Only"), STAT_OpenInputHandLODCurlOnly, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hand LOD Culled"), STAT_OpenInputHandLODCulled, STATGROUP_OpenInput);
+
+static TAutoConsoleVariable<float> CVarOpenInputHandLODInterval(
+	TEXT("vr.OpenInput.HandLODInterval"),
+	0.25f,
+	TEXT("Seconds between passes choosing which hand replication tier each connection gets"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarOpenInputHandBytesPerConnection(
+	TEXT("vr.OpenInput.HandBytesPerConnection"),
+	0,
+	TEXT("Bytes per second of hand data each connection may be sent, nearest hands first, 0 for no limit"),
+	ECVF_Default);
+
+bool UOpenInputHandLODSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Net mode isn't known this early, components only register once they find they are on a server
+	const UWorld * World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UOpenInputHandLODSubsystem::Deinitialize()
+{
+	Components.Reset();
+	Sources.Reset();
+	Candidates.Reset();
+	Super::Deinitialize();
+}
+
+void UOpenInputHandLODSubsystem::RegisterComponent(UOpenInputSkeletalMeshComponent * Component)
+{
+	if (Component)
+		Components.AddUnique(Component);
+}
+
+void UOpenInputHandLODSubsystem::UnregisterComponent(UOpenInputSkeletalMeshComponent * Component)
+{
+	Components.Remove(Component);
+}
+
+EOpenInputHandRepTier FOpenInputHandRepTiers::GetTier(const UNetConnection * Connection) const
+{
+	const EOpenInputHandRepTier * Tier = Connection ? ConnectionTiers.Find(TWeakObjectPtr<const UNetConnection>(Connection)) : nullptr;
+	return Tier ? *Tier : EOpenInputHandRepTier::Tier_Full;
+}
+
+bool UOpenInputHandLODSubsystem::IsTickable() const
+{
+	return Components.Num() > 0;
+}
+
+TStatId UOpenInputHandLODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOpenInputHandLODSubsystem, STATGROUP_Tickables);
+}
+
+float UOpenInputHandLODSubsystem::EstimateBytesPerSecond(UOpenInputSkeletalMeshComponent & Component, EOpenInputHandRepTier Tier)
+{
+	if (Tier == EOpenInputHandRepTier::Tier_None)
+		return 0.f;
+
+	const float Rate = FMath::Max(Component.ReplicationRateForSkeletalAnimations, 0.f);
+	const float LowRate = FMath::Max(Component.HandLODSettings.LowRate, 0.f);
+	const bool bCurlHand = Component.ReplicationType == EVRSkeletalReplicationType::Rep_CurlOnly || Component.ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay;
+
+	if (bCurlHand && Tier == EOpenInputHandRepTier::Tier_CurlOnly)
+	{
+		// Header plus 16 bits a curl
+		return 2.f * (2.f + 2.f * vr::VRFinger_Count) * LowRate;
+	}
+
+	// The full format, delta compressed sends come in under it
+	float Bytes = 0.f;
+	for (FBPSkeletalRepContainer * HandRep : { &Component.LeftHandRep, &Component.RightHandRep })
+	{
+		FNetBitWriter Packet(nullptr, 0);
+		bool bSuccess = true;
+		HandRep->NetSerialize(Packet, nullptr, bSuccess);
+		Bytes += Packet.GetNumBytes();
+	}
+
+	// Curl hands keep the full rate at Tier_CurlAndSplay, transform hands only ever drop to the low rate
+	return Bytes * ((bCurlHand || Tier == EOpenInputHandRepTier::Tier_Full) ? Rate : LowRate);
+}
+
+void UOpenInputHandLODSubsystem::Tick(float DeltaTime)
+{
+	TimeSinceUpdate += DeltaTime;
+
+	if (TimeSinceUpdate < CVarOpenInputHandLODInterval.GetValueOnGameThread())
+		return;
+
+	TimeSinceUpdate = 0.f;
+
+	SCOPE_CYCLE_COUNTER(STAT_OpenInputHandLOD);
+
+	UWorld * World = GetWorld();
+	UNetDriver * NetDriver = World ? World->GetNetDriver() : nullptr;
+
+	if (!NetDriver)
+		return;
+
+	Sources.Reset();
+
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num();)
+	{
+		UOpenInputSkeletalMeshComponent * Component = Components[ComponentIndex].Get();
+
+		if (!Component)
+		{
+			Components.RemoveAtSwap(ComponentIndex);
+			continue;
+		}
+
+		++ComponentIndex;
+
+		if (!Component->bUseHandLOD || !Component->HandRepTiers.IsValid())
+			continue;
+
+		// Connections that have left drop out here
+		Component->HandRepTiers->ConnectionTiers.Reset();
+		Component->HandRepTiers->LowRateInterval = 1.f / FMath::Max(Component->HandLODSettings.LowRate, 0.01f);
+
+		FHandSource & Source = Sources.AddDefaulted_GetRef();
+		Source.Component = Component;
+		Source.Location = Component->GetComponentLocation();
+
+		for (uint8 Tier = 0; Tier < (uint8)EOpenInputHandRepTier::Tier_None; ++Tier)
+		{
+			Source.TierCost[Tier] = EstimateBytesPerSecond(*Component, (EOpenInputHandRepTier)Tier);
+		}
+	}
+
+	if (Sources.Num() < 1)
+		return;
+
+	const float BytesPerConnection = (float)CVarOpenInputHandBytesPerConnection.GetValueOnGameThread();
+
+	for (UNetConnection * Connection : NetDriver->ClientConnections)
+	{
+		if (!Connection || !Connection->PlayerController)
+			continue;
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Connection->PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		const FVector ViewDirection = ViewRotation.Vector();
+
+		Candidates.Reset();
+
+		for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+		{
+			const FHandSource & Source = Sources[SourceIndex];
+
+			// The owner never gets its own hands back
+			const AActor * Owner = Source.Component->GetOwner();
+			if (Owner && Owner->GetNetConnection() == Connection)
+				continue;
+
+			const FVector ToHand = Source.Location - ViewLocation;
+			const float ViewCos = FMath::Cos(FMath::DegreesToRadians(Source.Component->HandLODSettings.ViewHalfAngle));
+
+			FHandCandidate & Candidate = Candidates.AddDefaulted_GetRef();
+			Candidate.SourceIndex = SourceIndex;
+			Candidate.DistanceSquared = ToHand.SizeSquared();
+			Candidate.bInView = (ToHand.GetSafeNormal() | ViewDirection) >= ViewCos;
+		}
+
+		// Nearest hands get first claim on the budget
+		Candidates.Sort([](const FHandCandidate & A, const FHandCandidate & B)
+		{
+			return A.DistanceSquared < B.DistanceSquared;
+		});
+
+		float RemainingBytes = BytesPerConnection;
+
+		for (const FHandCandidate & Candidate : Candidates)
+		{
+			const FHandSource & Source = Sources[Candidate.SourceIndex];
+			const FBPOpenInputHandLODSettings & Settings = Source.Component->HandLODSettings;
+
+			EOpenInputHandRepTier Tier = Settings.GetTierForDistance(Candidate.DistanceSquared);
+
+			if (!Candidate.bInView && Tier < Settings.OutOfViewTier)
+				Tier = Settings.OutOfViewTier;
+
+			if (BytesPerConnection > 0.f)
+			{
+				while (Tier != EOpenInputHandRepTier::Tier_None && Source.TierCost[(uint8)Tier] > RemainingBytes)
+				{
+					Tier = (EOpenInputHandRepTier)((uint8)Tier + 1);
+				}
+
+				if (Tier != EOpenInputHandRepTier::Tier_None)
+					RemainingBytes -= Source.TierCost[(uint8)Tier];
+			}
+
+			Source.Component->HandRepTiers->ConnectionTiers.Add(Connection, Tier);
+
+			switch (Tier)
+			{
+			case EOpenInputHandRepTier::Tier_Full: INC_DWORD_STAT(STAT_OpenInputHandLODFull); break;
+			case EOpenInputHandRepTier::Tier_CurlAndSplay: INC_DWORD_STAT(STAT_OpenInputHandLODCurlAndSplay); break;
+			case EOpenInputHandRepTier::Tier_CurlOnly: INC_DWORD_STAT(STAT_OpenInputHandLODCurlOnly); break;
+			default: INC_DWORD_STAT(STAT_OpenInputHandLODCulled); break;
+			}
+		}
+	}
+}
@@ -0,0 +1,741 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputFunctionLibrary.h"
+#include "Engine/NetSerialization.h"
+#include "UObject/CoreNet.h"
+#include "Engine/PackageMapClient.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hard Transform Keyframe Bits"), STAT_OpenInputHardKeyframeBits, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hard Transform Delta Bits"), STAT_OpenInputHardDeltaBits, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hard Transform Full Format Bits"), STAT_OpenInputHardFullFormatBits, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hard Transform Deltas Dropped"), STAT_OpenInputHardDeltasDropped, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hand Sends Skipped By Tier"), STAT_OpenInputHandTierSkipped, STATGROUP_OpenInput);
+
+static TAutoConsoleVariable<int32> CVarOpenInputHardTransformKeyframeInterval(
+	TEXT("vr.OpenInput.HardTransformKeyframeInterval"),
+	10,
+	TEXT("Delta compressed Rep_HardTransforms sends a full keyframe to each connection at least once every this many sends.\n")
+	TEXT("A receiver that misses the base of a delta holds its last pose until the next keyframe, so this bounds how long a lost packet freezes a hand"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarOpenInputMeasureHardTransformSavings(
+	TEXT("vr.OpenInput.MeasureHardTransformSavings"),
+	0,
+	TEXT("1 also serializes every delta compressed hard transform send in the full format to feed the Hard Transform Full Format Bits stat.\n")
+	TEXT("Doubles the serialization cost of those sends, only turn it on while comparing"),
+	ECVF_Default);
+
+// The changed bone mask is a single word
+static const int32 OpenInputMaxDeltaBones = 32;
+
+// What one connection was last sent for a container
+class FOpenInputHandRepBaseState : public INetDeltaBaseState
+{
+public:
+
+	// Delta compressed hard transforms keep the pose, anything else only what its packet looked like
+	bool bHasPose;
+	FOpenInputQuantizedHandPose Pose;
+	int32 SendsSinceKeyframe;
+
+	uint32 PacketHash;
+	int64 PacketBits;
+
+	// The containers ContentSerial this was written from, and whether it was cut down to curls for a low tier
+	uint32 ContentSerial;
+	bool bReducedPacket;
+
+	// When this was written, low rate tiers wait on it
+	double SendTime;
+
+	FOpenInputHandRepBaseState()
+	{
+		bHasPose = false;
+		SendsSinceKeyframe = 0;
+		PacketHash = 0;
+		PacketBits = 0;
+		ContentSerial = 0;
+		bReducedPacket = false;
+		SendTime = 0.0;
+	}
+
+	virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+	{
+		const FOpenInputHandRepBaseState * Other = static_cast<const FOpenInputHandRepBaseState*>(OtherState);
+
+		if (bHasPose != Other->bHasPose)
+			return false;
+
+		return bHasPose ? Pose.HasSameValues(Other->Pose) : (PacketHash == Other->PacketHash && PacketBits == Other->PacketBits);
+	}
+};
+
+// Every component but the largest of a unit quaternion is within this of zero
+static const float OpenInputQuatComponentRange = 0.707106781f;
+
+int32 FOpenInputQuatCodec::GetBitsForMaxError(float MaxErrorDegrees)
+{
+	const float MaxErrorRadians = FMath::DegreesToRadians(FMath::Max(MaxErrorDegrees, KINDA_SMALL_NUMBER));
+
+	// Each component is off by at most half a step, together the three turn the rotation by at most about sqrt(3) steps
+	const float Step = MaxErrorRadians / FMath::Sqrt(3.f);
+	const int32 Bits = FMath::CeilToInt(FMath::Log2(2.f * OpenInputQuatComponentRange / Step + 1.f));
+
+	return FMath::Clamp(Bits, MinBits, MaxBits);
+}
+
+void FOpenInputQuatCodec::Quantize(const FQuat & Rotation, int32 Bits, uint16 * OutComponents, uint8 & OutLargest)
+{
+	const FQuat Normalized = Rotation.GetNormalized();
+	const float Values[4] = { Normalized.X, Normalized.Y, Normalized.Z, Normalized.W };
+
+	int32 Largest = 0;
+	for (int32 i = 1; i < 4; ++i)
+	{
+		if (FMath::Abs(Values[i]) > FMath::Abs(Values[Largest]))
+			Largest = i;
+	}
+
+	// q and -q are the same rotation, flipping so the dropped component is positive means its sign never has to be sent
+	const float Sign = Values[Largest] < 0.f ? -1.f : 1.f;
+	const float MaxValue = (float)((1 << Bits) - 1);
+
+	int32 Out = 0;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		if (i == Largest)
+			continue;
+
+		const float Unit = (Values[i] * Sign + OpenInputQuatComponentRange) / (2.f * OpenInputQuatComponentRange);
+		OutComponents[Out++] = (uint16)FMath::RoundToInt(FMath::Clamp(Unit, 0.f, 1.f) * MaxValue);
+	}
+
+	OutLargest = (uint8)Largest;
+}
+
+FQuat FOpenInputQuatCodec::Dequantize(const uint16 * Components, uint8 Largest, int32 Bits)
+{
+	const float MaxValue = (float)((1 << Bits) - 1);
+
+	float Values[4];
+	float SumSquares = 0.f;
+	int32 In = 0;
+
+	for (int32 i = 0; i < 4; ++i)
+	{
+		if (i == (Largest & 3))
+			continue;
+
+		Values[i] = (Components[In++] / MaxValue) * 2.f * OpenInputQuatComponentRange - OpenInputQuatComponentRange;
+		SumSquares += Values[i] * Values[i];
+	}
+
+	Values[Largest & 3] = FMath::Sqrt(FMath::Max(1.f - SumSquares, 0.f));
+
+	FQuat Rotation(Values[0], Values[1], Values[2], Values[3]);
+	Rotation.Normalize();
+	return Rotation;
+}
+
+void FOpenInputQuatCodec::Serialize(FArchive & Ar, uint16 * Components, uint8 & Largest, int32 Bits)
+{
+	// Read through a zeroed word, bit readers only clear the bytes they write into and a component under 9 bits would keep the old high byte
+	uint32 Value = Largest;
+	Ar.SerializeBits(&Value, 2);
+	Largest = (uint8)Value;
+
+	for (int32 i = 0; i < 3; ++i)
+	{
+		Value = Ar.IsLoading() ? 0 : Components[i];
+		Ar.SerializeBits(&Value, Bits);
+		Components[i] = (uint16)Value;
+	}
+}
+
+EOpenInputHandBoneClass FOpenInputQuatCodec::GetRepBoneClass(int32 RepBoneIndex)
+{
+	// Indices into the layout CopyForReplication packs bones in
+	switch (RepBoneIndex)
+	{
+	case 0: return EOpenInputHandBoneClass::Wrist;
+	case 1:
+	case 4:
+	case 8:
+	case 12:
+	case 16: return EOpenInputHandBoneClass::Metacarpal;
+	default: return EOpenInputHandBoneClass::Phalanx;
+	}
+}
+
+void FBPOpenInputRotationErrorBudget::GetComponentBits(uint8 * OutBits) const
+{
+	OutBits[(uint8)EOpenInputHandBoneClass::Wrist] = (uint8)FOpenInputQuatCodec::GetBitsForMaxError(WristMaxError);
+	OutBits[(uint8)EOpenInputHandBoneClass::Metacarpal] = (uint8)FOpenInputQuatCodec::GetBitsForMaxError(MetacarpalMaxError);
+	OutBits[(uint8)EOpenInputHandBoneClass::Phalanx] = (uint8)FOpenInputQuatCodec::GetBitsForMaxError(PhalanxMaxError);
+}
+
+int32 FBPSkeletalRepContainer::EstimateSerializedBits() const
+{
+	// Hand and replication type
+	int32 Bits = 1 + 3;
+
+	switch (ReplicationType)
+	{
+	case EVRSkeletalReplicationType::Rep_CurlOnly:
+	case EVRSkeletalReplicationType::Rep_CurlAndSplay:
+	{
+		Bits += 1;
+
+		if (PoseFingerData.PoseFingerCurls.Num() > 0)
+		{
+			Bits += 8 + 16 * PoseFingerData.PoseFingerCurls.Num();
+
+			if (ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay)
+				Bits += 8 + 16 * PoseFingerData.PoseFingerSplays.Num();
+		}
+	}break;
+
+	case EVRSkeletalReplicationType::Rep_HardTransforms:
+	case EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms:
+	{
+		Bits += 1 + 8 + 4 * (uint8)EOpenInputHandBoneClass::Count;
+
+		for (int32 i = 0; i < SkeletalTransforms.Num(); ++i)
+		{
+			const int32 ComponentBits = FMath::Clamp<int32>(RotationBits[(uint8)FOpenInputQuatCodec::GetRepBoneClass(i)], FOpenInputQuatCodec::MinBits, FOpenInputQuatCodec::MaxBits);
+			Bits += 2 + 3 * ComponentBits;
+
+			// SerializePackedVector<10, 11>, a bit count then three components of up to 12 bits
+			if (bAllowDeformingMesh)
+				Bits += 5 + 3 * 12;
+		}
+	}break;
+
+	case EVRSkeletalReplicationType::Rep_SteamVRCompressedTransforms:
+	{
+		Bits += 8 + 32 + 8 * CompressedTransforms.Num();
+	}break;
+	default:break;
+	}
+
+	return Bits;
+}
+
+uint32 FBPSkeletalRepContainer::HashReplicatedContent() const
+{
+	uint32 Hash = FCrc::MemCrc32(&TargetHand, sizeof(TargetHand), (uint32)ReplicationType);
+
+	switch (ReplicationType)
+	{
+	case EVRSkeletalReplicationType::Rep_CurlOnly:
+	case EVRSkeletalReplicationType::Rep_CurlAndSplay:
+	{
+		Hash = FCrc::MemCrc32(PoseFingerData.PoseFingerCurls.GetData(), PoseFingerData.PoseFingerCurls.Num() * sizeof(float), Hash);
+
+		if (ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay)
+			Hash = FCrc::MemCrc32(PoseFingerData.PoseFingerSplays.GetData(), PoseFingerData.PoseFingerSplays.Num() * sizeof(float), Hash);
+	}break;
+
+	case EVRSkeletalReplicationType::Rep_HardTransforms:
+	case EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms:
+	{
+		Hash = FCrc::MemCrc32(&bAllowDeformingMesh, sizeof(bAllowDeformingMesh), Hash);
+		Hash = FCrc::MemCrc32(RotationBits, sizeof(RotationBits), Hash);
+		Hash = FCrc::MemCrc32(SkeletalTransforms.GetData(), SkeletalTransforms.Num() * sizeof(FTransform), Hash);
+	}break;
+
+	case EVRSkeletalReplicationType::Rep_SteamVRCompressedTransforms:
+	{
+		Hash = FCrc::MemCrc32(&BoneCount, sizeof(BoneCount), Hash);
+		Hash = FCrc::MemCrc32(CompressedTransforms.GetData(), CompressedTransforms.Num(), Hash);
+	}break;
+	default:break;
+	}
+
+	return Hash;
+}
+
+void FBPSkeletalRepContainer::DeriveUnsentBones(TArray<FTransform> & Transforms)
+{
+	struct FFingerChain
+	{
+		EVROpenInputBones First;
+		EVROpenInputBones Distal;
+		EVROpenInputBones Tip;
+		EVROpenInputBones Aux;
+	};
+
+	static const FFingerChain Fingers[] =
+	{
+		{ EVROpenInputBones::eBone_Thumb0, EVROpenInputBones::eBone_Thumb2, EVROpenInputBones::eBone_Thumb3, EVROpenInputBones::eBone_Aux_Thumb },
+		{ EVROpenInputBones::eBone_IndexFinger0, EVROpenInputBones::eBone_IndexFinger3, EVROpenInputBones::eBone_IndexFinger4, EVROpenInputBones::eBone_Aux_IndexFinger },
+		{ EVROpenInputBones::eBone_MiddleFinger0, EVROpenInputBones::eBone_MiddleFinger3, EVROpenInputBones::eBone_MiddleFinger4, EVROpenInputBones::eBone_Aux_MiddleFinger },
+		{ EVROpenInputBones::eBone_RingFinger0, EVROpenInputBones::eBone_RingFinger3, EVROpenInputBones::eBone_RingFinger4, EVROpenInputBones::eBone_Aux_RingFinger },
+		{ EVROpenInputBones::eBone_PinkyFinger0, EVROpenInputBones::eBone_PinkyFinger3, EVROpenInputBones::eBone_PinkyFinger4, EVROpenInputBones::eBone_Aux_PinkyFinger }
+	};
+
+	if (Transforms.Num() < (uint8)EVROpenInputBones::eBone_Count)
+		return;
+
+	for (const FFingerChain & Finger : Fingers)
+	{
+		// Root is identity, so the wrist is already in component space
+		FTransform ComponentSpace = Transforms[(uint8)EVROpenInputBones::eBone_Wrist];
+
+		for (uint8 Bone = (uint8)Finger.First; Bone <= (uint8)Finger.Distal; ++Bone)
+		{
+			ComponentSpace = Transforms[Bone] * ComponentSpace;
+		}
+
+		// Tips carry no rotation, project them past the distal joint by that joints own length
+		Transforms[(uint8)Finger.Tip] = FTransform(Transforms[(uint8)Finger.Distal].GetTranslation());
+
+		// Aux bones are the distal joint parented straight to the root
+		Transforms[(uint8)Finger.Aux] = ComponentSpace;
+	}
+}
+
+static FORCEINLINE uint32 ZigZagEncode(int32 Value)
+{
+	return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+}
+
+static FORCEINLINE int32 ZigZagDecode(uint32 Value)
+{
+	return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+}
+
+static void QuantizeHandPose(const FBPSkeletalRepContainer & Container, FOpenInputQuantizedHandPose & OutPose)
+{
+	const int32 NumBones = Container.SkeletalTransforms.Num();
+
+	OutPose.bAllowDeformingMesh = Container.bAllowDeformingMesh;
+	OutPose.bOpenInputCompressed = Container.ReplicationType == EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms;
+	OutPose.Rotations.SetNumUninitialized(NumBones * 3);
+	OutPose.LargestComponents.SetNumUninitialized(NumBones);
+	OutPose.Positions.SetNumUninitialized(Container.bAllowDeformingMesh ? NumBones * 3 : 0);
+
+	for (int32 Class = 0; Class < (uint8)EOpenInputHandBoneClass::Count; ++Class)
+	{
+		OutPose.RotationBits[Class] = FMath::Clamp<uint8>(Container.RotationBits[Class], FOpenInputQuatCodec::MinBits, FOpenInputQuatCodec::MaxBits);
+	}
+
+	for (int32 Bone = 0; Bone < NumBones; ++Bone)
+	{
+		const FTransform & Transform = Container.SkeletalTransforms[Bone];
+		const int32 Bits = OutPose.RotationBits[(uint8)FOpenInputQuatCodec::GetRepBoneClass(Bone)];
+
+		FOpenInputQuatCodec::Quantize(Transform.GetRotation(), Bits, &OutPose.Rotations[Bone * 3], OutPose.LargestComponents[Bone]);
+
+		if (Container.bAllowDeformingMesh)
+		{
+			const FVector Position = Transform.GetLocation() * FOpenInputQuantizedHandPose::PositionScale;
+			OutPose.Positions[Bone * 3 + 0] = FMath::RoundToInt(Position.X);
+			OutPose.Positions[Bone * 3 + 1] = FMath::RoundToInt(Position.Y);
+			OutPose.Positions[Bone * 3 + 2] = FMath::RoundToInt(Position.Z);
+		}
+	}
+}
+
+static void ExpandHandPose(const FOpenInputQuantizedHandPose & Pose, TArray<FTransform> & OutTransforms)
+{
+	const int32 NumBones = Pose.GetNumBones();
+	OutTransforms.Reset(NumBones);
+
+	for (int32 Bone = 0; Bone < NumBones; ++Bone)
+	{
+		const int32 Bits = Pose.RotationBits[(uint8)FOpenInputQuatCodec::GetRepBoneClass(Bone)];
+		const FQuat Rot = FOpenInputQuatCodec::Dequantize(&Pose.Rotations[Bone * 3], Pose.LargestComponents[Bone], Bits);
+
+		if (Pose.bAllowDeformingMesh)
+		{
+			const FVector Position((float)Pose.Positions[Bone * 3 + 0], (float)Pose.Positions[Bone * 3 + 1], (float)Pose.Positions[Bone * 3 + 2]);
+			OutTransforms.Add(FTransform(Rot, Position / FOpenInputQuantizedHandPose::PositionScale));
+		}
+		else
+		{
+			OutTransforms.Add(FTransform(Rot));
+		}
+	}
+}
+
+// Frame to frame a quaternion component moves a handful of steps, those fit in 7 bits behind a flag and only large moves pay for all 16.
+// Deltas are taken modulo 2^16, which round trips exactly whatever the component bit count.
+static void SerializeRotationDelta(FArchive & Ar, uint16 & Delta)
+{
+	uint32 ZigZag = ZigZagEncode((int16)Delta);
+	bool bSmall = ZigZag < 128;
+	Ar.SerializeBits(&bSmall, 1);
+
+	if (bSmall)
+	{
+		if (Ar.IsLoading())
+			ZigZag = 0;
+
+		Ar.SerializeBits(&ZigZag, 7);
+
+		if (Ar.IsLoading())
+			Delta = (uint16)(int16)ZigZagDecode(ZigZag);
+	}
+	else
+	{
+		Ar.SerializeBits(&Delta, 16);
+	}
+}
+
+static void SerializePositionDelta(FArchive & Ar, int32 & Delta)
+{
+	uint32 ZigZag = ZigZagEncode(Delta);
+	Ar.SerializeIntPacked(ZigZag);
+
+	if (Ar.IsLoading())
+		Delta = ZigZagDecode(ZigZag);
+}
+
+// Keyframes carry every value, each rotation at its bone classes fixed size
+static void SerializeKeyframe(FArchive & Ar, FOpenInputQuantizedHandPose & Pose)
+{
+	for (int32 Bone = 0; Bone < Pose.GetNumBones(); ++Bone)
+	{
+		const int32 Bits = Pose.RotationBits[(uint8)FOpenInputQuatCodec::GetRepBoneClass(Bone)];
+		FOpenInputQuatCodec::Serialize(Ar, &Pose.Rotations[Bone * 3], Pose.LargestComponents[Bone], Bits);
+	}
+
+	for (int32 i = 0; i < Pose.Positions.Num(); ++i)
+	{
+		SerializePositionDelta(Ar, Pose.Positions[i]);
+	}
+}
+
+// Only the bones that differ from Base, the pose has to already hold Base when reading
+static void SerializeDelta(FArchive & Ar, FOpenInputQuantizedHandPose & Pose, const FOpenInputQuantizedHandPose & Base)
+{
+	const int32 NumBones = Pose.GetNumBones();
+	uint32 ChangedBones = 0;
+
+	if (Ar.IsSaving())
+	{
+		for (int32 Bone = 0; Bone < NumBones; ++Bone)
+		{
+			bool bChanged = Pose.LargestComponents[Bone] != Base.LargestComponents[Bone];
+			bChanged |= FMemory::Memcmp(&Pose.Rotations[Bone * 3], &Base.Rotations[Bone * 3], 3 * sizeof(uint16)) != 0;
+			bChanged |= Pose.bAllowDeformingMesh && FMemory::Memcmp(&Pose.Positions[Bone * 3], &Base.Positions[Bone * 3], 3 * sizeof(int32)) != 0;
+
+			if (bChanged)
+				ChangedBones |= 1u << Bone;
+		}
+	}
+
+	Ar.SerializeBits(&ChangedBones, NumBones);
+
+	for (int32 Bone = 0; Bone < NumBones; ++Bone)
+	{
+		if (!(ChangedBones & (1u << Bone)))
+			continue;
+
+		// Components are only comparable while the same one is dropped, a hand turning across that sends the rotation whole
+		bool bSameLargest = Pose.LargestComponents[Bone] == Base.LargestComponents[Bone];
+		Ar.SerializeBits(&bSameLargest, 1);
+
+		if (bSameLargest)
+		{
+			for (int32 Axis = Bone * 3; Axis < Bone * 3 + 3; ++Axis)
+			{
+				uint16 Delta = (uint16)(Pose.Rotations[Axis] - Base.Rotations[Axis]);
+				SerializeRotationDelta(Ar, Delta);
+
+				if (Ar.IsLoading())
+					Pose.Rotations[Axis] = (uint16)(Base.Rotations[Axis] + Delta);
+			}
+
+			if (Ar.IsLoading())
+				Pose.LargestComponents[Bone] = Base.LargestComponents[Bone];
+		}
+		else
+		{
+			const int32 Bits = Pose.RotationBits[(uint8)FOpenInputQuatCodec::GetRepBoneClass(Bone)];
+			FOpenInputQuatCodec::Serialize(Ar, &Pose.Rotations[Bone * 3], Pose.LargestComponents[Bone], Bits);
+		}
+
+		if (Pose.bAllowDeformingMesh)
+		{
+			for (int32 Axis = Bone * 3; Axis < Bone * 3 + 3; ++Axis)
+			{
+				int32 Delta = Pose.Positions[Axis] - Base.Positions[Axis];
+				SerializePositionDelta(Ar, Delta);
+
+				if (Ar.IsLoading())
+					Pose.Positions[Axis] = Base.Positions[Axis] + Delta;
+			}
+		}
+	}
+}
+
+// Nothing new since this connection was last written to, checked before building a packet just to find that out
+static bool IsPacketUnchanged(const FOpenInputHandRepBaseState * OldState, uint32 ContentSerial, bool bReducedPacket)
+{
+	return OldState && !OldState->bHasPose && OldState->ContentSerial == ContentSerial && OldState->bReducedPacket == bReducedPacket;
+}
+
+// Writes the container as NetSerialize does, unless it is the same packet the connection last got.
+// ContentSerial is the source containers, Container may be a reduced copy of it.
+static bool WritePacketIfChanged(FBPSkeletalRepContainer & Container, uint32 ContentSerial, bool bReducedPacket, FNetDeltaSerializeInfo & DeltaParms, FOpenInputHandRepBaseState * OldState, double SendTime)
+{
+	if (IsPacketUnchanged(OldState, ContentSerial, bReducedPacket))
+		return false;
+
+	// Written aside first, it is only sent if it differs from what this connection last got
+	FNetBitWriter Packet(DeltaParms.Map, 0);
+	bool bSuccess = true;
+	Container.NetSerialize(Packet, DeltaParms.Map, bSuccess);
+
+	TSharedPtr<FOpenInputHandRepBaseState> NewState = MakeShared<FOpenInputHandRepBaseState>();
+	NewState->PacketBits = Packet.GetNumBits();
+	NewState->PacketHash = FCrc::MemCrc32(Packet.GetData(), Packet.GetNumBytes());
+	NewState->ContentSerial = ContentSerial;
+	NewState->bReducedPacket = bReducedPacket;
+	NewState->SendTime = SendTime;
+
+	if (OldState && OldState->IsStateEqual(NewState.Get()))
+		return false;
+
+	bool bSendPose = false;
+	DeltaParms.Writer->SerializeBits(&bSendPose, 1);
+	DeltaParms.Writer->SerializeBits(Packet.GetData(), Packet.GetNumBits());
+
+	*DeltaParms.NewState = NewState;
+	return true;
+}
+
+static const UNetConnection * GetReceivingConnection(const FNetDeltaSerializeInfo & DeltaParms)
+{
+	UPackageMapClient * PackageMap = Cast<UPackageMapClient>(DeltaParms.Map);
+	return PackageMap ? PackageMap->GetConnection() : nullptr;
+}
+
+bool FBPSkeletalRepContainer::NetDeltaSerialize(FNetDeltaSerializeInfo & DeltaParms)
+{
+	// Nothing in here references objects, the guid gathering and remapping passes have nothing to do
+	if (DeltaParms.Writer)
+	{
+		FBitWriter & Writer = *DeltaParms.Writer;
+		FOpenInputHandRepBaseState * OldState = static_cast<FOpenInputHandRepBaseState*>(DeltaParms.OldState);
+		const double SendTime = FPlatformTime::Seconds();
+
+		const EOpenInputHandRepTier Tier = RepTiers.IsValid() ? RepTiers->GetTier(GetReceivingConnection(DeltaParms)) : EOpenInputHandRepTier::Tier_Full;
+
+		if (Tier == EOpenInputHandRepTier::Tier_None)
+		{
+			INC_DWORD_STAT(STAT_OpenInputHandTierSkipped);
+			return false;
+		}
+
+		// Receivers only animate transform hands from bones, those are never cut down to curls, only sent less often
+		const bool bCurlHand = ReplicationType == EVRSkeletalReplicationType::Rep_CurlOnly || ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay;
+		const bool bLowRate = bCurlHand ? Tier == EOpenInputHandRepTier::Tier_CurlOnly : Tier != EOpenInputHandRepTier::Tier_Full;
+
+		if (bLowRate && OldState && SendTime - OldState->SendTime < RepTiers->LowRateInterval)
+		{
+			INC_DWORD_STAT(STAT_OpenInputHandTierSkipped);
+			return false;
+		}
+
+		if (Tier == EOpenInputHandRepTier::Tier_CurlOnly && ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay)
+		{
+			if (IsPacketUnchanged(OldState, ContentSerial, true))
+				return false;
+
+			FBPSkeletalRepContainer Reduced;
+			Reduced.TargetHand = TargetHand;
+			Reduced.ReplicationType = EVRSkeletalReplicationType::Rep_CurlOnly;
+			Reduced.PoseFingerData = PoseFingerData;
+
+			return WritePacketIfChanged(Reduced, ContentSerial, true, DeltaParms, OldState, SendTime);
+		}
+
+		const int32 NumBones = SkeletalTransforms.Num();
+		const bool bTransforms = ReplicationType == EVRSkeletalReplicationType::Rep_HardTransforms || ReplicationType == EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms;
+		bool bSendPose = bDeltaCompress && bTransforms && NumBones > 0 && NumBones <= OpenInputMaxDeltaBones;
+
+		if (!bSendPose)
+		{
+			return WritePacketIfChanged(*this, ContentSerial, false, DeltaParms, OldState, SendTime);
+		}
+
+		const int32 KeyframeInterval = FMath::Max(CVarOpenInputHardTransformKeyframeInterval.GetValueOnGameThread(), 1);
+
+		// The same content this connection already has, skip quantizing it again unless a keyframe is due
+		if (OldState && OldState->bHasPose && OldState->ContentSerial == ContentSerial && OldState->SendsSinceKeyframe + 1 < KeyframeInterval)
+			return false;
+
+		TSharedPtr<FOpenInputHandRepBaseState> NewState = MakeShared<FOpenInputHandRepBaseState>();
+		NewState->SendTime = SendTime;
+		NewState->bHasPose = true;
+		NewState->ContentSerial = ContentSerial;
+		QuantizeHandPose(*this, NewState->Pose);
+
+		const FOpenInputQuantizedHandPose * Base = (OldState && OldState->bHasPose && OldState->Pose.HasSameLayout(NewState->Pose)) ? &OldState->Pose : nullptr;
+		bool bKeyframe = !Base || OldState->SendsSinceKeyframe + 1 >= KeyframeInterval;
+
+		if (Base && !bKeyframe && Base->HasSameValues(NewState->Pose))
+			return false;
+
+		// One sequence per pose of this container, every connection sent the same pose gets the same number
+		if (SequencedSerial != ContentSerial)
+		{
+			SequencedSerial = ContentSerial;
+			++PoseSequence;
+		}
+
+		NewState->Pose.Sequence = PoseSequence;
+		NewState->SendsSinceKeyframe = bKeyframe ? 0 : OldState->SendsSinceKeyframe + 1;
+
+		const int64 StartBits = Writer.GetNumBits();
+
+		uint8 BoneCountToSend = (uint8)NumBones;
+		Writer.SerializeBits(&bSendPose, 1);
+		Writer.SerializeBits(&TargetHand, 1);
+		Writer.SerializeBits(&NewState->Pose.bOpenInputCompressed, 1);
+		Writer.SerializeBits(&bAllowDeformingMesh, 1);
+		Writer << BoneCountToSend;
+
+		for (int32 Class = 0; Class < (uint8)EOpenInputHandBoneClass::Count; ++Class)
+		{
+			uint8 BitsMinusOne = NewState->Pose.RotationBits[Class] - 1;
+			Writer.SerializeBits(&BitsMinusOne, 4);
+		}
+
+		Writer << NewState->Pose.Sequence;
+		Writer.SerializeBits(&bKeyframe, 1);
+
+		if (bKeyframe)
+		{
+			SerializeKeyframe(Writer, NewState->Pose);
+			INC_DWORD_STAT_BY(STAT_OpenInputHardKeyframeBits, Writer.GetNumBits() - StartBits);
+		}
+		else
+		{
+			uint16 BaseSequence = Base->Sequence;
+			Writer << BaseSequence;
+			SerializeDelta(Writer, NewState->Pose, *Base);
+			INC_DWORD_STAT_BY(STAT_OpenInputHardDeltaBits, Writer.GetNumBits() - StartBits);
+		}
+
+#if STATS
+		// What the same update would have cost without delta compression, to compare against
+		if (CVarOpenInputMeasureHardTransformSavings.GetValueOnGameThread() != 0)
+		{
+			FNetBitWriter FullFormat(DeltaParms.Map, 0);
+			bool bSuccess = true;
+			NetSerialize(FullFormat, DeltaParms.Map, bSuccess);
+			INC_DWORD_STAT_BY(STAT_OpenInputHardFullFormatBits, FullFormat.GetNumBits());
+		}
+#endif
+
+		*DeltaParms.NewState = NewState;
+		return true;
+	}
+	else if (DeltaParms.Reader)
+	{
+		FBitReader & Reader = *DeltaParms.Reader;
+		bStaleDelta = false;
+
+		bool bPose = false;
+		Reader.SerializeBits(&bPose, 1);
+
+		if (!bPose)
+		{
+			bool bSuccess = true;
+			NetSerialize(Reader, DeltaParms.Map, bSuccess);
+			return bSuccess && !Reader.IsError();
+		}
+
+		uint8 NumBones = 0;
+		bool bKeyframe = false;
+		FOpenInputQuantizedHandPose Pose;
+
+		Reader.SerializeBits(&TargetHand, 1);
+		Reader.SerializeBits(&Pose.bOpenInputCompressed, 1);
+		Reader.SerializeBits(&Pose.bAllowDeformingMesh, 1);
+		Reader << NumBones;
+
+		for (int32 Class = 0; Class < (uint8)EOpenInputHandBoneClass::Count; ++Class)
+		{
+			uint8 BitsMinusOne = 0;
+			Reader.SerializeBits(&BitsMinusOne, 4);
+			Pose.RotationBits[Class] = FMath::Max<uint8>(BitsMinusOne + 1, FOpenInputQuatCodec::MinBits);
+		}
+
+		Reader << Pose.Sequence;
+		Reader.SerializeBits(&bKeyframe, 1);
+
+		if (NumBones > OpenInputMaxDeltaBones)
+		{
+			Reader.SetError();
+			return false;
+		}
+
+		Pose.Rotations.SetNumZeroed(NumBones * 3);
+		Pose.LargestComponents.SetNumZeroed(NumBones);
+		Pose.Positions.SetNumZeroed(Pose.bAllowDeformingMesh ? NumBones * 3 : 0);
+
+		bool bHaveBase = true;
+
+		if (bKeyframe)
+		{
+			SerializeKeyframe(Reader, Pose);
+		}
+		else
+		{
+			uint16 BaseSequence = 0;
+			Reader << BaseSequence;
+
+			const FOpenInputQuantizedHandPose * Base = ReceivedPoses.FindByPredicate([&](const FOpenInputQuantizedHandPose & Received)
+			{
+				return Received.Sequence == BaseSequence && Received.HasSameLayout(Pose);
+			});
+
+			// Still read through so the rest of the bunch lines up, the pose is dropped until the next keyframe
+			bHaveBase = Base != nullptr;
+			const uint16 Sequence = Pose.Sequence;
+
+			if (bHaveBase)
+			{
+				Pose = *Base;
+				Pose.Sequence = Sequence;
+			}
+
+			SerializeDelta(Reader, Pose, bHaveBase ? *Base : Pose);
+		}
+
+		if (Reader.IsError())
+			return false;
+
+		// Flagged rather than failed, a failed read is treated as a broken bunch and would take the channel down with it
+		if (!bHaveBase)
+		{
+			INC_DWORD_STAT(STAT_OpenInputHardDeltasDropped);
+			bStaleDelta = true;
+			return true;
+		}
+
+		ReplicationType = Pose.bOpenInputCompressed ? EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms : EVRSkeletalReplicationType::Rep_HardTransforms;
+		bAllowDeformingMesh = Pose.bAllowDeformingMesh;
+		FMemory::Memcpy(RotationBits, Pose.RotationBits, sizeof(RotationBits));
+		ExpandHandPose(Pose, SkeletalTransforms);
+
+		if (ReceivedPoses.Num() < ReceivedPoseHistorySize)
+		{
+			ReceivedPoses.Add(MoveTemp(Pose));
+		}
+		else
+		{
+			ReceivedPoses[ReceivedPoseHead] = MoveTemp(Pose);
+			ReceivedPoseHead = (ReceivedPoseHead + 1) % ReceivedPoseHistorySize;
+		}
+
+		return true;
+	}
+
+	return false;
+}
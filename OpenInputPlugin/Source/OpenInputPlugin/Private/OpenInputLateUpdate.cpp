@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputLateUpdate.h"
+#include "OpenInputSkeletalMeshComponent.h"
+#include "SceneInterface.h"
+
+FOpenInputLateUpdateViewExtension::FOpenInputLateUpdateViewExtension(const FAutoRegister& AutoRegister)
+	: FSceneViewExtensionBase(AutoRegister)
+{
+}
+
+void FOpenInputLateUpdateViewExtension::RegisterComponent(UOpenInputSkeletalMeshComponent * Component)
+{
+	if (Component)
+		Components.AddUnique(Component);
+}
+
+void FOpenInputLateUpdateViewExtension::UnregisterComponent(UOpenInputSkeletalMeshComponent * Component)
+{
+	Components.Remove(Component);
+}
+
+bool FOpenInputLateUpdateViewExtension::IsActiveThisFrame(class FViewport* InViewport) const
+{
+	return Components.Num() > 0;
+}
+
+void FOpenInputLateUpdateViewExtension::BeginRenderViewFamily(FSceneViewFamily& InViewFamily)
+{
+	UWorld * FamilyWorld = InViewFamily.Scene ? InViewFamily.Scene->GetWorld() : nullptr;
+
+	for (int32 i = Components.Num() - 1; i >= 0; --i)
+	{
+		UOpenInputSkeletalMeshComponent * Component = Components[i].Get();
+
+		if (!Component)
+		{
+			Components.RemoveAtSwap(i);
+			continue;
+		}
+
+		// Scene captures and other worlds render their own families, the component guards against running twice a frame
+		if (Component->GetWorld() == FamilyWorld)
+		{
+			Component->ApplyLateUpdate();
+		}
+	}
+}
@@ -1,13 +1,107 @@
 // Copyright 1998-2016 Epic Games, Inc. All Rights Reserved.
 
 #include "OpenInputPlugin.h"
+#include "OpenInputSkeletalBackend.h"
+#include "OpenInputPoseSampler.h"
+#include "OpenInputSkeletalActionRegistry.h"
+#include "OpenInputSamplingThread.h"
+#include "OpenInputLateUpdate.h"
+#include "Engine/Engine.h"
+#include "Misc/CommandLine.h"
+#include "HAL/IConsoleManager.h"
 
 #define LOCTEXT_NAMESPACE "FOpenInputPluginModule"
 
+FOpenInputPluginModule* FOpenInputPluginModule::ModuleInstance = nullptr;
+
+static FAutoConsoleCommand CVarOpenInputSetSkeletalBackend(
+	TEXT("vr.OpenInput.SetSkeletalBackend"),
+	TEXT("Routes all OpenInput skeletal queries through the named backend (OpenVR, Synthetic)"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FOpenInputPluginModule* Module = FOpenInputPluginModule::Get();
+		if (Module && Args.Num() > 0 && !Module->SetActiveSkeletalBackendByName(FName(*Args[0])))
+		{
+			UE_LOG(OpenInputFunctionLibraryLog, Warning, TEXT("Unknown OpenInput skeletal backend: %s"), *Args[0]);
+		}
+	}));
+
+static FAutoConsoleCommand CVarOpenInputInvalidateSkeletalActions(
+	TEXT("vr.OpenInput.InvalidateSkeletalActions"),
+	TEXT("Drops all cached skeletal action handles and skeleton data, use after reloading the action manifest"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		if (FOpenInputSkeletalActionRegistry* Registry = FOpenInputPluginModule::GetActionRegistry())
+		{
+			Registry->InvalidateAll();
+		}
+	}));
+
+static FAutoConsoleCommand CVarOpenInputSyntheticDeviceChange(
+	TEXT("vr.OpenInput.Synthetic.SimulateDeviceChange"),
+	TEXT("Makes the synthetic backend report a different device behind every action"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FOpenInputPluginModule* Module = FOpenInputPluginModule::Get();
+		if (Module && Module->GetSyntheticSkeletalBackend())
+		{
+			Module->GetSyntheticSkeletalBackend()->SimulateDeviceChange();
+		}
+	}));
+
+static void OnOpenInputSamplingThreadSettingsChanged(IConsoleVariable* Var)
+{
+	if (FOpenInputPluginModule* Module = FOpenInputPluginModule::Get())
+	{
+		Module->RefreshSamplingThread();
+	}
+}
+
+static int32 GOpenInputSamplingThread = 0;
+static FAutoConsoleVariableRef CVarOpenInputSamplingThread(
+	TEXT("vr.OpenInput.SamplingThread"),
+	GOpenInputSamplingThread,
+	TEXT("1 polls skeletal actions from a background thread and feeds the pose sampler from its history, 0 polls on the game thread.\n")
+	TEXT("Only backends whose reads are safe off the game thread can be polled this way, the OpenVR backend can't and always polls on the game thread"),
+	FConsoleVariableDelegate::CreateStatic(&OnOpenInputSamplingThreadSettingsChanged),
+	ECVF_Default);
+
+static int32 GOpenInputSamplingThreadRate = 500;
+static FAutoConsoleVariableRef CVarOpenInputSamplingThreadRate(
+	TEXT("vr.OpenInput.SamplingThreadRate"),
+	GOpenInputSamplingThreadRate,
+	TEXT("Polls per second for the skeletal sampling thread (30 - 2000). Only poses that changed are recorded"),
+	FConsoleVariableDelegate::CreateStatic(&OnOpenInputSamplingThreadSettingsChanged),
+	ECVF_Default);
+
+FOpenInputPluginModule::~FOpenInputPluginModule()
+{
+}
+
 void FOpenInputPluginModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	//LoadOpenVRModule();
+
+	ModuleInstance = this;
+
+	OpenVRSkeletalBackend = MakeUnique<FOpenInputOpenVRSkeletalBackend>();
+	SyntheticSkeletalBackend = MakeUnique<FOpenInputSyntheticSkeletalBackend>();
+	ActiveSkeletalBackend = OpenVRSkeletalBackend.Get();
+	PoseSampler = MakeUnique<FOpenInputPoseSampler>();
+	ActionRegistry = MakeUnique<FOpenInputSkeletalActionRegistry>();
+
+	// -OpenInputBackend=Synthetic lets headless machines drive the hand pipeline without a runtime
+	FString BackendName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("OpenInputBackend="), BackendName))
+	{
+		if (!SetActiveSkeletalBackendByName(FName(*BackendName)))
+		{
+			UE_LOG(OpenInputFunctionLibraryLog, Warning, TEXT("Unknown OpenInput skeletal backend: %s, using OpenVR"), *BackendName);
+		}
+	}
+
+	RefreshSamplingThread();
 }
 
 void FOpenInputPluginModule::ShutdownModule()
@@ -15,6 +109,88 @@ void FOpenInputPluginModule::ShutdownModule()
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 //	UnloadOpenVRModule();
+
+	// Stop polling before anything it reads from goes away
+	SamplingThread.Reset();
+	LateUpdateExtension.Reset();
+	PoseSampler.Reset();
+	ActionRegistry.Reset();
+	ActiveSkeletalBackend = nullptr;
+	SyntheticSkeletalBackend.Reset();
+	OpenVRSkeletalBackend.Reset();
+
+	if (ModuleInstance == this)
+		ModuleInstance = nullptr;
+}
+
+void FOpenInputPluginModule::SetActiveSkeletalBackend(IOpenInputSkeletalBackend* NewBackend)
+{
+	// The thread holds on to the backend it was started with
+	SamplingThread.Reset();
+
+	ActiveSkeletalBackend = NewBackend ? NewBackend : OpenVRSkeletalBackend.Get();
+
+	// Handles belong to the backend that gave them out
+	if (ActionRegistry.IsValid())
+		ActionRegistry->InvalidateAll();
+
+	UE_LOG(OpenInputFunctionLibraryLog, Log, TEXT("OpenInput skeletal backend set to %s"), *ActiveSkeletalBackend->GetBackendName().ToString());
+
+	RefreshSamplingThread();
+}
+
+void FOpenInputPluginModule::RefreshSamplingThread()
+{
+	if (GOpenInputSamplingThread == 0 || !ActiveSkeletalBackend || !FPlatformProcess::SupportsMultithreading())
+	{
+		SamplingThread.Reset();
+		return;
+	}
+
+	if (!ActiveSkeletalBackend->SupportsOffThreadReads())
+	{
+		UE_LOG(OpenInputFunctionLibraryLog, Warning, TEXT("OpenInput skeletal backend %s can't be read off the game thread, vr.OpenInput.SamplingThread is ignored"), *ActiveSkeletalBackend->GetBackendName().ToString());
+		SamplingThread.Reset();
+		return;
+	}
+
+	if (!SamplingThread.IsValid())
+	{
+		SamplingThread = MakeUnique<FOpenInputSamplingThread>(ActiveSkeletalBackend, GOpenInputSamplingThreadRate);
+	}
+	else
+	{
+		SamplingThread->SetSampleRate(GOpenInputSamplingThreadRate);
+	}
+}
+
+FOpenInputLateUpdateViewExtension* FOpenInputPluginModule::GetLateUpdateExtension()
+{
+	if (!ModuleInstance)
+		return nullptr;
+
+	if (!ModuleInstance->LateUpdateExtension.IsValid() && GEngine)
+	{
+		ModuleInstance->LateUpdateExtension = FSceneViewExtensions::NewExtension<FOpenInputLateUpdateViewExtension>();
+	}
+
+	return ModuleInstance->LateUpdateExtension.Get();
+}
+
+bool FOpenInputPluginModule::SetActiveSkeletalBackendByName(FName BackendName)
+{
+	if (OpenVRSkeletalBackend.IsValid() && BackendName == OpenVRSkeletalBackend->GetBackendName())
+	{
+		SetActiveSkeletalBackend(OpenVRSkeletalBackend.Get());
+		return true;
+	}
+	else if (SyntheticSkeletalBackend.IsValid() && BackendName == SyntheticSkeletalBackend->GetBackendName())
+	{
+		SetActiveSkeletalBackend(SyntheticSkeletalBackend.Get());
+		return true;
+	}
+
+	return false;
 }
 
 /*bool FOpenVRExpansionPluginModule::LoadOpenVRModule()
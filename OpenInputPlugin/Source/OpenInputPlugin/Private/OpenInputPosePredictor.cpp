@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputPosePredictor.h"
+
+// Samples further apart than this don't say anything useful about the current velocity
+static const double OpenInputMaxPredictionSampleGap = 0.25;
+
+// Below this the sample times are too close together to divide by
+static const double OpenInputMinPredictionSampleGap = 0.0005;
+
+void FOpenInputPosePredictor::AddSample(FOpenInputPosePredictionState & State, const FBPOpenVRPosePredictionSettings & Settings, const TArray<FTransform> & Transforms, double SampleTime)
+{
+	const int32 NumBones = Transforms.Num();
+
+	if (State.LastRotations.Num() != NumBones)
+	{
+		// First sample or the skeleton changed, start over with no motion
+		State.LastRotations.SetNumUninitialized(NumBones, false);
+		State.AngularVelocities.Init(FVector::ZeroVector, NumBones);
+
+		for (int32 i = 0; i < NumBones; ++i)
+			State.LastRotations[i] = Transforms[i].GetRotation();
+
+		State.LastSampleTime = SampleTime;
+		return;
+	}
+
+	const double DeltaTime = SampleTime - State.LastSampleTime;
+
+	if (DeltaTime < OpenInputMinPredictionSampleGap)
+		return;
+
+	const bool bStale = DeltaTime > OpenInputMaxPredictionSampleGap;
+	const float InvDeltaTime = (float)(1.0 / DeltaTime);
+	const float Smoothing = FMath::Clamp(Settings.VelocitySmoothing, 0.01f, 1.f);
+
+	for (int32 i = 0; i < NumBones; ++i)
+	{
+		const FQuat Rotation = Transforms[i].GetRotation();
+
+		if (bStale)
+		{
+			State.AngularVelocities[i] = FVector::ZeroVector;
+		}
+		else
+		{
+			// Rotation that took the bone from the last sample to this one, kept on the short arc
+			FQuat DeltaQuat = Rotation * State.LastRotations[i].Inverse();
+			if (DeltaQuat.W < 0.f)
+				DeltaQuat = DeltaQuat * -1.f;
+
+			FVector Axis;
+			float Angle;
+			DeltaQuat.ToAxisAndAngle(Axis, Angle);
+
+			const FVector NewVelocity = Axis * (Angle * InvDeltaTime);
+			State.AngularVelocities[i] = FMath::Lerp(State.AngularVelocities[i], NewVelocity, Smoothing);
+		}
+
+		State.LastRotations[i] = Rotation;
+	}
+
+	State.LastSampleTime = SampleTime;
+}
+
+void FOpenInputPosePredictor::Extrapolate(const FOpenInputPosePredictionState & State, const FBPOpenVRPosePredictionSettings & Settings, const TArray<FTransform> & Transforms, double SampleTime, double TargetTime, TArray<FTransform> & OutTransforms)
+{
+	if (&OutTransforms != &Transforms)
+		OutTransforms = Transforms;
+
+	const int32 NumBones = FMath::Min(Transforms.Num(), State.AngularVelocities.Num());
+	const float LeadTime = (float)FMath::Clamp(TargetTime - SampleTime, 0.0, (double)FMath::Max(Settings.MaxLeadTime, 0.f));
+
+	if (LeadTime <= 0.f)
+		return;
+
+	const float MaxAngle = FMath::DegreesToRadians(FMath::Max(Settings.MaxBoneAngle, 0.f));
+
+	// Root is the tracking origin and never moves relative to itself
+	for (int32 i = (int32)EVROpenInputBones::eBone_Wrist; i < NumBones; ++i)
+	{
+		const FVector & Velocity = State.AngularVelocities[i];
+		const float Speed = Velocity.Size();
+		const float Angle = FMath::Min(Speed * LeadTime, MaxAngle);
+
+		if (Angle < KINDA_SMALL_NUMBER)
+			continue;
+
+		const FQuat Step(Velocity / Speed, Angle);
+		OutTransforms[i].SetRotation((Step * Transforms[i].GetRotation()).GetNormalized());
+	}
+}
+
+void FOpenInputPosePredictor::PredictActionPose(FBPOpenVRActionInfo & Action, double TargetTime)
+{
+	if (!Action.PredictionSettings.bPredictPose || !Action.bHasValidData)
+		return;
+
+	TArray<FTransform> & Transforms = Action.SkeletalData.SkeletalTransforms;
+
+	AddSample(Action.PredictionState, Action.PredictionSettings, Transforms, Action.SampleTime);
+	Extrapolate(Action.PredictionState, Action.PredictionSettings, Transforms, Action.SampleTime, TargetTime, Transforms);
+	Action.PredictionState.LastTargetTime = TargetTime;
+	Action.NotifyPoseChanged();
+}
@@ -0,0 +1,297 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputPoseSampler.h"
+#include "OpenInputPlugin.h"
+#include "OpenInputSamplingThread.h"
+#include "Engine/Engine.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skeletal Runtime Samples"), STAT_OpenInputRuntimeSamples, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skeletal Shared Sample Reads"), STAT_OpenInputSharedSampleReads, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skeletal Sampling Thread Reads"), STAT_OpenInputSamplingThreadReads, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skeletal Late Samples"), STAT_OpenInputLateSamples, STATGROUP_OpenInput);
+
+// A channel the thread hasn't polled for this long is treated as stalled and the runtime is queried directly.
+// Sample timestamps can't be used for this, an unchanged pose keeps the time it first appeared.
+static const double OpenInputMaxThreadSampleAge = 0.1;
+
+FOpenInputPoseSamplerKey::FOpenInputPoseSamplerKey(const FBPOpenVRActionInfo & Action, float InWorldToMeters)
+{
+	ActionName = Action.ActionName.IsEmpty() ? UOpenInputFunctionLibrary::GetDefaultSkeletalActionName(Action.SkeletalData.TargetHand) : Action.ActionName;
+	TargetHand = Action.SkeletalData.TargetHand;
+	bWithController = Action.bGetSkeletalTransforms_WithController;
+	bMirrorLeftRight = Action.SkeletalData.bMirrorLeftRight;
+	WorldToMeters = InWorldToMeters;
+}
+
+float FOpenInputPoseSampler::GetWorldToMeters(const FBPOpenVRActionInfo & Action, UObject * WorldContextObject)
+{
+	if (Action.SkeletalData.WorldScaleOverride > 0.0f)
+		return Action.SkeletalData.WorldScaleOverride;
+
+	UWorld* World = (WorldContextObject) ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	return (World != nullptr) ? World->GetWorldSettings()->WorldToMeters : 100.f;
+}
+
+FOpenInputPoseSubscription FOpenInputPoseSampler::Subscribe(const FBPOpenVRActionInfo & Action, UObject * WorldContextObject)
+{
+	FOpenInputPoseSamplerKey Key(Action, GetWorldToMeters(Action, WorldContextObject));
+	FOpenInputPoseSubscription Subscription;
+
+	int32 FreeIndex = INDEX_NONE;
+	for (int i = 0; i < Channels.Num(); ++i)
+	{
+		if (Channels[i].SubscriberCount > 0)
+		{
+			if (Channels[i].Key == Key)
+			{
+				Channels[i].SubscriberCount++;
+				Subscription.ChannelIndex = i;
+				return Subscription;
+			}
+		}
+		else if (FreeIndex == INDEX_NONE)
+		{
+			FreeIndex = i;
+		}
+	}
+
+	if (FreeIndex == INDEX_NONE)
+		FreeIndex = Channels.AddDefaulted();
+	else
+		Channels[FreeIndex] = FSampledChannel();
+
+	FSampledChannel & Channel = Channels[FreeIndex];
+	Channel.Key = Key;
+	Channel.SubscriberCount = 1;
+	Channel.SharedAction.ActionName = Key.ActionName;
+	Channel.SharedAction.bGetSkeletalTransforms_WithController = Key.bWithController;
+	Channel.SharedAction.SkeletalData.TargetHand = Key.TargetHand;
+	Channel.SharedAction.SkeletalData.bMirrorLeftRight = Key.bMirrorLeftRight;
+	Channel.SharedAction.SkeletalData.WorldScaleOverride = Key.WorldToMeters;
+	Channel.LateAction = Channel.SharedAction;
+
+	Subscription.ChannelIndex = FreeIndex;
+	return Subscription;
+}
+
+void FOpenInputPoseSampler::Unsubscribe(FOpenInputPoseSubscription & Subscription)
+{
+	if (Channels.IsValidIndex(Subscription.ChannelIndex) && Channels[Subscription.ChannelIndex].SubscriberCount > 0)
+	{
+		Channels[Subscription.ChannelIndex].SubscriberCount--;
+
+		FOpenInputSamplingThread * SamplingThread = FOpenInputPluginModule::GetSamplingThread();
+		if (SamplingThread && Channels[Subscription.ChannelIndex].SubscriberCount == 0)
+		{
+			SamplingThread->SetChannelSource(Subscription.ChannelIndex, vr::k_ulInvalidActionHandle, false);
+		}
+	}
+
+	Subscription.ChannelIndex = INDEX_NONE;
+}
+
+bool FOpenInputPoseSampler::AcquirePose(FOpenInputPoseSubscription & Subscription, FBPOpenVRActionInfo & Action, UObject * WorldContextObject, EOpenInputPoseProducts Products)
+{
+	if (Products == EOpenInputPoseProducts::None)
+		return false;
+
+	// Settings on the action can be changed at runtime from blueprint, make sure we are still reading the right channel
+	if (!Channels.IsValidIndex(Subscription.ChannelIndex) || Channels[Subscription.ChannelIndex].SubscriberCount < 1 ||
+		!(Channels[Subscription.ChannelIndex].Key == FOpenInputPoseSamplerKey(Action, GetWorldToMeters(Action, WorldContextObject))))
+	{
+		Unsubscribe(Subscription);
+		Subscription = Subscribe(Action, WorldContextObject);
+	}
+
+	FSampledChannel & Channel = Channels[Subscription.ChannelIndex];
+
+	if (Channel.SampledFrame != GFrameCounter)
+	{
+		SampleChannel(Subscription.ChannelIndex, Channel, WorldContextObject, Products);
+	}
+	else if (!EnumHasAllFlags(Channel.SampledProducts, Products))
+	{
+		// Someone earlier in the frame needed less than we do, fill in the rest
+		if (Channel.bSampleSucceeded)
+		{
+			SampleMissingProducts(Channel, WorldContextObject, Products & ~Channel.SampledProducts);
+		}
+		else
+		{
+			// Nobody got anything out of the earlier sample, so there is nothing to keep consistent with
+			SampleChannel(Subscription.ChannelIndex, Channel, WorldContextObject, Products | Channel.SampledProducts);
+		}
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_OpenInputSharedSampleReads);
+	}
+
+	CopySampleTo(Channel, Action, Products);
+	return Channel.bSampleSucceeded;
+}
+
+void FOpenInputPoseSampler::SampleChannel(int32 ChannelIndex, FSampledChannel & Channel, UObject * WorldContextObject, EOpenInputPoseProducts Products)
+{
+	Channel.SampledFrame = GFrameCounter;
+	Channel.SampledProducts = Products;
+
+	const bool bGetGestureValues = EnumHasAnyFlags(Products, EOpenInputPoseProducts::Summary);
+
+	// Compressed data still comes straight from the runtime, it is only asked for at the net rate.
+	// The thread always has bones and summary in hand, so it is only worth reading when the bones are wanted.
+	FOpenInputSamplingThread * SamplingThread = FOpenInputPluginModule::GetSamplingThread();
+	if (SamplingThread && EnumHasAnyFlags(Products, EOpenInputPoseProducts::Bones) && !EnumHasAnyFlags(Products, EOpenInputPoseProducts::Compressed) && ChannelIndex < FOpenInputSamplingThread::MaxChannels)
+	{
+		// Keep the thread pointed at whatever handle the registry last gave this action
+		SamplingThread->SetChannelSource(ChannelIndex, Channel.SharedAction.ActionHandleContainer.ActionHandle, Channel.Key.bWithController);
+
+		FOpenInputRawPoseSample Sample;
+		if ((FPlatformTime::Seconds() - SamplingThread->GetLastPollTime(ChannelIndex)) < OpenInputMaxThreadSampleAge && SamplingThread->ReadLatest(ChannelIndex, Sample))
+		{
+			Channel.bSampleSucceeded = UOpenInputFunctionLibrary::ApplyRawPoseSample(Channel.SharedAction, Sample, WorldContextObject, bGetGestureValues);
+
+			if (Channel.bSampleSucceeded)
+			{
+				INC_DWORD_STAT(STAT_OpenInputSamplingThreadReads);
+				return;
+			}
+		}
+	}
+
+	INC_DWORD_STAT(STAT_OpenInputRuntimeSamples);
+	Channel.bSampleSucceeded = UOpenInputFunctionLibrary::GetActionPoseProducts(Channel.SharedAction, WorldContextObject, Products);
+}
+
+void FOpenInputPoseSampler::SampleMissingProducts(FSampledChannel & Channel, UObject * WorldContextObject, EOpenInputPoseProducts MissingProducts)
+{
+	FBPOpenVRActionInfo & Shared = Channel.SharedAction;
+	Channel.SampledProducts |= MissingProducts;
+
+	// Only the missing products are read, the bones and summary earlier consumers already copied this frame stay as they are
+	INC_DWORD_STAT(STAT_OpenInputRuntimeSamples);
+	if (!UOpenInputFunctionLibrary::GetActionPoseProducts(Shared, WorldContextObject, MissingProducts))
+	{
+		// Still have the earlier products, this consumer just goes without the missing ones
+		Shared.bHasValidData = true;
+
+		if (EnumHasAnyFlags(MissingProducts, EOpenInputPoseProducts::Compressed))
+		{
+			Shared.CompressedSize = 0;
+			Shared.CompressedTransforms.Reset();
+		}
+	}
+}
+
+bool FOpenInputPoseSampler::ReadSampleNearTime(const FOpenInputPoseSubscription & Subscription, double TargetTime, FBPOpenVRActionInfo & Action, UObject * WorldContextObject)
+{
+	FOpenInputSamplingThread * SamplingThread = FOpenInputPluginModule::GetSamplingThread();
+
+	if (!SamplingThread || !Channels.IsValidIndex(Subscription.ChannelIndex) || Subscription.ChannelIndex >= FOpenInputSamplingThread::MaxChannels)
+		return false;
+
+	FOpenInputRawPoseSample Sample;
+	return SamplingThread->ReadNearest(Subscription.ChannelIndex, TargetTime, Sample) &&
+		UOpenInputFunctionLibrary::ApplyRawPoseSample(Action, Sample, WorldContextObject, true);
+}
+
+static bool AreSameTransforms(const TArray<FTransform> & A, const TArray<FTransform> & B)
+{
+	if (A.Num() != B.Num())
+		return false;
+
+	for (int32 i = 0; i < A.Num(); ++i)
+	{
+		if (!A[i].Equals(B[i], 0.f))
+			return false;
+	}
+
+	return true;
+}
+
+const FBPOpenVRActionInfo * FOpenInputPoseSampler::AcquireLatePose(const FOpenInputPoseSubscription & Subscription, UObject * WorldContextObject)
+{
+	if (!Channels.IsValidIndex(Subscription.ChannelIndex) || Channels[Subscription.ChannelIndex].SubscriberCount < 1)
+		return nullptr;
+
+	FSampledChannel & Channel = Channels[Subscription.ChannelIndex];
+
+	if (Channel.LateSampledFrame != GFrameCounter)
+	{
+		Channel.LateSampledFrame = GFrameCounter;
+		INC_DWORD_STAT(STAT_OpenInputLateSamples);
+
+		// The thread has almost always taken a newer sample than the runtime would give us this late in the frame
+		FOpenInputSamplingThread * SamplingThread = FOpenInputPluginModule::GetSamplingThread();
+		FOpenInputRawPoseSample Sample;
+
+		if (!SamplingThread || Subscription.ChannelIndex >= FOpenInputSamplingThread::MaxChannels ||
+			(FPlatformTime::Seconds() - SamplingThread->GetLastPollTime(Subscription.ChannelIndex)) >= OpenInputMaxThreadSampleAge ||
+			!SamplingThread->ReadLatest(Subscription.ChannelIndex, Sample) ||
+			!UOpenInputFunctionLibrary::ApplyRawPoseSample(Channel.LateAction, Sample, WorldContextObject, false))
+		{
+			UOpenInputFunctionLibrary::GetActionPose(Channel.LateAction, WorldContextObject, false, false);
+		}
+
+		// A runtime read in the same frame restamps the same data, so compare the bones as well as the time
+		Channel.bLateSampleIsNewer = Channel.LateAction.bHasValidData;
+		if (Channel.bLateSampleIsNewer && Channel.SampledFrame == GFrameCounter && Channel.bSampleSucceeded)
+		{
+			Channel.bLateSampleIsNewer = Channel.LateAction.SampleTime > Channel.SharedAction.SampleTime &&
+				!AreSameTransforms(Channel.LateAction.SkeletalData.SkeletalTransforms, Channel.SharedAction.SkeletalData.SkeletalTransforms);
+		}
+	}
+
+	return Channel.bLateSampleIsNewer ? &Channel.LateAction : nullptr;
+}
+
+void FOpenInputPoseSampler::CopySampleTo(const FSampledChannel & Channel, FBPOpenVRActionInfo & Action, EOpenInputPoseProducts Products)
+{
+	const FBPOpenVRActionInfo & Shared = Channel.SharedAction;
+
+	Action.bHasValidData = false;
+	Action.ActionHandleContainer = Shared.ActionHandleContainer;
+
+	if (!Channel.bSampleSucceeded || !Shared.bHasValidData)
+		return;
+
+	if (Action.ActionName.IsEmpty())
+		Action.ActionName = Channel.Key.ActionName;
+
+	Action.BoneCount = Shared.BoneCount;
+	Action.SkeletalTrackingLevel = Shared.SkeletalTrackingLevel;
+
+	// Can change under us if the device behind the action is swapped
+	if (Action.BoneParentIndexes != Shared.BoneParentIndexes)
+		Action.BoneParentIndexes = Shared.BoneParentIndexes;
+
+	if (EnumHasAnyFlags(Products, EOpenInputPoseProducts::Summary))
+		Action.PoseFingerData = Shared.PoseFingerData;
+
+	if (EnumHasAnyFlags(Products, EOpenInputPoseProducts::Compressed))
+	{
+		// Assignment would reallocate whenever the blob size moves, this keeps whatever capacity the consumer already has
+		Action.CompressedSize = Shared.CompressedSize;
+		Action.CompressedTransforms.SetNumUninitialized(Shared.CompressedTransforms.Num(), false);
+		FMemory::Memcpy(Action.CompressedTransforms.GetData(), Shared.CompressedTransforms.GetData(), Shared.CompressedTransforms.Num());
+	}
+	else
+	{
+		Action.CompressedSize = 0;
+		Action.CompressedTransforms.Reset();
+	}
+
+	if (EnumHasAnyFlags(Products, EOpenInputPoseProducts::Bones))
+	{
+		// Swap rather than copy so the steady state reuses both arrays
+		if (Action.SkeletalData.SkeletalTransforms.Num() > 0)
+		{
+			Swap(Action.OldSkeletalTransforms, Action.SkeletalData.SkeletalTransforms);
+		}
+
+		Action.SkeletalData.SkeletalTransforms = Shared.SkeletalData.SkeletalTransforms;
+		Action.SampleTime = Shared.SampleTime;
+		Action.NotifyPoseChanged();
+	}
+
+	Action.bHasValidData = true;
+}
@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputSamplingThread.h"
+#include "OpenInputSkeletalBackend.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+
+FOpenInputSamplingThread::FOpenInputSamplingThread(IOpenInputSkeletalBackend * InBackend, int32 InSampleRate)
+	: Backend(InBackend)
+	, SampleRate(InSampleRate)
+	, bStopRequested(false)
+	, Thread(nullptr)
+{
+	Thread = FRunnableThread::Create(this, TEXT("OpenInputSamplingThread"), 0, TPri_AboveNormal);
+}
+
+FOpenInputSamplingThread::~FOpenInputSamplingThread()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+}
+
+void FOpenInputSamplingThread::SetChannelSource(int32 ChannelIndex, vr::VRActionHandle_t ActionHandle, bool bWithController)
+{
+	if (ChannelIndex < 0 || ChannelIndex >= MaxChannels)
+		return;
+
+	FChannel & Channel = Channels[ChannelIndex];
+
+	if (Channel.ActionHandle.Load() == ActionHandle && Channel.bWithController.Load() == bWithController)
+		return;
+
+	// Readers reject samples whose handle doesn't match what they asked for, so stale history is harmless
+	Channel.bWithController = bWithController;
+	Channel.ActionHandle = ActionHandle;
+}
+
+void FOpenInputSamplingThread::SetSampleRate(int32 NewSampleRate)
+{
+	SampleRate = NewSampleRate;
+}
+
+uint32 FOpenInputSamplingThread::Run()
+{
+	while (!bStopRequested.Load())
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		if (Backend && Backend->IsAvailable())
+		{
+			for (int32 i = 0; i < MaxChannels; ++i)
+			{
+				if (Channels[i].ActionHandle.Load() != vr::k_ulInvalidActionHandle)
+					SampleChannel(Channels[i]);
+			}
+		}
+
+		const double Interval = 1.0 / FMath::Clamp(SampleRate.Load(), 30, 2000);
+		const double TimeLeft = Interval - (FPlatformTime::Seconds() - StartTime);
+
+		if (TimeLeft > 0.0)
+			FPlatformProcess::SleepNoStats((float)TimeLeft);
+	}
+
+	return 0;
+}
+
+void FOpenInputSamplingThread::Stop()
+{
+	bStopRequested = true;
+}
+
+void FOpenInputSamplingThread::PollChannel(const FChannel & Channel, FOpenInputRawPoseSample & Sample) const
+{
+	Sample.ActionHandle = (vr::VRActionHandle_t)Channel.ActionHandle.Load();
+	Sample.ActiveOrigin = vr::k_ulInvalidInputValueHandle;
+	Sample.bActive = false;
+	Sample.BoneCount = 0;
+
+	vr::InputSkeletalActionData_t ActionData;
+	vr::EVRInputError InputError = Backend->GetSkeletalActionData(Sample.ActionHandle, ActionData);
+
+	if (InputError == vr::EVRInputError::VRInputError_None && ActionData.bActive)
+	{
+		Sample.ActiveOrigin = ActionData.activeOrigin;
+
+		uint32 BoneCount = 0;
+		InputError = Backend->GetBoneCount(Sample.ActionHandle, BoneCount);
+
+		// Anything other than the standard hand is left to the game thread path
+		if (InputError == vr::EVRInputError::VRInputError_None && BoneCount > 0 && BoneCount <= (uint32)EVROpenInputBones::eBone_Count)
+		{
+			vr::EVRSkeletalMotionRange MotionRange = Channel.bWithController.Load() ? vr::EVRSkeletalMotionRange::VRSkeletalMotionRange_WithController : vr::EVRSkeletalMotionRange::VRSkeletalMotionRange_WithoutController;
+			InputError = Backend->GetSkeletalBoneData(Sample.ActionHandle, MotionRange, Sample.BoneTransforms, BoneCount);
+
+			vr::VRSkeletalSummaryData_t SummaryData;
+			if (InputError == vr::EVRInputError::VRInputError_None)
+				InputError = Backend->GetSkeletalSummaryData(Sample.ActionHandle, SummaryData);
+
+			if (InputError == vr::EVRInputError::VRInputError_None)
+			{
+				FMemory::Memcpy(Sample.FingerCurls, SummaryData.flFingerCurl, sizeof(Sample.FingerCurls));
+				FMemory::Memcpy(Sample.FingerSplays, SummaryData.flFingerSplay, sizeof(Sample.FingerSplays));
+				Sample.BoneCount = BoneCount;
+				Sample.bActive = true;
+			}
+		}
+	}
+}
+
+bool FOpenInputSamplingThread::IsSamePose(const FOpenInputRawPoseSample & A, const FOpenInputRawPoseSample & B)
+{
+	if (A.ActionHandle != B.ActionHandle || A.bActive != B.bActive || A.ActiveOrigin != B.ActiveOrigin || A.BoneCount != B.BoneCount)
+		return false;
+
+	if (!A.bActive)
+		return true;
+
+	return FMemory::Memcmp(A.BoneTransforms, B.BoneTransforms, A.BoneCount * sizeof(vr::VRBoneTransform_t)) == 0 &&
+		FMemory::Memcmp(A.FingerCurls, B.FingerCurls, sizeof(A.FingerCurls)) == 0 &&
+		FMemory::Memcmp(A.FingerSplays, B.FingerSplays, sizeof(A.FingerSplays)) == 0;
+}
+
+void FOpenInputSamplingThread::SampleChannel(FChannel & Channel)
+{
+	FOpenInputRawPoseSample & Sample = ScratchSample;
+	PollChannel(Channel, Sample);
+
+	const double PollTime = FPlatformTime::Seconds();
+	uint64 PollTimeBits;
+	FMemory::Memcpy(&PollTimeBits, &PollTime, sizeof(PollTimeBits));
+	Channel.LastPollTimeBits = PollTimeBits;
+
+	// Nothing new since the last publish, the newest slot keeps the time the pose first showed up
+	if (Channel.bHasPublished && IsSamePose(Sample, Channel.LastPublished))
+		return;
+
+	// Something changed, which is when the game thread may be midway through updating the action state
+	PollChannel(Channel, ConfirmSample);
+	if (!IsSamePose(Sample, ConfirmSample))
+		return;
+
+	Sample.Timestamp = PollTime;
+	Channel.LastPublished = Sample;
+	Channel.bHasPublished = true;
+
+	// Publish, odd sequence while the slot is being written
+	const uint64 SampleNumber = Channel.WriteCount.Load();
+	FSlot & Slot = Channel.Slots[SampleNumber % HistoryLength];
+
+	const uint32 Sequence = Slot.Sequence.Load();
+	Slot.Sequence = Sequence + 1;
+	FPlatformMisc::MemoryBarrier();
+
+	FMemory::Memcpy(&Slot.Sample, &Sample, sizeof(FOpenInputRawPoseSample));
+
+	FPlatformMisc::MemoryBarrier();
+	Slot.Sequence = Sequence + 2;
+	Channel.WriteCount = SampleNumber + 1;
+}
+
+bool FOpenInputSamplingThread::ReadSlot(const FChannel & Channel, uint64 SampleNumber, FOpenInputRawPoseSample & OutSample) const
+{
+	const FSlot & Slot = Channel.Slots[SampleNumber % HistoryLength];
+
+	// A couple of tries is plenty, the writer spends far less time in a slot than it does sleeping
+	for (int32 Attempt = 0; Attempt < 4; ++Attempt)
+	{
+		const uint32 SequenceBefore = Slot.Sequence.Load();
+		if (SequenceBefore & 1)
+			continue;
+
+		FPlatformMisc::MemoryBarrier();
+		FMemory::Memcpy(&OutSample, &Slot.Sample, sizeof(FOpenInputRawPoseSample));
+		FPlatformMisc::MemoryBarrier();
+
+		if (Slot.Sequence.Load() == SequenceBefore)
+		{
+			// The slot may have been lapped by a newer sample between finding it and reading it
+			return Channel.WriteCount.Load() - SampleNumber <= (uint64)HistoryLength;
+		}
+	}
+
+	return false;
+}
+
+double FOpenInputSamplingThread::GetLastPollTime(int32 ChannelIndex) const
+{
+	if (ChannelIndex < 0 || ChannelIndex >= MaxChannels)
+		return 0.0;
+
+	const uint64 PollTimeBits = Channels[ChannelIndex].LastPollTimeBits.Load();
+	double PollTime;
+	FMemory::Memcpy(&PollTime, &PollTimeBits, sizeof(PollTime));
+	return PollTime;
+}
+
+bool FOpenInputSamplingThread::ReadLatest(int32 ChannelIndex, FOpenInputRawPoseSample & OutSample) const
+{
+	if (ChannelIndex < 0 || ChannelIndex >= MaxChannels)
+		return false;
+
+	const FChannel & Channel = Channels[ChannelIndex];
+	const uint64 WriteCount = Channel.WriteCount.Load();
+
+	return WriteCount > 0 && ReadSlot(Channel, WriteCount - 1, OutSample);
+}
+
+bool FOpenInputSamplingThread::ReadNearest(int32 ChannelIndex, double TargetTime, FOpenInputRawPoseSample & OutSample) const
+{
+	if (ChannelIndex < 0 || ChannelIndex >= MaxChannels)
+		return false;
+
+	const FChannel & Channel = Channels[ChannelIndex];
+	const uint64 WriteCount = Channel.WriteCount.Load();
+
+	if (WriteCount == 0)
+		return false;
+
+	// Leave one slot of headroom so the writer isn't racing us for the oldest entry
+	const uint64 OldestSample = WriteCount > (uint64)(HistoryLength - 1) ? WriteCount - (HistoryLength - 1) : 0;
+
+	FOpenInputRawPoseSample Candidate;
+	double BestDelta = MAX_dbl;
+	bool bFound = false;
+
+	// Walk backwards from the newest, timestamps only decrease so we can stop once they start moving away
+	for (uint64 SampleNumber = WriteCount; SampleNumber-- > OldestSample;)
+	{
+		if (!ReadSlot(Channel, SampleNumber, Candidate))
+			continue;
+
+		const double Delta = FMath::Abs(Candidate.Timestamp - TargetTime);
+		if (Delta >= BestDelta)
+			break;
+
+		BestDelta = Delta;
+		OutSample = Candidate;
+		bFound = true;
+	}
+
+	return bFound;
+}
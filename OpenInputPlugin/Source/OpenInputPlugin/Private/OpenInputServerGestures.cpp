@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputServerGestures.h"
+#include "OpenInputSkeletalMeshComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Server Gesture Detection"), STAT_OpenInputServerGestures, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Gesture Hands Matched"), STAT_OpenInputServerGestureHands, STATGROUP_OpenInput);
+
+bool UOpenInputServerGestureSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Net mode isn't known this early, components only register once they find they are on a server
+	const UWorld * World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UOpenInputServerGestureSubsystem::Deinitialize()
+{
+	Components.Reset();
+	Queries.Reset();
+	Super::Deinitialize();
+}
+
+void UOpenInputServerGestureSubsystem::RegisterComponent(UOpenInputSkeletalMeshComponent * Component)
+{
+	if (Component)
+		Components.AddUnique(Component);
+}
+
+void UOpenInputServerGestureSubsystem::UnregisterComponent(UOpenInputSkeletalMeshComponent * Component)
+{
+	Components.Remove(Component);
+}
+
+bool UOpenInputServerGestureSubsystem::IsTickable() const
+{
+	return Components.Num() > 0;
+}
+
+TStatId UOpenInputServerGestureSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOpenInputServerGestureSubsystem, STATGROUP_Tickables);
+}
+
+void UOpenInputServerGestureSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_OpenInputServerGestures);
+
+	Queries.Reset();
+
+	// Gather, hands only go in when a new curl packet has arrived for them since the last pass
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num();)
+	{
+		UOpenInputSkeletalMeshComponent * Component = Components[ComponentIndex].Get();
+
+		if (!Component)
+		{
+			// Not swapped, events go out in registration order
+			Components.RemoveAt(ComponentIndex);
+			continue;
+		}
+
+		const uint32 PendingHands = Component->ServerPendingGestureHands;
+		Component->ServerPendingGestureHands = 0;
+
+		// A listen servers own hands are detected by the regular local path
+		if (PendingHands == 0 || !Component->bDetectGestures || !Component->bDetectGesturesOnServer || !Component->GesturesDB ||
+			Component->GesturesDB->GetNumGestures() < 1 || Component->IsLocallyControlled())
+		{
+			++ComponentIndex;
+			continue;
+		}
+
+		// Filtered by the components disabled contexts, components with the same ones share a set
+		TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> CompiledGestures = Component->GetActiveGestures();
+
+		for (int32 ActionIndex = 0; ActionIndex < Component->HandSkeletalActions.Num() && ActionIndex < 32; ++ActionIndex)
+		{
+			if (!(PendingHands & (1u << ActionIndex)))
+				continue;
+
+			FBPOpenVRActionInfo & SkeletalAction = Component->HandSkeletalActions[ActionIndex];
+
+			FHandQuery & Query = Queries.AddDefaulted_GetRef();
+			Query.Component = Component;
+			Query.ActionIndex = ActionIndex;
+			Query.CompiledGestures = CompiledGestures;
+			Query.PoseData = &SkeletalAction.PoseFingerData;
+			Query.bUseClosestMatch = Component->bUseClosestGestureMatch;
+			Query.Result = INDEX_NONE;
+
+			// Odd hands need the per gesture loop against the source, they still queue up so their events keep their place in the order
+			Query.bScalar = SkeletalAction.PoseFingerData.PoseFingerCurls.Num() != vr::VRFinger_Count;
+			if (Query.bScalar)
+			{
+				Query.TrackingLevel = SkeletalAction.SkeletalTrackingLevel;
+				continue;
+			}
+
+			// The tracking level isn't replicated, without splays in the packet there is nothing to test splay gestures against
+			Query.TrackingLevel = SkeletalAction.PoseFingerData.PoseFingerSplays.Num() == vr::VRFingerSplay_Count ?
+				EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Partial : EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full;
+		}
+
+		++ComponentIndex;
+	}
+
+	if (Queries.Num() < 1)
+		return;
+
+	INC_DWORD_STAT_BY(STAT_OpenInputServerGestureHands, Queries.Num());
+
+	// Match, only reads the compiled sets and poses and only writes each querys own result
+	const int32 NumBatches = FMath::DivideAndRoundUp(Queries.Num(), HandsPerBatch);
+	ParallelFor(NumBatches, [this](int32 BatchIndex)
+	{
+		const int32 End = FMath::Min((BatchIndex + 1) * HandsPerBatch, Queries.Num());
+
+		for (int32 i = BatchIndex * HandsPerBatch; i < End; ++i)
+		{
+			FHandQuery & Query = Queries[i];
+			float Distance = 0.f;
+
+			if (Query.bScalar)
+				continue;
+
+			Query.Result = Query.bUseClosestMatch ?
+				Query.CompiledGestures->FindBestMatchCompiled(*Query.PoseData, Query.TrackingLevel, true, Distance) :
+				Query.CompiledGestures->FindFirstMatchCompiled(*Query.PoseData, Query.TrackingLevel);
+		}
+	}, NumBatches < 2);
+
+	// Apply, back on the game thread in gather order
+	for (const FHandQuery & Query : Queries)
+	{
+		UOpenInputSkeletalMeshComponent * Component = Query.Component.Get();
+
+		// An earlier event may have torn the hands down
+		if (Component && Component->HandSkeletalActions.IsValidIndex(Query.ActionIndex))
+		{
+			FBPOpenVRActionInfo & SkeletalAction = Component->HandSkeletalActions[Query.ActionIndex];
+			int32 Result = Query.Result;
+
+			// Read the source gestures here rather than in the batches, an earlier event may be editing them.
+			// Re-fetched from the component as an earlier event may also have moved the hands array.
+			if (Query.bScalar)
+			{
+				Result = Component->GesturesDB ?
+					FOpenInputCompiledGestureSet::FindFirstMatchScalar(Component->GesturesDB->Gestures, SkeletalAction.PoseFingerData, Query.TrackingLevel, Query.CompiledGestures.Get()) :
+					INDEX_NONE;
+			}
+
+			Component->ApplyDetectedGesture(SkeletalAction, Result);
+		}
+	}
+}
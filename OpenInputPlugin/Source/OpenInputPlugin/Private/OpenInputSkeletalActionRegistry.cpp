@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputSkeletalActionRegistry.h"
+#include "OpenInputSkeletalBackend.h"
+
+FOpenInputSkeletalActionEntry * FOpenInputSkeletalActionRegistry::ResolveAction(IOpenInputSkeletalBackend * Backend, const FString & ActionName, int32 & InOutCachedIndex)
+{
+	if (!Backend)
+		return nullptr;
+
+	// Action names can be changed from blueprint, so the cached index is only trusted if it still matches
+	if (!Entries.IsValidIndex(InOutCachedIndex) || Entries[InOutCachedIndex].ActionName != ActionName)
+	{
+		if (int32 * FoundIndex = EntryIndexByName.Find(ActionName))
+		{
+			InOutCachedIndex = *FoundIndex;
+		}
+		else
+		{
+			InOutCachedIndex = Entries.AddDefaulted();
+			Entries[InOutCachedIndex].ActionName = ActionName;
+			EntryIndexByName.Add(ActionName, InOutCachedIndex);
+		}
+	}
+
+	FOpenInputSkeletalActionEntry & Entry = Entries[InOutCachedIndex];
+
+	if (Entry.ActionHandle == vr::k_ulInvalidActionHandle)
+	{
+		vr::EVRInputError InputError = Backend->GetActionHandle(Entry.ActionName, Entry.ActionHandle);
+		if (InputError != vr::EVRInputError::VRInputError_None || Entry.ActionHandle == vr::k_ulInvalidActionHandle)
+		{
+			Entry.ActionHandle = vr::k_ulInvalidActionHandle;
+			return nullptr;
+		}
+	}
+
+	return &Entry;
+}
+
+bool FOpenInputSkeletalActionRegistry::EnsureMetadata(IOpenInputSkeletalBackend * Backend, FOpenInputSkeletalActionEntry & Entry)
+{
+	if (Entry.bMetadataValid)
+		return true;
+
+	if (!Backend || Entry.ActionHandle == vr::k_ulInvalidActionHandle)
+		return false;
+
+	uint32 BoneCount = 0;
+	vr::EVRInputError InputError = Backend->GetBoneCount(Entry.ActionHandle, BoneCount);
+
+	if (InputError == vr::EVRInputError::VRInputError_InvalidHandle)
+	{
+		InvalidateHandle(Entry);
+		return false;
+	}
+
+	if (InputError != vr::EVRInputError::VRInputError_None || BoneCount < 1)
+		return false;
+
+	Entry.BoneParentIndexes.Reset(BoneCount);
+	Entry.BoneParentIndexes.AddZeroed(BoneCount);
+	InputError = Backend->GetBoneHierarchy(Entry.ActionHandle, Entry.BoneParentIndexes.GetData(), BoneCount);
+
+	if (InputError != vr::EVRInputError::VRInputError_None)
+		return false;
+
+	vr::EVRSkeletalTrackingLevel TrackingLevel;
+	InputError = Backend->GetSkeletalTrackingLevel(Entry.ActionHandle, TrackingLevel);
+
+	if (InputError != vr::EVRInputError::VRInputError_None)
+		return false;
+
+	Entry.BoneCount = BoneCount;
+	Entry.TrackingLevel = (EVROpenInputSkeletalTrackingLevel)TrackingLevel;
+	Entry.bMetadataValid = true;
+	Entry.Serial = NextSerial++;
+	return true;
+}
+
+void FOpenInputSkeletalActionRegistry::NotifyActiveOrigin(FOpenInputSkeletalActionEntry & Entry, vr::VRInputValueHandle_t NewActiveOrigin)
+{
+	if (Entry.ActiveOrigin == NewActiveOrigin)
+		return;
+
+	// First report just records the origin, the metadata was loaded against it
+	if (Entry.ActiveOrigin != vr::k_ulInvalidInputValueHandle)
+	{
+		UE_LOG(OpenInputFunctionLibraryLog, Log, TEXT("Device behind skeletal action %s changed, reloading skeleton data"), *Entry.ActionName);
+		InvalidateMetadata(Entry);
+	}
+
+	Entry.ActiveOrigin = NewActiveOrigin;
+}
+
+void FOpenInputSkeletalActionRegistry::InvalidateHandle(FOpenInputSkeletalActionEntry & Entry)
+{
+	Entry.ActionHandle = vr::k_ulInvalidActionHandle;
+	Entry.ActiveOrigin = vr::k_ulInvalidInputValueHandle;
+	InvalidateMetadata(Entry);
+}
+
+void FOpenInputSkeletalActionRegistry::InvalidateAll()
+{
+	for (FOpenInputSkeletalActionEntry & Entry : Entries)
+	{
+		InvalidateHandle(Entry);
+	}
+}
+
+void FOpenInputSkeletalActionRegistry::PollDeviceChanges(IOpenInputSkeletalBackend * Backend)
+{
+	if (!Backend || LastPollFrame == GFrameCounter)
+		return;
+
+	LastPollFrame = GFrameCounter;
+
+	for (FOpenInputSkeletalActionEntry & Entry : Entries)
+	{
+		if (Entry.ActionHandle == vr::k_ulInvalidActionHandle)
+			continue;
+
+		vr::InputSkeletalActionData_t SkeletalData;
+		vr::EVRInputError InputError = Backend->GetSkeletalActionData(Entry.ActionHandle, SkeletalData);
+
+		if (InputError == vr::EVRInputError::VRInputError_InvalidHandle)
+		{
+			InvalidateHandle(Entry);
+		}
+		else if (InputError == vr::EVRInputError::VRInputError_None && SkeletalData.bActive)
+		{
+			NotifyActiveOrigin(Entry, SkeletalData.activeOrigin);
+		}
+	}
+}
+
+void FOpenInputSkeletalActionRegistry::InvalidateMetadata(FOpenInputSkeletalActionEntry & Entry)
+{
+	bool bWasValid = Entry.bMetadataValid;
+	Entry.bMetadataValid = false;
+
+	if (bWasValid)
+		OnActionChanged.Broadcast(Entry.ActionName);
+}
@@ -0,0 +1,496 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputSkeletalBackend.h"
+#include "Misc/ScopeLock.h"
+
+//=============================================================================
+// OpenVR
+//=============================================================================
+
+#if STEAMVR_SUPPORTED_PLATFORM
+#define OPENINPUT_GET_VRINPUT_OR_RETURN() \
+	vr::IVRInput * VRInput = vr::VRInput(); \
+	if (!VRInput) \
+		return vr::EVRInputError::VRInputError_NoSteam;
+#else
+#define OPENINPUT_GET_VRINPUT_OR_RETURN() \
+	return vr::EVRInputError::VRInputError_NoSteam;
+#endif
+
+bool FOpenInputOpenVRSkeletalBackend::IsAvailable() const
+{
+#if STEAMVR_SUPPORTED_PLATFORM
+	return vr::VRInput() != nullptr;
+#else
+	return false;
+#endif
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetActionHandle(const FString & ActionName, vr::VRActionHandle_t & OutActionHandle)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->GetActionHandle(TCHAR_TO_UTF8(*ActionName), &OutActionHandle);
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetBoneCount(vr::VRActionHandle_t ActionHandle, uint32 & OutBoneCount)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	uint32_t BoneCount = 0;
+	vr::EVRInputError InputError = VRInput->GetBoneCount(ActionHandle, &BoneCount);
+	OutBoneCount = BoneCount;
+	return InputError;
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetSkeletalActionData(vr::VRActionHandle_t ActionHandle, vr::InputSkeletalActionData_t & OutActionData)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->GetSkeletalActionData(ActionHandle, &OutActionData, sizeof(vr::InputSkeletalActionData_t));
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetBoneHierarchy(vr::VRActionHandle_t ActionHandle, vr::BoneIndex_t * OutParentIndices, uint32 IndexCount)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->GetBoneHierarchy(ActionHandle, OutParentIndices, IndexCount);
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetSkeletalTrackingLevel(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalTrackingLevel & OutTrackingLevel)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->GetSkeletalTrackingLevel(ActionHandle, &OutTrackingLevel);
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetSkeletalSummaryData(vr::VRActionHandle_t ActionHandle, vr::VRSkeletalSummaryData_t & OutSummaryData)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->GetSkeletalSummaryData(ActionHandle, vr::EVRSummaryType::VRSummaryType_FromAnimation, &OutSummaryData);
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetSkeletalBoneData(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->GetSkeletalBoneData(ActionHandle, vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Parent, MotionRange, OutTransforms, TransformCount);
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetSkeletalReferenceTransforms(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalReferencePose ReferencePose, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->GetSkeletalReferenceTransforms(ActionHandle, vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Parent, ReferencePose, OutTransforms, TransformCount);
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::GetSkeletalBoneDataCompressed(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, void * OutCompressedData, uint32 CompressedBufferSize, uint32 * OutRequiredCompressedSize)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	uint32_t RequiredSize = 0;
+	vr::EVRInputError InputError = VRInput->GetSkeletalBoneDataCompressed(ActionHandle, MotionRange, OutCompressedData, CompressedBufferSize, &RequiredSize);
+
+	if (OutRequiredCompressedSize)
+		*OutRequiredCompressedSize = RequiredSize;
+
+	return InputError;
+}
+
+vr::EVRInputError FOpenInputOpenVRSkeletalBackend::DecompressSkeletalBoneData(const void * CompressedData, uint32 CompressedSize, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount)
+{
+	OPENINPUT_GET_VRINPUT_OR_RETURN();
+	return VRInput->DecompressSkeletalBoneData(CompressedData, CompressedSize, vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Parent, OutTransforms, TransformCount);
+}
+
+#undef OPENINPUT_GET_VRINPUT_OR_RETURN
+
+//=============================================================================
+// Synthetic / Replay
+//=============================================================================
+
+namespace OpenInputSyntheticStatics
+{
+	// First bone of each finger chain, thumb has one less bone than the others
+	static const uint8 FingerStartBones[vr::VRFinger_Count] =
+	{
+		(uint8)EVROpenInputBones::eBone_Thumb0,
+		(uint8)EVROpenInputBones::eBone_IndexFinger0,
+		(uint8)EVROpenInputBones::eBone_MiddleFinger0,
+		(uint8)EVROpenInputBones::eBone_RingFinger0,
+		(uint8)EVROpenInputBones::eBone_PinkyFinger0
+	};
+
+	// Bone the aux marker copies its transform from
+	static const uint8 AuxSourceBones[vr::VRFinger_Count] =
+	{
+		(uint8)EVROpenInputBones::eBone_Thumb2,
+		(uint8)EVROpenInputBones::eBone_IndexFinger3,
+		(uint8)EVROpenInputBones::eBone_MiddleFinger3,
+		(uint8)EVROpenInputBones::eBone_RingFinger3,
+		(uint8)EVROpenInputBones::eBone_PinkyFinger3
+	};
+
+	// Quantized the way a runtime would pack it so replication sees a blob of a realistic size, a few hundred bytes rather than the raw transforms.
+	// Rotations are smallest three at CompressedRotationBits a component, positions fixed point within +-CompressedPositionRange meters of the parent.
+	static const uint8 CompressedHeaderSize = 2;
+	static const uint8 CompressedMagic = 0x50;
+	static const int32 CompressedRotationBits = 10;
+	static const int32 CompressedPositionBits = 14;
+	static const float CompressedPositionRange = 0.5f;
+	static const int32 CompressedBitsPerBone = 2 + 3 * CompressedRotationBits + 3 * CompressedPositionBits;
+
+	FORCEINLINE uint32 GetCompressedSize(uint32 BoneCount)
+	{
+		return CompressedHeaderSize + ((BoneCount * CompressedBitsPerBone + 7) >> 3);
+	}
+
+	// Bits go straight in and out of the callers buffer so packing never touches the heap
+	struct FCompressedBitWriter
+	{
+		uint8 * Data;
+		uint32 BitPos;
+
+		void Write(uint32 Value, int32 NumBits)
+		{
+			for (int32 i = 0; i < NumBits; ++i, ++BitPos)
+			{
+				const uint8 Mask = (uint8)(1 << (BitPos & 7));
+
+				if (Value & (1u << i))
+					Data[BitPos >> 3] |= Mask;
+				else
+					Data[BitPos >> 3] &= ~Mask;
+			}
+		}
+	};
+
+	struct FCompressedBitReader
+	{
+		const uint8 * Data;
+		uint32 BitPos;
+
+		uint32 Read(int32 NumBits)
+		{
+			uint32 Value = 0;
+
+			for (int32 i = 0; i < NumBits; ++i, ++BitPos)
+			{
+				if (Data[BitPos >> 3] & (1 << (BitPos & 7)))
+					Value |= 1u << i;
+			}
+
+			return Value;
+		}
+	};
+
+	FORCEINLINE uint32 QuantizePosition(float Value)
+	{
+		const float MaxValue = (float)((1 << CompressedPositionBits) - 1);
+		return (uint32)FMath::RoundToInt(FMath::Clamp((Value + CompressedPositionRange) / (2.f * CompressedPositionRange), 0.f, 1.f) * MaxValue);
+	}
+
+	FORCEINLINE float DequantizePosition(uint32 Value)
+	{
+		const float MaxValue = (float)((1 << CompressedPositionBits) - 1);
+		return ((float)Value / MaxValue) * (2.f * CompressedPositionRange) - CompressedPositionRange;
+	}
+
+	FORCEINLINE void SetBone(vr::VRBoneTransform_t & Bone, const FQuat & Rot, const FVector & Pos)
+	{
+		Bone.orientation.w = Rot.W;
+		Bone.orientation.x = Rot.X;
+		Bone.orientation.y = Rot.Y;
+		Bone.orientation.z = Rot.Z;
+		Bone.position.v[0] = Pos.X;
+		Bone.position.v[1] = Pos.Y;
+		Bone.position.v[2] = Pos.Z;
+		Bone.position.v[3] = 1.f;
+	}
+}
+
+FOpenInputSyntheticSkeletalBackend::FOpenInputSyntheticSkeletalBackend()
+{
+	FixedFrameTime = 1.f / 90.f;
+	CurlCycleTime = 2.f;
+	TrackingLevel = EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Partial;
+	ExplicitSampleTime = -1.0;
+	DeviceGeneration = 0;
+}
+
+void FOpenInputSyntheticSkeletalBackend::SetReplayFrames(EVRActionHand Hand, const TArray<FOpenInputSyntheticHandFrame> & Frames)
+{
+	FScopeLock Lock(&SyntheticLock);
+	ReplayFrames[(uint8)Hand] = Frames;
+}
+
+double FOpenInputSyntheticSkeletalBackend::GetSampleTime() const
+{
+	if (ExplicitSampleTime >= 0.0)
+		return ExplicitSampleTime;
+
+	// Off the game thread we are being polled faster than frames advance, follow the clock instead
+	return IsInGameThread() ? (double)GFrameCounter * FixedFrameTime : FPlatformTime::Seconds();
+}
+
+void FOpenInputSyntheticSkeletalBackend::GenerateHandFrame(double SampleTime, float CycleTime, bool bLeftHand, FOpenInputSyntheticHandFrame & OutFrame)
+{
+	using namespace OpenInputSyntheticStatics;
+
+	OutFrame.BoneTransforms.SetNumUninitialized(SyntheticBoneCount, false);
+	vr::VRBoneTransform_t * Bones = OutFrame.BoneTransforms.GetData();
+
+	const double Cycles = SampleTime / FMath::Max(CycleTime, KINDA_SMALL_NUMBER);
+	const float Phase = (float)(Cycles - FMath::FloorToDouble(Cycles)) * 2.f * PI;
+	const float SideSign = bLeftHand ? -1.f : 1.f;
+
+	for (int i = 0; i < vr::VRFinger_Count; ++i)
+	{
+		// Stagger the fingers so that it rolls closed instead of snapping
+		OutFrame.FingerCurls[i] = 0.5f - 0.5f * FMath::Cos(Phase + i * 0.35f);
+	}
+
+	for (int i = 0; i < vr::VRFingerSplay_Count; ++i)
+	{
+		OutFrame.FingerSplays[i] = 0.2f + 0.1f * FMath::Sin(Phase + i);
+	}
+
+	SetBone(Bones[(uint8)EVROpenInputBones::eBone_Root], FQuat::Identity, FVector::ZeroVector);
+	SetBone(Bones[(uint8)EVROpenInputBones::eBone_Wrist], FQuat::Identity, FVector(0.f, 0.f, 0.1f));
+
+	// Lengths of each bone in a finger chain in meters, the last is the tip
+	static const float PhalanxLengths[4] = { 0.045f, 0.040f, 0.025f, 0.020f };
+	static const float MaxFlex[4] = { 0.1f * PI, 0.45f * PI, 0.5f * PI, 0.f };
+
+	for (int Finger = 0; Finger < vr::VRFinger_Count; ++Finger)
+	{
+		const float Curl = OutFrame.FingerCurls[Finger];
+		const float Splay = Finger < vr::VRFingerSplay_Count ? OutFrame.FingerSplays[Finger] : 0.f;
+		const uint8 StartBone = FingerStartBones[Finger];
+
+		// Metacarpal, spread across the palm
+		SetBone(Bones[StartBone], FQuat(FVector::UpVector, SideSign * (Finger - 2) * 0.08f), FVector(0.02f, SideSign * (Finger - 2) * 0.02f, 0.f));
+
+		// Thumb is one bone shorter, it has no metacarpal extension
+		const int ChainLength = (Finger == 0) ? 3 : 4;
+		for (int Link = 0; Link < ChainLength; ++Link)
+		{
+			const int32 PhalanxIndex = (4 - ChainLength) + Link;
+			FQuat LinkRot = FQuat::Identity;
+
+			if (Link == 0)
+				LinkRot = FQuat(FVector::UpVector, SideSign * (Splay - 0.2f) * 0.5f);
+
+			LinkRot = LinkRot * FQuat(FVector::RightVector, -Curl * MaxFlex[PhalanxIndex]);
+			SetBone(Bones[StartBone + 1 + Link], LinkRot, FVector(PhalanxLengths[PhalanxIndex], 0.f, 0.f));
+		}
+	}
+
+	for (int Finger = 0; Finger < vr::VRFinger_Count; ++Finger)
+	{
+		Bones[(uint8)EVROpenInputBones::eBone_Aux_Thumb + Finger] = Bones[AuxSourceBones[Finger]];
+	}
+}
+
+const FOpenInputSyntheticHandFrame & FOpenInputSyntheticSkeletalBackend::GetCurrentFrame(vr::VRActionHandle_t ActionHandle)
+{
+	const bool bLeftHand = IsLeftHandHandle(ActionHandle);
+	const double SampleTime = GetSampleTime();
+	const TArray<FOpenInputSyntheticHandFrame> & HandReplay = ReplayFrames[bLeftHand ? (uint8)EVRActionHand::EActionHand_Left : (uint8)EVRActionHand::EActionHand_Right];
+
+	if (HandReplay.Num())
+	{
+		const int64 FrameIndex = (int64)(SampleTime / FMath::Max(FixedFrameTime, KINDA_SMALL_NUMBER));
+		return HandReplay[FrameIndex % HandReplay.Num()];
+	}
+
+	GenerateHandFrame(SampleTime, CurlCycleTime, bLeftHand, ScratchFrame);
+	return ScratchFrame;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetActionHandle(const FString & ActionName, vr::VRActionHandle_t & OutActionHandle)
+{
+	// The sampling thread polls alongside the game thread
+	FScopeLock Lock(&SyntheticLock);
+
+	int32 Index = ActionNames.IndexOfByKey(ActionName);
+
+	if (Index == INDEX_NONE)
+		Index = ActionNames.Add(ActionName);
+
+	OutActionHandle = (vr::VRActionHandle_t)(Index + 1);
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetBoneCount(vr::VRActionHandle_t ActionHandle, uint32 & OutBoneCount)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	OutBoneCount = SyntheticBoneCount;
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetSkeletalActionData(vr::VRActionHandle_t ActionHandle, vr::InputSkeletalActionData_t & OutActionData)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	OutActionData.bActive = true;
+	OutActionData.activeOrigin = (vr::VRInputValueHandle_t)ActionHandle | ((vr::VRInputValueHandle_t)DeviceGeneration << 32);
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetBoneHierarchy(vr::VRActionHandle_t ActionHandle, vr::BoneIndex_t * OutParentIndices, uint32 IndexCount)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	if (IndexCount != SyntheticBoneCount)
+		return vr::EVRInputError::VRInputError_InvalidBoneCount;
+
+	// The same hierarchy remote hands are rebuilt with
+	const int8 * DefaultParents = UOpenInputFunctionLibrary::GetDefaultBoneParents();
+	for (uint32 i = 0; i < SyntheticBoneCount; ++i)
+	{
+		OutParentIndices[i] = DefaultParents[i];
+	}
+
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetSkeletalTrackingLevel(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalTrackingLevel & OutTrackingLevel)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	OutTrackingLevel = (vr::EVRSkeletalTrackingLevel)TrackingLevel;
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetSkeletalSummaryData(vr::VRActionHandle_t ActionHandle, vr::VRSkeletalSummaryData_t & OutSummaryData)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	const FOpenInputSyntheticHandFrame & Frame = GetCurrentFrame(ActionHandle);
+	FMemory::Memcpy(OutSummaryData.flFingerCurl, Frame.FingerCurls, sizeof(Frame.FingerCurls));
+	FMemory::Memcpy(OutSummaryData.flFingerSplay, Frame.FingerSplays, sizeof(Frame.FingerSplays));
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetSkeletalBoneData(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	const FOpenInputSyntheticHandFrame & Frame = GetCurrentFrame(ActionHandle);
+
+	if (TransformCount != (uint32)Frame.BoneTransforms.Num())
+		return vr::EVRInputError::VRInputError_InvalidBoneCount;
+
+	FMemory::Memcpy(OutTransforms, Frame.BoneTransforms.GetData(), sizeof(vr::VRBoneTransform_t) * TransformCount);
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetSkeletalReferenceTransforms(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalReferencePose ReferencePose, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	if (TransformCount != SyntheticBoneCount)
+		return vr::EVRInputError::VRInputError_InvalidBoneCount;
+
+	// Fist is the closed point of the cycle, everything else is reported as the open hand
+	const double PoseTime = (ReferencePose == vr::EVRSkeletalReferencePose::VRSkeletalReferencePose_Fist) ? CurlCycleTime * 0.5 : 0.0;
+	GenerateHandFrame(PoseTime, CurlCycleTime, IsLeftHandHandle(ActionHandle), ScratchFrame);
+	FMemory::Memcpy(OutTransforms, ScratchFrame.BoneTransforms.GetData(), sizeof(vr::VRBoneTransform_t) * TransformCount);
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::GetSkeletalBoneDataCompressed(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, void * OutCompressedData, uint32 CompressedBufferSize, uint32 * OutRequiredCompressedSize)
+{
+	FScopeLock Lock(&SyntheticLock);
+
+	using namespace OpenInputSyntheticStatics;
+
+	if (!IsValidHandle(ActionHandle))
+		return vr::EVRInputError::VRInputError_InvalidHandle;
+
+	const FOpenInputSyntheticHandFrame & Frame = GetCurrentFrame(ActionHandle);
+
+	const uint32 RequiredSize = GetCompressedSize(Frame.BoneTransforms.Num());
+
+	if (OutRequiredCompressedSize)
+		*OutRequiredCompressedSize = RequiredSize;
+
+	if (CompressedBufferSize < RequiredSize)
+		return vr::EVRInputError::VRInputError_BufferTooSmall;
+
+	uint8 * Out = (uint8*)OutCompressedData;
+	Out[0] = CompressedMagic;
+	Out[1] = (uint8)Frame.BoneTransforms.Num();
+
+	FCompressedBitWriter Bits = { Out + CompressedHeaderSize, 0 };
+	uint16 Components[3];
+	uint8 Largest;
+
+	for (const vr::VRBoneTransform_t & Bone : Frame.BoneTransforms)
+	{
+		FOpenInputQuatCodec::Quantize(FQuat(Bone.orientation.x, Bone.orientation.y, Bone.orientation.z, Bone.orientation.w), CompressedRotationBits, Components, Largest);
+
+		Bits.Write(Largest, 2);
+		for (int32 i = 0; i < 3; ++i)
+			Bits.Write(Components[i], CompressedRotationBits);
+
+		for (int32 i = 0; i < 3; ++i)
+			Bits.Write(QuantizePosition(Bone.position.v[i]), CompressedPositionBits);
+	}
+
+	return vr::EVRInputError::VRInputError_None;
+}
+
+vr::EVRInputError FOpenInputSyntheticSkeletalBackend::DecompressSkeletalBoneData(const void * CompressedData, uint32 CompressedSize, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount)
+{
+	using namespace OpenInputSyntheticStatics;
+
+	const uint8 * In = (const uint8*)CompressedData;
+
+	if (CompressedSize < CompressedHeaderSize || In[0] != CompressedMagic)
+		return vr::EVRInputError::VRInputError_InvalidCompressedData;
+
+	const uint32 BoneCount = In[1];
+	if (CompressedSize != GetCompressedSize(BoneCount))
+		return vr::EVRInputError::VRInputError_InvalidCompressedData;
+
+	if (TransformCount != BoneCount)
+		return vr::EVRInputError::VRInputError_InvalidBoneCount;
+
+	FCompressedBitReader Bits = { In + CompressedHeaderSize, 0 };
+	uint16 Components[3];
+
+	for (uint32 Bone = 0; Bone < BoneCount; ++Bone)
+	{
+		const uint8 Largest = (uint8)Bits.Read(2);
+		for (int32 i = 0; i < 3; ++i)
+			Components[i] = (uint16)Bits.Read(CompressedRotationBits);
+
+		const FQuat Rotation = FOpenInputQuatCodec::Dequantize(Components, Largest, CompressedRotationBits);
+		OutTransforms[Bone].orientation.w = Rotation.W;
+		OutTransforms[Bone].orientation.x = Rotation.X;
+		OutTransforms[Bone].orientation.y = Rotation.Y;
+		OutTransforms[Bone].orientation.z = Rotation.Z;
+
+		for (int32 i = 0; i < 3; ++i)
+			OutTransforms[Bone].position.v[i] = DequantizePosition(Bits.Read(CompressedPositionBits));
+
+		OutTransforms[Bone].position.v[3] = 1.f;
+	}
+
+	return vr::EVRInputError::VRInputError_None;
+}
@@ -1,7 +1,15 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "OpenInputSkeletalMeshComponent.h"
+#include "OpenInputPlugin.h"
+#include "OpenInputLateUpdate.h"
+#include "OpenInputServerGestures.h"
+#include "OpenInputHandLOD.h"
 #include "Net/UnrealNetwork.h"
 #include "MotionControllerComponent.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Serialization/CustomVersion.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 #if USE_WITH_VR_EXPANSION
 #include "GripMotionControllerComponent.h"
@@ -11,6 +19,29 @@
 #include "XRMotionControllerBase.h" // for GetHandEnumForSourceName()
 //#include "EngineMinimal.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Idle Hand Frames Skipped"), STAT_OpenInputIdleFramesSkipped, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Idle Hand Net Sends Skipped"), STAT_OpenInputIdleNetSendsSkipped, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Adaptive Hand Send Bytes"), STAT_OpenInputAdaptiveSendBytes, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Adaptive Hand Sends Unchanged"), STAT_OpenInputAdaptiveSendsUnchanged, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Adaptive Hand Sends Throttled"), STAT_OpenInputAdaptiveSendsThrottled, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim Proxy Pose Copies Skipped"), STAT_OpenInputProxyCopiesSkipped, STATGROUP_OpenInput);
+DECLARE_CYCLE_STAT(TEXT("Async Gesture Detection"), STAT_OpenInputGestureJob, STATGROUP_OpenInput);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gesture Flips Suppressed"), STAT_OpenInputGestureFlipsSuppressed, STATGROUP_OpenInput);
+
+const FGuid FOpenInputGestureDatabaseVersion::GUID(0x6A3E1F27, 0x4C8B4D95, 0x9E02B7D1, 0x5F48C3A6);
+static FCustomVersionRegistration GRegisterOpenInputGestureDatabaseVersion(FOpenInputGestureDatabaseVersion::GUID, FOpenInputGestureDatabaseVersion::LatestVersion, TEXT("OpenInputGestureDatabaseVer"));
+
+// A change that is held back over several frames is only counted the first time
+static void CountSuppressedFlip(FOpenInputGestureHoldState & HoldState)
+{
+	if (HoldState.bPendingCounted)
+		return;
+
+	HoldState.bPendingCounted = true;
+	HoldState.SuppressedFlips++;
+	INC_DWORD_STAT(STAT_OpenInputGestureFlipsSuppressed);
+}
+
 UOpenInputSkeletalMeshComponent::UOpenInputSkeletalMeshComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -18,15 +49,83 @@ UOpenInputSkeletalMeshComponent::UOpenInputSkeletalMeshComponent(const FObjectIn
 	//PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	ReplicationRateForSkeletalAnimations = 10.f;
+	bAdaptiveReplicationRate = false;
+	MaxReplicationRateForSkeletalAnimations = 30.f;
+	AdaptiveFullRateCurlSpeed = 3.f;
+	AdaptiveHeartbeatInterval = 1.f;
+	MaxHandBytesPerSecond = 0;
+	HandBandwidthBudget = 0.f;
+	bUseHandLOD = false;
 	bReplicateSkeletalData = false;
 	bSmoothReplicatedSkeletalData = true;
 	ReplicationType = EVRSkeletalReplicationType::Rep_SteamVRCompressedTransforms;
+	bDeltaCompressHardTransforms = true;
 	bOffsetByControllerProfile = true;
 	SkeletalNetUpdateCount = 0.f;
 	bDetectGestures = true;
+	bAlwaysGetFingerCurlAndSplay = false;
+	bUseClosestGestureMatch = false;
+	bDetectDynamicGestures = false;
+	bDetectGesturesAsync = false;
+	bDetectGesturesOnServer = false;
+	ServerPendingGestureHands = 0;
+	DynamicGestureSampleRate = 30.f;
+	bRecordingDynamicGesture = false;
+	DynamicRecordingHand = EVRActionHand::EActionHand_Right;
+	bLateUpdateFingers = false;
+	LateUpdateSkeletonType = EVROpenVRSkeletonType::OVR_SkeletonType_UE4Default_Right;
+	LateUpdateFrame = MAX_uint64;
+	bSkipIdleHands = false;
+	IdleCurlEpsilon = 0.005f;
+	IdleBoneAngleThreshold = 0.5f;
+	IdleFramesBeforeSkipping = 10;
+	IdleKeyframeInterval = 1.0f;
+	bSkipAnimationWhenIdle = false;
+	bIdlePausedSkeletonUpdate = false;
+	DisabledContextBits = 0;
+	bDisabledContextBitsDirty = true;
+
+	// Late enough that the job has had the rest of the frame to finish
+	GestureEventTickFunction.bCanEverTick = true;
+	GestureEventTickFunction.bStartWithTickEnabled = true;
+	GestureEventTickFunction.bAllowTickOnDedicatedServer = false;
+	GestureEventTickFunction.TickGroup = TG_PostUpdateWork;
+	GestureEventTickFunction.EndTickGroup = TG_PostUpdateWork;
+
 	SetIsReplicatedByDefault(true);
 }
 
+void FOpenInputGestureEventTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && !Target->IsPendingKill())
+	{
+		Target->FinishGestureJob(true);
+	}
+}
+
+FString FOpenInputGestureEventTickFunction::DiagnosticMessage()
+{
+	return Target ? Target->GetFullName() + TEXT("[GestureEventTick]") : TEXT("<NULL>[GestureEventTick]");
+}
+
+void UOpenInputSkeletalMeshComponent::RegisterComponentTickFunctions(bool bRegister)
+{
+	Super::RegisterComponentTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		if (SetupActorComponentTickFunction(&GestureEventTickFunction))
+		{
+			GestureEventTickFunction.Target = this;
+			GestureEventTickFunction.AddPrerequisite(this, PrimaryComponentTick);
+		}
+	}
+	else if (GestureEventTickFunction.IsTickFunctionRegistered())
+	{
+		GestureEventTickFunction.UnRegisterTickFunction();
+	}
+}
+
 void UOpenInputSkeletalMeshComponent::GetLifetimeReplicatedProps(TArray< class FLifetimeProperty > & OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -47,25 +146,38 @@ void UOpenInputSkeletalMeshComponent::Server_SendSkeletalTransforms_Implementati
 
 			FBPSkeletalRepContainer::CopyReplicatedTo(SkeletalInfo, HandSkeletalActions[i]);
 
+			if (i < 32 && (SkeletalInfo.ReplicationType == EVRSkeletalReplicationType::Rep_CurlOnly || SkeletalInfo.ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay))
+				ServerPendingGestureHands |= (1u << i);
+
 			if (HandSkeletalActions[i].CompressedTransforms.Num() > 0)
 			{
-				UOpenInputFunctionLibrary::DecompressSkeletalData(HandSkeletalActions[i], GetWorld());
+				// Needs the SteamVR runtime, which a dedicated server never has, the blob is still relayed to the clients as is
+				if (GetNetMode() != NM_DedicatedServer)
+					UOpenInputFunctionLibrary::DecompressSkeletalData(HandSkeletalActions[i], GetWorld());
+
 				HandSkeletalActions[i].CompressedTransforms.Reset();
 			}
 
 			if (SkeletalInfo.TargetHand == EVRActionHand::EActionHand_Left)
 			{
-				LeftHandRep = SkeletalInfo;
+				LeftHandRep.TakeContentFrom(SkeletalInfo);
+				LeftHandRep.bDeltaCompress = bDeltaCompressHardTransforms;
+				LeftHandRep.SetRotationErrorBudget(HardTransformRotationErrors);
+				LeftHandRep.RepTiers = bUseHandLOD ? HandRepTiers : nullptr;
 				if (bSmoothReplicatedSkeletalData)
-					LeftHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations);
+					LeftHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations, RemotePredictionSettings);
 			}
 			else
 			{
-				RightHandRep = SkeletalInfo;
+				RightHandRep.TakeContentFrom(SkeletalInfo);
+				RightHandRep.bDeltaCompress = bDeltaCompressHardTransforms;
+				RightHandRep.SetRotationErrorBudget(HardTransformRotationErrors);
+				RightHandRep.RepTiers = bUseHandLOD ? HandRepTiers : nullptr;
 				if (bSmoothReplicatedSkeletalData)
-					RightHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations);
+					RightHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations, RemotePredictionSettings);
 			}
 
+			BroadcastNewPose(HandSkeletalActions[i]);
 			break;
 		}
 	}
@@ -128,6 +240,17 @@ void UOpenInputSkeletalMeshComponent::GetCurrentProfileTransform(bool bBindToNot
 }
 
 
+// Everything in the skeletal data except the transforms themselves
+static void CopySkeletalDataSettings(FBPOpenVRActionSkeletalData & To, const FBPOpenVRActionSkeletalData & From)
+{
+	To.TargetHand = From.TargetHand;
+	To.WorldScaleOverride = From.WorldScaleOverride;
+	To.bAllowDeformingMesh = From.bAllowDeformingMesh;
+	To.bMirrorHand = From.bMirrorHand;
+	To.bMirrorLeftRight = From.bMirrorLeftRight;
+	To.AdditionTransform = From.AdditionTransform;
+}
+
 void FOpenInputAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
 {
 	Super::PreUpdate(InAnimInstance, DeltaSeconds);
@@ -137,17 +260,31 @@ void FOpenInputAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float
 		if (HandSkeletalActionData.Num() != OwningMesh->HandSkeletalActions.Num())
 		{
 			HandSkeletalActionData.Empty(OwningMesh->HandSkeletalActions.Num());
+			CopiedPoseSerials.Empty(OwningMesh->HandSkeletalActions.Num());
 			
 			for(FBPOpenVRActionInfo &actionInfo : OwningMesh->HandSkeletalActions)
 			{
 				HandSkeletalActionData.Add(actionInfo.SkeletalData);
+				CopiedPoseSerials.Add(actionInfo.PoseSerial);
 			}
 		}
 		else
 		{
 			for (int i = 0; i < OwningMesh->HandSkeletalActions.Num(); ++i)
 			{
-				HandSkeletalActionData[i] = OwningMesh->HandSkeletalActions[i].SkeletalData;
+				const FBPOpenVRActionInfo & actionInfo = OwningMesh->HandSkeletalActions[i];
+
+				if (CopiedPoseSerials[i] != actionInfo.PoseSerial)
+				{
+					HandSkeletalActionData[i] = actionInfo.SkeletalData;
+					CopiedPoseSerials[i] = actionInfo.PoseSerial;
+				}
+				else
+				{
+					// Same pose as last update (idle hand), the settings can still be changed from blueprint
+					CopySkeletalDataSettings(HandSkeletalActionData[i], actionInfo.SkeletalData);
+					INC_DWORD_STAT(STAT_OpenInputProxyCopiesSkipped);
+				}
 			}
 		}
 	}
@@ -176,6 +313,16 @@ void UOpenInputSkeletalMeshComponent::OnUnregister()
 	Super::OnUnregister();
 }
 
+#if WITH_EDITOR
+void UOpenInputSkeletalMeshComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// DisabledGestureContexts can be edited in the details panel without going through SetGestureContextEnabled
+	bDisabledContextBitsDirty = true;
+}
+#endif
+
 void UOpenInputSkeletalMeshComponent::BeginPlay()
 {
 	if (UMotionControllerComponent * MotionParent = Cast<UMotionControllerComponent>(GetAttachParent()))
@@ -196,14 +343,227 @@ void UOpenInputSkeletalMeshComponent::BeginPlay()
 
 	}
 
+	if (bLateUpdateFingers)
+	{
+		if (FOpenInputLateUpdateViewExtension * LateUpdate = FOpenInputPluginModule::GetLateUpdateExtension())
+			LateUpdate->RegisterComponent(this);
+	}
+
+	// Registered whatever bDetectGesturesOnServer is so that it can be toggled at runtime, the pass skips components with it off
+	const ENetMode NetMode = GetNetMode();
+	if (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer)
+	{
+		if (UOpenInputServerGestureSubsystem * ServerGestures = GetWorld()->GetSubsystem<UOpenInputServerGestureSubsystem>())
+			ServerGestures->RegisterComponent(this);
+
+		// Same for bUseHandLOD, the tiers are only handed to the containers while it is on
+		HandRepTiers = MakeShared<FOpenInputHandRepTiers>();
+		if (UOpenInputHandLODSubsystem * HandLOD = GetWorld()->GetSubsystem<UOpenInputHandLODSubsystem>())
+			HandLOD->RegisterComponent(this);
+	}
+
 	Super::BeginPlay();
 }
 
 void UOpenInputSkeletalMeshComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	if (FOpenInputLateUpdateViewExtension * LateUpdate = FOpenInputPluginModule::GetLateUpdateExtension())
+		LateUpdate->UnregisterComponent(this);
+
+	if (UWorld * World = GetWorld())
+	{
+		if (UOpenInputServerGestureSubsystem * ServerGestures = World->GetSubsystem<UOpenInputServerGestureSubsystem>())
+			ServerGestures->UnregisterComponent(this);
+
+		if (UOpenInputHandLODSubsystem * HandLOD = World->GetSubsystem<UOpenInputHandLODSubsystem>())
+			HandLOD->UnregisterComponent(this);
+	}
+
+	// Nobody should hear about gestures after play has ended
+	FinishGestureJob(false);
+
+	ReleasePoseSubscriptions();
+	UpdateIdleAnimationPause(false);
 	Super::EndPlay(EndPlayReason);
 }
 
+void UOpenInputSkeletalMeshComponent::ReleasePoseSubscriptions()
+{
+	if (FOpenInputPoseSampler * PoseSampler = FOpenInputPluginModule::GetPoseSampler())
+	{
+		for (FOpenInputPoseSubscription & Subscription : PoseSubscriptions)
+		{
+			PoseSampler->Unsubscribe(Subscription);
+		}
+	}
+
+	PoseSubscriptions.Reset();
+}
+
+void UOpenInputSkeletalMeshComponent::SetLateUpdateFingers(bool bNewLateUpdateFingers)
+{
+	bLateUpdateFingers = bNewLateUpdateFingers;
+
+	if (!HasBegunPlay())
+		return;
+
+	if (FOpenInputLateUpdateViewExtension * LateUpdate = FOpenInputPluginModule::GetLateUpdateExtension())
+	{
+		if (bLateUpdateFingers)
+			LateUpdate->RegisterComponent(this);
+		else
+			LateUpdate->UnregisterComponent(this);
+	}
+}
+
+void UOpenInputSkeletalMeshComponent::RefreshLateUpdateBoneMap()
+{
+	if (LateUpdateMappedMesh.Get() == SkeletalMesh && LateUpdateMeshBones.Num() == LateUpdateBoneMappings.BonePairs.Num())
+		return;
+
+	if (!LateUpdateBoneMappings.BonePairs.Num())
+		LateUpdateBoneMappings.ConstructDefaultMappings(LateUpdateSkeletonType, false);
+
+	LateUpdateMappedMesh = SkeletalMesh;
+	LateUpdateMeshBones.Reset(LateUpdateBoneMappings.BonePairs.Num());
+
+	for (const FBPOpenVRSkeletalPair & BonePair : LateUpdateBoneMappings.BonePairs)
+	{
+		LateUpdateMeshBones.Add(GetBoneIndex(BonePair.BoneToTarget));
+	}
+}
+
+// The parent space transform the anim node builds a bones rotation from, the UE4 skeleton folds the metacarpals into the first knuckle
+static FQuat GetLateUpdateSourceRotation(const TArray<FTransform> & SkeletalTransforms, EVROpenInputBones Bone, bool bMergeMissingBonesUE4)
+{
+	uint8 BoneIndex = (uint8)Bone;
+
+	if (bMergeMissingBonesUE4 && (
+		Bone == EVROpenInputBones::eBone_IndexFinger1 ||
+		Bone == EVROpenInputBones::eBone_MiddleFinger1 ||
+		Bone == EVROpenInputBones::eBone_RingFinger1 ||
+		Bone == EVROpenInputBones::eBone_PinkyFinger1))
+	{
+		return (SkeletalTransforms[BoneIndex] * SkeletalTransforms[BoneIndex - 1]).GetRotation();
+	}
+
+	return SkeletalTransforms[BoneIndex].GetRotation();
+}
+
+void UOpenInputSkeletalMeshComponent::ApplyLateUpdate()
+{
+	if (LateUpdateFrame == GFrameCounter)
+		return;
+
+	LateUpdateFrame = GFrameCounter;
+
+	if (!bLateUpdateFingers || !SkeletalMesh || !IsRegistered() || !IsLocallyControlled() || IsRunningParallelEvaluation())
+		return;
+
+	FOpenInputPoseSampler * PoseSampler = FOpenInputPluginModule::GetPoseSampler();
+	if (!PoseSampler || PoseSubscriptions.Num() != HandSkeletalActions.Num())
+		return;
+
+	RefreshLateUpdateBoneMap();
+
+	const FReferenceSkeleton & RefSkeleton = SkeletalMesh->RefSkeleton;
+	const int32 NumMeshBones = BoneSpaceTransforms.Num();
+
+	if (NumMeshBones != RefSkeleton.GetNum() || GetComponentSpaceTransforms().Num() != NumMeshBones)
+		return;
+
+	LateUpdateLocalTransforms = BoneSpaceTransforms;
+	LateUpdateDirtyBones.Init(false, NumMeshBones);
+	int32 FirstPatchedBone = NumMeshBones;
+
+	for (int i = 0; i < HandSkeletalActions.Num(); ++i)
+	{
+		const FBPOpenVRActionInfo & EarlyAction = HandSkeletalActions[i];
+
+		// Same hand selection as the anim node
+		EVRActionHand TargetHand = EarlyAction.SkeletalData.TargetHand;
+		if (EarlyAction.SkeletalData.bMirrorLeftRight)
+			TargetHand = (TargetHand == EVRActionHand::EActionHand_Left) ? EVRActionHand::EActionHand_Right : EVRActionHand::EActionHand_Left;
+
+		// Mirrored hands go through a matrix mirror in the node that the delta below doesn't account for
+		if (TargetHand != LateUpdateBoneMappings.TargetHand || !EarlyAction.bHasValidData || EarlyAction.SkeletalData.bMirrorHand)
+			continue;
+
+		// Null when the late read has nothing the tick didn't, which with OpenVR alone is every frame since it only
+		// updates on the game thread. Only a sampling thread or a backend with newer data gives this anything to do.
+		const FBPOpenVRActionInfo * LateAction = PoseSampler->AcquireLatePose(PoseSubscriptions[i], this);
+		if (!LateAction || LateAction->SampleTime <= EarlyAction.SampleTime)
+			continue;
+
+		const TArray<FTransform> & EarlyTransforms = EarlyAction.SkeletalData.SkeletalTransforms;
+		const TArray<FTransform> * LateTransformsPtr = &LateAction->SkeletalData.SkeletalTransforms;
+
+		// The graph ran on a predicted pose, predict the late one to the same time so the delta is only the new information
+		if (EarlyAction.PredictionSettings.bPredictPose)
+		{
+			FOpenInputPosePredictor::Extrapolate(EarlyAction.PredictionState, EarlyAction.PredictionSettings, *LateTransformsPtr, LateAction->SampleTime, EarlyAction.PredictionState.LastTargetTime, LateUpdatePredictedTransforms);
+			LateTransformsPtr = &LateUpdatePredictedTransforms;
+		}
+
+		const TArray<FTransform> & LateTransforms = *LateTransformsPtr;
+
+		if (EarlyTransforms.Num() != LateTransforms.Num())
+			continue;
+
+		// The node sets each bones local rotation to Addition * Source * Addition^-1, so moving the source from early to late
+		// is the same as post multiplying what the graph produced by Addition^-1 * Early^-1 * Late * Addition
+		const FQuat AdditionQuat = EarlyAction.SkeletalData.AdditionTransform.GetRotation();
+		const FQuat AdditionQuatInv = AdditionQuat.Inverse();
+
+		for (int p = 0; p < LateUpdateBoneMappings.BonePairs.Num(); ++p)
+		{
+			const EVROpenInputBones OpenVRBone = LateUpdateBoneMappings.BonePairs[p].OpenVRBone;
+			const int32 MeshBone = LateUpdateMeshBones[p];
+
+			if (MeshBone == INDEX_NONE || (uint8)OpenVRBone >= EarlyTransforms.Num() || OpenVRBone == EVROpenInputBones::eBone_Root || OpenVRBone == EVROpenInputBones::eBone_Wrist)
+				continue;
+
+			const FQuat EarlyQuat = GetLateUpdateSourceRotation(EarlyTransforms, OpenVRBone, LateUpdateBoneMappings.bMergeMissingBonesUE4);
+			const FQuat LateQuat = GetLateUpdateSourceRotation(LateTransforms, OpenVRBone, LateUpdateBoneMappings.bMergeMissingBonesUE4);
+			const FQuat DeltaQuat = AdditionQuatInv * EarlyQuat.Inverse() * LateQuat * AdditionQuat;
+
+			FTransform & LocalTransform = LateUpdateLocalTransforms[MeshBone];
+			LocalTransform.SetRotation((LocalTransform.GetRotation() * DeltaQuat).GetNormalized());
+			LateUpdateDirtyBones[MeshBone] = true;
+			FirstPatchedBone = FMath::Min(FirstPatchedBone, MeshBone);
+		}
+	}
+
+	if (FirstPatchedBone >= NumMeshBones)
+		return;
+
+	// Patch into a copy of the current pose and flip it in, the untouched bones and the graphs own local pose stay as they were
+	TArray<FTransform> & EditableComponentSpace = GetEditableComponentSpaceTransforms();
+	if (&EditableComponentSpace != &GetComponentSpaceTransforms())
+		EditableComponentSpace = GetComponentSpaceTransforms();
+
+	// Parents always come before children so one pass walks the patched sub trees
+	for (int32 BoneIndex = FirstPatchedBone; BoneIndex < NumMeshBones; ++BoneIndex)
+	{
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+
+		if (ParentIndex != INDEX_NONE && LateUpdateDirtyBones[ParentIndex])
+			LateUpdateDirtyBones[BoneIndex] = true;
+
+		if (LateUpdateDirtyBones[BoneIndex])
+		{
+			EditableComponentSpace[BoneIndex] = (ParentIndex != INDEX_NONE) ?
+				LateUpdateLocalTransforms[BoneIndex] * EditableComponentSpace[ParentIndex] :
+				LateUpdateLocalTransforms[BoneIndex];
+		}
+	}
+
+	// Skip the skeletal mesh side of finalizing, notifies and attachment updates already ran for this frame
+	bNeedToFlipSpaceBaseBuffers = true;
+	USkinnedMeshComponent::FinalizeBoneTransform();
+	MarkRenderDynamicDataDirty();
+}
+
 void UOpenInputSkeletalMeshComponent::Activate(bool bReset)
 {
 	Super::Activate(bReset);
@@ -227,11 +587,11 @@ void UOpenInputSkeletalMeshComponent::TickComponent(float DeltaTime, enum ELevel
 				{
 					if (actionInfo.SkeletalData.TargetHand == EVRActionHand::EActionHand_Left)
 					{
-						LeftHandRepManager.UpdateManager(DeltaTime, actionInfo);
+						LeftHandRepManager.UpdateManager(DeltaTime, actionInfo, RemotePredictionSettings);
 					}
 					else
 					{
-						RightHandRepManager.UpdateManager(DeltaTime, actionInfo);
+						RightHandRepManager.UpdateManager(DeltaTime, actionInfo, RemotePredictionSettings);
 					}
 				}
 			}
@@ -252,200 +612,933 @@ void UOpenInputSkeletalMeshComponent::TickComponent(float DeltaTime, enum ELevel
 		bool bGetCompressedTransforms = false;
 		if (bReplicateSkeletalData && HandSkeletalActions.Num() > 0)
 		{
-			SkeletalNetUpdateCount += DeltaTime;
-			if (SkeletalNetUpdateCount >= (1.0f / ReplicationRateForSkeletalAnimations))
+			if (bAdaptiveReplicationRate)
 			{
-				SkeletalNetUpdateCount = 0.0f;
-				bGetCompressedTransforms = true;
-			}
-		}
+				if (HandSendSchedulers.Num() != HandSkeletalActions.Num())
+				{
+					HandSendSchedulers.Reset();
+					HandSendSchedulers.AddDefaulted(HandSkeletalActions.Num());
+				}
 
-		for (FBPOpenVRActionInfo& actionInfo : HandSkeletalActions)
-		{
-			if (UOpenInputFunctionLibrary::GetActionPose(actionInfo, this, (bGetCompressedTransforms && ReplicationType == EVRSkeletalReplicationType::Rep_SteamVRCompressedTransforms)))
-			{
-				if (bGetCompressedTransforms)
+				// Holds at most a quarter second worth so a quiet stretch can't be spent as one burst
+				if (MaxHandBytesPerSecond > 0)
+					HandBandwidthBudget = FMath::Min(HandBandwidthBudget + MaxHandBytesPerSecond * DeltaTime, MaxHandBytesPerSecond * 0.25f);
+
+				for (FOpenInputHandSendScheduler & Scheduler : HandSendSchedulers)
 				{
-					if (GetNetMode() == NM_Client/* && !IsTornOff()*/)
-					{
-						if (actionInfo.bHasValidData)
-						{
-							FBPSkeletalRepContainer ContainerSend;
-							ContainerSend.CopyForReplication(actionInfo, ReplicationType);
-							Server_SendSkeletalTransforms(ContainerSend);
-						}
-					}
-					else
-					{
-						if (actionInfo.bHasValidData)
-						{
-							if (actionInfo.SkeletalData.TargetHand == EVRActionHand::EActionHand_Left)
-								LeftHandRep.CopyForReplication(actionInfo, ReplicationType);
-							else
-								RightHandRep.CopyForReplication(actionInfo, ReplicationType);
-						}
-					}
+					Scheduler.Advance(DeltaTime, ReplicationRateForSkeletalAnimations, MaxReplicationRateForSkeletalAnimations, AdaptiveFullRateCurlSpeed);
+					bGetCompressedTransforms |= Scheduler.bDue;
 				}
 			}
-
-			if (bDetectGestures && actionInfo.bHasValidData && GesturesDB != nullptr && GesturesDB->Gestures.Num() > 0)
+			else
 			{
-				DetectCurrentPose(actionInfo);
+				SkeletalNetUpdateCount += DeltaTime;
+				if (SkeletalNetUpdateCount >= (1.0f / ReplicationRateForSkeletalAnimations))
+				{
+					SkeletalNetUpdateCount = 0.0f;
+					bGetCompressedTransforms = true;
+				}
 			}
 		}
-	}
-
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-}
 
-void UOpenInputSkeletalMeshComponent::SaveCurrentPose(FName RecordingName, bool bUseFingerCurlOnly, EVRActionHand HandToSave)
-{
+		const EOpenInputPoseProducts Products = GetRequiredPoseProducts(bGetCompressedTransforms);
+		FOpenInputPoseSampler * PoseSampler = FOpenInputPluginModule::GetPoseSampler();
 
-	if (!HandSkeletalActions.Num())
-		return;
+		// Actions can be added / removed from blueprint, re-subscribe if we fall out of sync
+		if (PoseSubscriptions.Num() != HandSkeletalActions.Num())
+		{
+			ReleasePoseSubscriptions();
+			PoseSubscriptions.AddDefaulted(HandSkeletalActions.Num());
+		}
 
-	// Default to the first hand element so that single length arrays work as is.
-	FBPOpenVRActionInfo & HandSkeletalAction = HandSkeletalActions[0];
+		// Normally delivered by GestureEventTickFunction already, it may not have run if ticking was toggled
+		FinishGestureJob(true);
 
-	// Now check for the specific passed in hand if this is a multi hand
-	for (int i = 0; i < HandSkeletalActions.Num(); ++i)
-	{
-		if (HandSkeletalActions[i].SkeletalData.TargetHand == HandToSave)
+		if (IdleHandStates.Num() != HandSkeletalActions.Num())
 		{
-			HandSkeletalAction = HandSkeletalActions[i];
-			break;
+			IdleHandStates.Reset();
+			IdleHandStates.AddDefaulted(HandSkeletalActions.Num());
+			DynamicGestureRecognizers.Reset();
+			DynamicGestureRecognizers.AddDefaulted(HandSkeletalActions.Num());
 		}
-	}
 
-	if (GesturesDB)
-	{
-		FOpenInputGesture NewGesture(bUseFingerCurlOnly);
-
-		int i = 0;
-		for (; i < HandSkeletalAction.PoseFingerData.PoseFingerCurls.Num() && i < NewGesture.FingerValues.Num(); ++i)
-			NewGesture.FingerValues[i].Value = HandSkeletalAction.PoseFingerData.PoseFingerCurls[i];
+		const double CurrentTime = FPlatformTime::Seconds();
+		bool bAllHandsIdle = bSkipIdleHands && HandSkeletalActions.Num() > 0;
 
-		if (!bUseFingerCurlOnly && HandSkeletalAction.PoseFingerData.PoseFingerSplays.Num() > 0)
+		const bool bQueueGestures = bDetectGesturesAsync && GesturesDB != nullptr;
+		if (bQueueGestures)
 		{
-			for (; (i - vr::VRFinger_Count) < HandSkeletalAction.PoseFingerData.PoseFingerSplays.Num() && i < NewGesture.FingerValues.Num(); ++i)
-				NewGesture.FingerValues[i].Value = HandSkeletalAction.PoseFingerData.PoseFingerSplays[i - vr::VRFinger_Count];
+			if (!GestureJob.IsValid())
+				GestureJob = MakeShared<FOpenInputGestureJob, ESPMode::ThreadSafe>();
+
+			GestureJob->Hands.Reset();
 		}
 
-		NewGesture.bUseFingerCurlOnly = bUseFingerCurlOnly;
-		NewGesture.Name = RecordingName;
-		GesturesDB->Gestures.Add(NewGesture);
-	}
-}
+		for (int i = 0; i < HandSkeletalActions.Num(); ++i)
+		{
+			FBPOpenVRActionInfo& actionInfo = HandSkeletalActions[i];
+			FOpenInputIdleHandState& IdleState = IdleHandStates[i];
+			FOpenInputHandSendScheduler * SendScheduler = (bReplicateSkeletalData && bAdaptiveReplicationRate && HandSendSchedulers.IsValidIndex(i)) ? &HandSendSchedulers[i] : nullptr;
 
+			// Idle hands still get a full sample and send every so often so late joiners and lost packets catch up
+			const double TimeSinceSend = CurrentTime - IdleState.LastSendTime;
+			const bool bKeyframeDue = bSkipIdleHands && bGetCompressedTransforms && TimeSinceSend >= IdleKeyframeInterval;
 
-bool UOpenInputSkeletalMeshComponent::K2_DetectCurrentPose(FBPOpenVRActionInfo &SkeletalAction, FOpenInputGesture & GestureOut)
-{
-	if (!GesturesDB || GesturesDB->Gestures.Num() < 1)
-		return false;
+			// Adaptively scheduled hands resend an unchanged packet on their own heartbeat
+			const bool bHeartbeatDue = SendScheduler && bGetCompressedTransforms && TimeSinceSend >= AdaptiveHeartbeatInterval;
 
-	for (const FOpenInputGesture& Gesture : GesturesDB->Gestures)
-	{
-		// If not enough indexs to match curl values, or if this gesture requires finger splay and the controller can't do it
-		if (Gesture.FingerValues.Num() < SkeletalAction.PoseFingerData.PoseFingerCurls.Num() ||
-			(!Gesture.bUseFingerCurlOnly && SkeletalAction.SkeletalTrackingLevel == EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full)
-			)
-			continue;
+			// Set when the hand is still idle, the summary is fresh but the bones are left as they were last converted
+			bool bIdleSkip = false;
 
-		bool bDetectedPose = true;
-		for (int i = 0; i < SkeletalAction.PoseFingerData.PoseFingerCurls.Num(); ++i)
-		{
+			if (bSkipIdleHands && IdleState.bIdle && !bKeyframeDue)
+			{
+				// Only the summary is read, nothing gets converted unless the curls moved
+				const EOpenInputPoseProducts ProbeProducts = EOpenInputPoseProducts::Summary | EOpenInputPoseProducts::TrackingLevel;
+
+				bool bProbed = PoseSampler ?
+					PoseSampler->AcquirePose(PoseSubscriptions[i], actionInfo, this, ProbeProducts) :
+					UOpenInputFunctionLibrary::GetActionPoseProducts(actionInfo, this, ProbeProducts);
+
+				if (bProbed && IdleState.MatchesCurls(actionInfo.PoseFingerData, IdleCurlEpsilon))
+				{
+					INC_DWORD_STAT(STAT_OpenInputIdleFramesSkipped);
+					bIdleSkip = true;
+				}
+				else
+				{
+					IdleState.Wake();
+				}
+			}
+
+			bool bGotPose = !bIdleSkip && (PoseSampler ?
+				PoseSampler->AcquirePose(PoseSubscriptions[i], actionInfo, this, Products) :
+				(Products != EOpenInputPoseProducts::None && UOpenInputFunctionLibrary::GetActionPoseProducts(actionInfo, this, Products)));
 
-			if (!FMath::IsNearlyEqual(SkeletalAction.PoseFingerData.PoseFingerCurls[i], Gesture.FingerValues[i].Value, Gesture.FingerValues[i].Threshold))
+			if (bGotPose && bSkipIdleHands)
 			{
-				bDetectedPose = false;
-				break;
+				IdleState.UpdateStillness(actionInfo, Products, IdleCurlEpsilon, FMath::DegreesToRadians(IdleBoneAngleThreshold), IdleFramesBeforeSkipping);
 			}
-		}
 
-		if (bDetectedPose && !Gesture.bUseFingerCurlOnly && SkeletalAction.PoseFingerData.PoseFingerSplays.Num())
-		{
-			for (int i = 0; i < SkeletalAction.PoseFingerData.PoseFingerSplays.Num() && (i + vr::VRFinger_Count) < Gesture.FingerValues.Num(); ++i)
+			if (SendScheduler && (bIdleSkip || (bGotPose && EnumHasAnyFlags(Products, EOpenInputPoseProducts::Summary))))
 			{
-				if (!FMath::IsNearlyEqual(SkeletalAction.PoseFingerData.PoseFingerCurls[i], Gesture.FingerValues[i + vr::VRFinger_Count].Value, Gesture.FingerValues[i + vr::VRFinger_Count].Threshold))
-				{
-					bDetectedPose = false;
-					break;
-				}
+				SendScheduler->UpdateMotion(actionInfo.PoseFingerData, DeltaTime);
 			}
-		}
 
-		if (bDetectedPose)
-		{
-			GestureOut = Gesture;
-			return true;
-		}
-	}
+			bAllHandsIdle &= IdleState.bIdle;
 
-	return false;
-}
+			if (bGotPose)
+			{
+				// Adaptively scheduled hands go out on their own timing, other than the idle keyframe and their heartbeat
+				if (bGetCompressedTransforms && actionInfo.bHasValidData && (!SendScheduler || SendScheduler->bDue || bKeyframeDue || bHeartbeatDue))
+				{
+					bool bSendPose = true;
 
-bool UOpenInputSkeletalMeshComponent::DetectCurrentPose(FBPOpenVRActionInfo &SkeletalAction)
-{
-	if (!GesturesDB || GesturesDB->Gestures.Num() < 1)
-		return false;
+					if (bSkipIdleHands && !bKeyframeDue)
+					{
+						// The compressed blob is noisy enough that an unchanged hash means nothing moved at all
+						const uint32 CompressedHash = actionInfo.CompressedTransforms.Num() > 0 ? FCrc::MemCrc32(actionInfo.CompressedTransforms.GetData(), actionInfo.CompressedTransforms.Num()) : 0;
+						bSendPose = IdleState.bDirtySinceSend && (CompressedHash == 0 || CompressedHash != IdleState.LastSentCompressedHash);
+					}
 
-	FTransform BoneTransform = FTransform::Identity;
+					if (bSendPose)
+					{
+						const bool bSendRPC = GetNetMode() == NM_Client/* && !IsTornOff()*/;
 
-	for (auto GestureIterator = GesturesDB->Gestures.CreateConstIterator(); GestureIterator; ++GestureIterator)
-	{
-		const FOpenInputGesture &Gesture = *GestureIterator;
+						// The server builds one too when it has to be measured before going out
+						FBPSkeletalRepContainer ContainerSend;
+						if (bSendRPC || SendScheduler)
+						{
+							ContainerSend.CopyForReplication(actionInfo, ReplicationType);
+							ContainerSend.SetRotationErrorBudget(HardTransformRotationErrors);
+						}
 
-		// If not enough indexs to match curl values, or if this gesture requires finger splay and the controller can't do it
-		if (Gesture.FingerValues.Num() < SkeletalAction.PoseFingerData.PoseFingerCurls.Num() ||
-			(!Gesture.bUseFingerCurlOnly && SkeletalAction.SkeletalTrackingLevel == EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full)
-			)
-			continue;
+						if (!SendScheduler || AdmitAdaptiveSend(*SendScheduler, ContainerSend, bKeyframeDue || bHeartbeatDue))
+						{
+							if (bSendRPC)
+							{
+								Server_SendSkeletalTransforms(ContainerSend);
+							}
+							else
+							{
+								FBPSkeletalRepContainer & HandRep = actionInfo.SkeletalData.TargetHand == EVRActionHand::EActionHand_Left ? LeftHandRep : RightHandRep;
+								HandRep.CopyForReplication(actionInfo, ReplicationType);
+								HandRep.bDeltaCompress = bDeltaCompressHardTransforms;
+								HandRep.SetRotationErrorBudget(HardTransformRotationErrors);
+								HandRep.RepTiers = bUseHandLOD ? HandRepTiers : nullptr;
+							}
+
+							IdleState.bDirtySinceSend = false;
+							IdleState.LastSentCompressedHash = actionInfo.CompressedTransforms.Num() > 0 ? FCrc::MemCrc32(actionInfo.CompressedTransforms.GetData(), actionInfo.CompressedTransforms.Num()) : 0;
+							IdleState.LastSendTime = CurrentTime;
+						}
+					}
+					else
+					{
+						INC_DWORD_STAT(STAT_OpenInputIdleNetSendsSkipped);
+					}
+				}
+			}
 
-		bool bDetectedPose = true;
-		for (int i = 0; i < SkeletalAction.PoseFingerData.PoseFingerCurls.Num(); ++i)
-		{
-			if (!FMath::IsNearlyEqual(SkeletalAction.PoseFingerData.PoseFingerCurls[i], Gesture.FingerValues[i].Value, Gesture.FingerValues[i].Threshold))
+			// After replication so that remotes are sent what was actually sampled
+			if (actionInfo.PredictionSettings.bPredictPose && bGotPose && EnumHasAnyFlags(Products, EOpenInputPoseProducts::Bones))
 			{
-				bDetectedPose = false;
-				break;
+				FOpenInputPosePredictor::PredictActionPose(actionInfo, FPlatformTime::Seconds() + actionInfo.PredictionSettings.LeadTime);
 			}
-		}
 
-		if (bDetectedPose && !Gesture.bUseFingerCurlOnly && SkeletalAction.PoseFingerData.PoseFingerSplays.Num())
-		{
-			for (int i = 0; i < SkeletalAction.PoseFingerData.PoseFingerSplays.Num() && (i + vr::VRFinger_Count) < Gesture.FingerValues.Num(); ++i)
+			if ((bGotPose || bIdleSkip) && actionInfo.bHasValidData)
 			{
-				if (!FMath::IsNearlyEqual(SkeletalAction.PoseFingerData.PoseFingerCurls[i], Gesture.FingerValues[i + vr::VRFinger_Count].Value, Gesture.FingerValues[i + vr::VRFinger_Count].Threshold))
-				{
-					bDetectedPose = false;
-					break;
-				}
+				BroadcastNewPose(actionInfo);
 			}
-		}
 
-		if (bDetectedPose)
-		{
-			if (SkeletalAction.LastHandGesture != Gesture.Name)
+			// Gestures only need the curls, so an idle hand keeps detecting and its holds and cooldowns keep running
+
+			const bool bDetectStatic = bDetectGestures && actionInfo.bHasValidData && GesturesDB != nullptr && GesturesDB->GetNumGestures() > 0;
+
+			if (bQueueGestures)
 			{
-				if (SkeletalAction.LastHandGesture != NAME_None)
-					OnGestureEnded.Broadcast(SkeletalAction.LastHandGesture, SkeletalAction.LastHandGestureIndex, SkeletalAction.SkeletalData.TargetHand);
+				// Odd hands need the per gesture loop against the source, which has to stay on the game thread
+				const bool bQueueStatic = bDetectStatic && actionInfo.PoseFingerData.PoseFingerCurls.Num() == vr::VRFinger_Count;
+				if (bDetectStatic && !bQueueStatic)
+				{
+					DetectCurrentPose(actionInfo);
+				}
 
-				SkeletalAction.LastHandGesture = Gesture.Name;
-				SkeletalAction.LastHandGestureIndex = GestureIterator.GetIndex();
-				OnNewGestureDetected.Broadcast(SkeletalAction.LastHandGesture, SkeletalAction.LastHandGestureIndex, SkeletalAction.SkeletalData.TargetHand);
+				const bool bFeedDynamic = bDetectDynamicGestures && actionInfo.bHasValidData &&
+					ConsumeDynamicGestureSample(actionInfo, DynamicGestureRecognizers[i], DeltaTime) && GesturesDB->DynamicGestures.Num() > 0;
 
-				return true;
+				if (bQueueStatic || bFeedDynamic)
+				{
+					FOpenInputGestureJob::FHandInput & Hand = GestureJob->Hands.AddDefaulted_GetRef();
+					Hand.ActionIndex = i;
+					Hand.TargetHand = actionInfo.SkeletalData.TargetHand;
+					Hand.TrackingLevel = actionInfo.SkeletalTrackingLevel;
+					Hand.PoseData = actionInfo.PoseFingerData;
+					Hand.bDetectStatic = bQueueStatic;
+					Hand.bFeedDynamic = bFeedDynamic;
+				}
 			}
 			else
-				return false; // Same gesture
-		}
-	}
-
-	if (SkeletalAction.LastHandGesture != NAME_None)
+			{
+				if (bDetectStatic)
+				{
+					DetectCurrentPose(actionInfo);
+				}
+
+				if (bDetectDynamicGestures && actionInfo.bHasValidData)
+				{
+					DetectDynamicGestures(actionInfo, DynamicGestureRecognizers[i], DeltaTime);
+				}
+			}
+		}
+
+		// Every hand is in, matching overlaps the rest of the frame until GestureEventTickFunction collects it
+		if (bQueueGestures && GestureJob->Hands.Num() > 0)
+		{
+			LaunchGestureJob();
+		}
+
+		UpdateIdleAnimationPause(bAllHandsIdle);
+	}
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+void UOpenInputSkeletalMeshComponent::UpdateIdleAnimationPause(bool bAllHandsIdle)
+{
+	const bool bWantPause = bSkipAnimationWhenIdle && bAllHandsIdle;
+
+	if (bWantPause && !bIdlePausedSkeletonUpdate && !bNoSkeletonUpdate)
+	{
+		bNoSkeletonUpdate = true;
+		bIdlePausedSkeletonUpdate = true;
+	}
+	else if (!bWantPause && bIdlePausedSkeletonUpdate)
+	{
+		bNoSkeletonUpdate = false;
+		bIdlePausedSkeletonUpdate = false;
+	}
+}
+
+float UOpenInputSkeletalMeshComponent::GetAchievedReplicationRate(EVRActionHand TargetHand) const
+{
+	for (int i = 0; i < HandSkeletalActions.Num() && i < HandSendSchedulers.Num(); ++i)
+	{
+		if (HandSkeletalActions[i].SkeletalData.TargetHand == TargetHand)
+			return HandSendSchedulers[i].AchievedRate;
+	}
+
+	return 0.f;
+}
+
+bool UOpenInputSkeletalMeshComponent::AdmitAdaptiveSend(FOpenInputHandSendScheduler & Scheduler, const FBPSkeletalRepContainer & Container, bool bHeartbeat)
+{
+	// Hashed and sized from the container itself, the real send is the only time it gets serialized
+	const uint32 PayloadHash = Container.HashReplicatedContent();
+
+	if (!bHeartbeat && PayloadHash == Scheduler.LastSentPayloadHash)
 	{
-		OnGestureEnded.Broadcast(SkeletalAction.LastHandGesture, SkeletalAction.LastHandGestureIndex, SkeletalAction.SkeletalData.TargetHand);
-		SkeletalAction.LastHandGesture = NAME_None;
-		SkeletalAction.LastHandGestureIndex = INDEX_NONE;
+		INC_DWORD_STAT(STAT_OpenInputAdaptiveSendsUnchanged);
+		return false;
 	}
+
+	// What NetSerialize writes, what the RPC carries and the most the delta compressed property can cost
+	const int32 PacketBytes = (Container.EstimateSerializedBits() + 7) >> 3;
+
+	if (MaxHandBytesPerSecond > 0)
+	{
+		// Allowed to go negative so a packet larger than the budget still goes out, the next ones wait longer
+		if (HandBandwidthBudget <= 0.f)
+		{
+			INC_DWORD_STAT(STAT_OpenInputAdaptiveSendsThrottled);
+			return false;
+		}
+
+		HandBandwidthBudget -= PacketBytes;
+	}
+
+	Scheduler.NotifySent(PayloadHash);
+	INC_DWORD_STAT_BY(STAT_OpenInputAdaptiveSendBytes, PacketBytes);
+	return true;
+}
+
+bool UOpenInputSkeletalMeshComponent::IsHandIdle(EVRActionHand TargetHand) const
+{
+	for (int i = 0; i < HandSkeletalActions.Num() && i < IdleHandStates.Num(); ++i)
+	{
+		if (HandSkeletalActions[i].SkeletalData.TargetHand == TargetHand)
+			return bSkipIdleHands && IdleHandStates[i].bIdle;
+	}
+
 	return false;
 }
+
+EOpenInputPoseProducts UOpenInputSkeletalMeshComponent::GetRequiredPoseProducts(bool bReplicationTick) const
+{
+	EOpenInputPoseProducts Products = EOpenInputPoseProducts::None;
+
+	// Something has to be reading the bones off of us for them to be worth converting
+	if (GetAnimInstance() != nullptr || GetPostProcessInstance() != nullptr || bLateUpdateFingers)
+		Products |= EOpenInputPoseProducts::Bones;
+
+	// Recording gestures into an empty database still needs the curls, idle detection and the adaptive rate watch them too
+	if ((bDetectGestures && GesturesDB != nullptr) || bDetectDynamicGestures || bAlwaysGetFingerCurlAndSplay || bSkipIdleHands || (bReplicateSkeletalData && bAdaptiveReplicationRate))
+		Products |= EOpenInputPoseProducts::Summary | EOpenInputPoseProducts::TrackingLevel;
+
+	if (bReplicateSkeletalData && bReplicationTick)
+	{
+		switch (ReplicationType)
+		{
+		case EVRSkeletalReplicationType::Rep_CurlOnly:
+		case EVRSkeletalReplicationType::Rep_CurlAndSplay:
+		{
+			Products |= EOpenInputPoseProducts::Summary | EOpenInputPoseProducts::TrackingLevel;
+		}break;
+		case EVRSkeletalReplicationType::Rep_HardTransforms:
+		case EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms:
+		{
+			Products |= EOpenInputPoseProducts::Bones;
+		}break;
+		case EVRSkeletalReplicationType::Rep_SteamVRCompressedTransforms:
+		{
+			Products |= EOpenInputPoseProducts::Compressed;
+		}break;
+		}
+	}
+
+	return Products;
+}
+
+void UOpenInputGestureDatabase::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(FOpenInputGestureDatabaseVersion::GUID);
+
+	// Tables go out when cooking, and whenever they are all we have so that duplicating a stripped database keeps its gestures
+	const bool bWriteTables = Ar.IsSaving() && (Ar.IsCooking() || bGesturesStripped);
+	const bool bStripSource = bWriteTables && (bGesturesStripped || bStripGesturesOnCook);
+
+	TSharedPtr<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> Tables;
+	TArray<FOpenInputGesture> AuthoredGestures;
+
+	if (bWriteTables)
+	{
+		if (bGesturesStripped)
+		{
+			Tables = CompiledGestures;
+		}
+		else
+		{
+			// Built fresh so the cook doesn't depend on whether anything has matched against this asset yet
+			Tables = MakeShared<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe>();
+			Tables->Compile(Gestures, bBuildSpatialIndex);
+		}
+
+		if (bStripSource)
+			AuthoredGestures = MoveTemp(Gestures);
+	}
+
+	Super::Serialize(Ar);
+
+	if (bStripSource)
+		Gestures = MoveTemp(AuthoredGestures);
+
+	if (Ar.CustomVer(FOpenInputGestureDatabaseVersion::GUID) < FOpenInputGestureDatabaseVersion::CookedMatchTables)
+		return;
+
+	bool bHasTables = bWriteTables;
+	Ar << bHasTables;
+
+	if (!bHasTables)
+		return;
+
+	bool bSourceStripped = bStripSource;
+	Ar << bSourceStripped;
+
+	if (Ar.IsLoading())
+		Tables = MakeShared<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe>();
+
+	// Names go through the package name table, everything else is one flat blob read in a single go
+	Ar << Tables->Names;
+
+	if (Ar.CustomVer(FOpenInputGestureDatabaseVersion::GUID) >= FOpenInputGestureDatabaseVersion::GestureContexts)
+		Ar << Tables->ContextNames;
+
+	TArray<uint8> Blob;
+	if (Ar.IsSaving())
+	{
+		FMemoryWriter Writer(Blob);
+		Writer.UsingCustomVersion(FOpenInputGestureDatabaseVersion::GUID);
+		Tables->Serialize(Writer);
+	}
+
+	Ar << Blob;
+
+	if (Ar.IsLoading())
+	{
+		// The blob was written at the packages version
+		FMemoryReader Reader(Blob);
+		Reader.SetCustomVersion(FOpenInputGestureDatabaseVersion::GUID, Ar.CustomVer(FOpenInputGestureDatabaseVersion::GUID), TEXT("OpenInputGestureDatabaseVer"));
+		Tables->Serialize(Reader);
+
+		if (!Reader.IsError() && Tables->Names.Num() == Tables->SourceGestureCount && Tables->HoldSettings.Num() == Tables->SourceGestureCount &&
+			Tables->ContextMasks.Num() == Tables->SourceGestureCount && Tables->ContextNames.Num() <= FOpenInputCompiledGestureSet::MaxContexts)
+		{
+			CompiledGestures = Tables;
+			ActiveGestureSets.Reset();
+			bGesturesStripped = bSourceStripped;
+		}
+	}
+}
+
+void UOpenInputGestureDatabase::PostLoad()
+{
+	Super::PostLoad();
+
+	// Cooked packages come with the gesture tables already built, the motion gestures compile on first use
+	if (!CompiledGestures.IsValid())
+		RecompileGestures();
+}
+
+void UOpenInputGestureDatabase::RestoreGestures()
+{
+	if (!bGesturesStripped)
+		return;
+
+	CompiledGestures->ExpandGestures(Gestures);
+	bGesturesStripped = false;
+}
+
+int32 UOpenInputGestureDatabase::GetNumGestures() const
+{
+	return bGesturesStripped ? CompiledGestures->SourceGestureCount : Gestures.Num();
+}
+
+FName UOpenInputGestureDatabase::GetGestureName(int32 GestureIndex) const
+{
+	if (bGesturesStripped)
+		return CompiledGestures->Names.IsValidIndex(GestureIndex) ? CompiledGestures->Names[GestureIndex] : NAME_None;
+
+	return Gestures.IsValidIndex(GestureIndex) ? Gestures[GestureIndex].Name : NAME_None;
+}
+
+bool UOpenInputGestureDatabase::GetGesture(int32 GestureIndex, FOpenInputGesture & GestureOut) const
+{
+	if (bGesturesStripped)
+		return CompiledGestures->ExpandGesture(GestureIndex, GestureOut);
+
+	if (!Gestures.IsValidIndex(GestureIndex))
+		return false;
+
+	GestureOut = Gestures[GestureIndex];
+	return true;
+}
+
+int32 UOpenInputGestureDatabase::MatchGesture(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, bool bClosestMatch, float & OutDistance, const TArray<FName> * DisabledContexts)
+{
+	OutDistance = 0.f;
+
+	// Held for the duration, matching never recompiles but the filtered set may only be referenced from here
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> CompiledPtr = DisabledContexts ? GetSharedActiveGestures(*DisabledContexts) : GetSharedCompiledGestures();
+	return MatchGesture(PoseData, TrackingLevel, bClosestMatch, OutDistance, *CompiledPtr);
+}
+
+int32 UOpenInputGestureDatabase::MatchGesture(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, bool bClosestMatch, float & OutDistance, const FOpenInputCompiledGestureSet & Compiled)
+{
+	OutDistance = 0.f;
+
+	if (bGesturesStripped)
+	{
+		// Without the source there is nothing to run the per gesture loop for odd hands against
+		if (PoseData.PoseFingerCurls.Num() != vr::VRFinger_Count)
+			return INDEX_NONE;
+
+		return bClosestMatch ?
+			Compiled.FindBestMatchCompiled(PoseData, TrackingLevel, Compiled.bHasSpatialIndex, OutDistance) :
+			Compiled.FindFirstMatchCompiled(PoseData, TrackingLevel);
+	}
+
+	return bClosestMatch ?
+		Compiled.FindBestMatch(Gestures, PoseData, TrackingLevel, OutDistance) :
+		Compiled.FindFirstMatch(Gestures, PoseData, TrackingLevel);
+}
+
+#if WITH_EDITOR
+void UOpenInputGestureDatabase::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	RecompileGestures();
+}
+#endif
+
+void UOpenInputGestureDatabase::RecompileGestures()
+{
+	// Always into new sets, an async detection job may still be reading the old ones.
+	// Stripped gestures only exist as tables, there is nothing to rebuild those from.
+	if (!bGesturesStripped)
+	{
+		TSharedPtr<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> NewCompiledGestures = MakeShared<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe>();
+		NewCompiledGestures->Compile(Gestures, bBuildSpatialIndex);
+		CompiledGestures = NewCompiledGestures;
+		ActiveGestureSets.Reset();
+	}
+
+	TSharedPtr<FOpenInputCompiledDynamicGestures, ESPMode::ThreadSafe> NewCompiledDynamicGestures = MakeShared<FOpenInputCompiledDynamicGestures, ESPMode::ThreadSafe>();
+	NewCompiledDynamicGestures->Compile(DynamicGestures);
+	CompiledDynamicGestures = NewCompiledDynamicGestures;
+}
+
+const FOpenInputCompiledDynamicGestures & UOpenInputGestureDatabase::GetCompiledDynamicGestures()
+{
+	return *GetSharedCompiledDynamicGestures();
+}
+
+TSharedPtr<const FOpenInputCompiledDynamicGestures, ESPMode::ThreadSafe> UOpenInputGestureDatabase::GetSharedCompiledDynamicGestures()
+{
+	if (!CompiledDynamicGestures.IsValid() || CompiledDynamicGestures->SourceGestureCount != DynamicGestures.Num())
+		RecompileGestures();
+
+	return CompiledDynamicGestures;
+}
+
+bool UOpenInputGestureDatabase::FindClosestGesture(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, int32 & GestureIndex, float & Distance)
+{
+	GestureIndex = MatchGesture(PoseData, TrackingLevel, true, Distance);
+	return GestureIndex != INDEX_NONE;
+}
+
+const FOpenInputCompiledGestureSet & UOpenInputGestureDatabase::GetCompiledGestures()
+{
+	return *GetSharedCompiledGestures();
+}
+
+TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> UOpenInputGestureDatabase::GetSharedCompiledGestures()
+{
+	// Catches gestures added from blueprint without a recompile, in place edits still need RecompileGestures
+	if (!CompiledGestures.IsValid() || (!bGesturesStripped && CompiledGestures->SourceGestureCount != Gestures.Num()))
+		RecompileGestures();
+
+	return CompiledGestures;
+}
+
+TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> UOpenInputGestureDatabase::GetSharedActiveGestures(const TArray<FName> & DisabledContexts)
+{
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> FullSet = GetSharedCompiledGestures();
+
+	if (DisabledContexts.Num() < 1)
+		return FullSet;
+
+	return GetSharedActiveGestures(FullSet->GetContextBits(DisabledContexts));
+}
+
+TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> UOpenInputGestureDatabase::GetSharedActiveGestures(uint64 DisabledBits)
+{
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> FullSet = GetSharedCompiledGestures();
+
+	if (DisabledBits == 0)
+		return FullSet;
+
+	TSharedPtr<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> & ActiveSet = ActiveGestureSets.FindOrAdd(DisabledBits);
+	if (!ActiveSet.IsValid())
+	{
+		ActiveSet = MakeShared<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe>();
+		ActiveSet->CompileFiltered(*FullSet, DisabledBits);
+	}
+
+	return ActiveSet;
+}
+
+void UOpenInputSkeletalMeshComponent::SaveCurrentPose(FName RecordingName, bool bUseFingerCurlOnly, EVRActionHand HandToSave)
+{
+
+	if (!HandSkeletalActions.Num())
+		return;
+
+	// Default to the first hand element so that single length arrays work as is.
+	FBPOpenVRActionInfo & HandSkeletalAction = HandSkeletalActions[0];
+
+	// Now check for the specific passed in hand if this is a multi hand
+	for (int i = 0; i < HandSkeletalActions.Num(); ++i)
+	{
+		if (HandSkeletalActions[i].SkeletalData.TargetHand == HandToSave)
+		{
+			HandSkeletalAction = HandSkeletalActions[i];
+			break;
+		}
+	}
+
+	if (GesturesDB)
+	{
+		FOpenInputGesture NewGesture(bUseFingerCurlOnly);
+
+		int i = 0;
+		for (; i < HandSkeletalAction.PoseFingerData.PoseFingerCurls.Num() && i < NewGesture.FingerValues.Num(); ++i)
+			NewGesture.FingerValues[i].Value = HandSkeletalAction.PoseFingerData.PoseFingerCurls[i];
+
+		if (!bUseFingerCurlOnly && HandSkeletalAction.PoseFingerData.PoseFingerSplays.Num() > 0)
+		{
+			for (; (i - vr::VRFinger_Count) < HandSkeletalAction.PoseFingerData.PoseFingerSplays.Num() && i < NewGesture.FingerValues.Num(); ++i)
+				NewGesture.FingerValues[i].Value = HandSkeletalAction.PoseFingerData.PoseFingerSplays[i - vr::VRFinger_Count];
+		}
+
+		NewGesture.bUseFingerCurlOnly = bUseFingerCurlOnly;
+		NewGesture.Name = RecordingName;
+		GesturesDB->RestoreGestures();
+		GesturesDB->Gestures.Add(NewGesture);
+		GesturesDB->RecompileGestures();
+	}
+}
+
+
+void UOpenInputSkeletalMeshComponent::StartRecordingDynamicGesture(FName RecordingName, bool bUseFingerCurlOnly, EVRActionHand HandToSave)
+{
+	DynamicRecording = FOpenInputDynamicGesture();
+	DynamicRecording.Name = RecordingName;
+	DynamicRecording.bUseFingerCurlOnly = bUseFingerCurlOnly;
+	DynamicRecordingHand = HandToSave;
+	bRecordingDynamicGesture = true;
+}
+
+bool UOpenInputSkeletalMeshComponent::StopRecordingDynamicGesture()
+{
+	if (!bRecordingDynamicGesture)
+		return false;
+
+	bRecordingDynamicGesture = false;
+
+	if (!GesturesDB || DynamicRecording.Samples.Num() < 2)
+		return false;
+
+	GesturesDB->DynamicGestures.Add(DynamicRecording);
+	GesturesDB->RecompileGestures();
+	return true;
+}
+
+bool UOpenInputSkeletalMeshComponent::ConsumeDynamicGestureSample(const FBPOpenVRActionInfo &SkeletalAction, FOpenInputDynamicGestureRecognizer & Recognizer, float DeltaTime)
+{
+	const float SampleInterval = 1.f / FMath::Max(DynamicGestureSampleRate, 1.f);
+
+	Recognizer.TimeSinceSample += DeltaTime;
+	if (Recognizer.TimeSinceSample < SampleInterval)
+		return false;
+
+	// Long frames still only feed one sample, the warp absorbs the difference
+	Recognizer.TimeSinceSample = FMath::Fmod(Recognizer.TimeSinceSample, SampleInterval);
+
+	if (bRecordingDynamicGesture && SkeletalAction.SkeletalData.TargetHand == DynamicRecordingHand)
+	{
+		DynamicRecording.Samples.Add(SkeletalAction.PoseFingerData);
+	}
+
+	return true;
+}
+
+void UOpenInputSkeletalMeshComponent::DetectDynamicGestures(FBPOpenVRActionInfo &SkeletalAction, FOpenInputDynamicGestureRecognizer & Recognizer, float DeltaTime)
+{
+	if (!ConsumeDynamicGestureSample(SkeletalAction, Recognizer, DeltaTime))
+		return;
+
+	if (!GesturesDB || GesturesDB->DynamicGestures.Num() < 1)
+		return;
+
+	RecognizedDynamicGestures.Reset();
+	Recognizer.AddFrame(GesturesDB->GetCompiledDynamicGestures(), SkeletalAction.PoseFingerData, RecognizedDynamicGestures);
+	BroadcastDynamicGestures(SkeletalAction, RecognizedDynamicGestures);
+}
+
+void UOpenInputSkeletalMeshComponent::BroadcastDynamicGestures(const FBPOpenVRActionInfo &SkeletalAction, const TArray<int32> & GestureIndices)
+{
+	for (int32 GestureIndex : GestureIndices)
+	{
+		// The database can be edited between an async job starting and its results arriving
+		if (!GesturesDB || !GesturesDB->DynamicGestures.IsValidIndex(GestureIndex))
+			continue;
+
+		const FName GestureName = GesturesDB->DynamicGestures[GestureIndex].Name;
+		BroadcastGestureEvent(EOpenInputGestureEventType::Detected, SkeletalAction, GestureName, GestureIndex, true);
+		BroadcastGestureEvent(EOpenInputGestureEventType::Ended, SkeletalAction, GestureName, GestureIndex, true);
+	}
+}
+
+void UOpenInputSkeletalMeshComponent::LaunchGestureJob()
+{
+	check(!GestureJobEvent.IsValid());
+
+	GestureJob->CompiledGestures = GetActiveGestures();
+	GestureJob->CompiledDynamicGestures = GesturesDB->GetSharedCompiledDynamicGestures();
+	GestureJob->bUseClosestMatch = bUseClosestGestureMatch;
+	GestureJob->Recognizers = MoveTemp(DynamicGestureRecognizers);
+
+	// The task keeps its own reference, the component can be destroyed without waiting on it
+	TSharedPtr<FOpenInputGestureJob, ESPMode::ThreadSafe> Job = GestureJob;
+	GestureJobEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([Job]()
+	{
+		Job->Run();
+	}, GET_STATID(STAT_OpenInputGestureJob), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+void UOpenInputSkeletalMeshComponent::FinishGestureJob(bool bDeliverEvents)
+{
+	if (!GestureJobEvent.IsValid())
+		return;
+
+	FTaskGraphInterface::Get().WaitUntilTaskCompletes(GestureJobEvent, ENamedThreads::GameThread);
+	GestureJobEvent = nullptr;
+
+	FOpenInputGestureJob & Job = *GestureJob;
+	DynamicGestureRecognizers = MoveTemp(Job.Recognizers);
+
+	// Let go of the compiled data now rather than holding stale sets until the next launch
+	Job.CompiledGestures.Reset();
+	Job.CompiledDynamicGestures.Reset();
+
+	if (!bDeliverEvents)
+		return;
+
+	// Hands are in HandSkeletalActions order, which is also the order the synchronous path fires in
+	for (int32 i = 0; i < Job.Hands.Num() && i < Job.Results.Num(); ++i)
+	{
+		const FOpenInputGestureJob::FHandInput & Hand = Job.Hands[i];
+
+		// Blueprint may have changed the hands since the job was started
+		if (!HandSkeletalActions.IsValidIndex(Hand.ActionIndex) || HandSkeletalActions[Hand.ActionIndex].SkeletalData.TargetHand != Hand.TargetHand)
+			continue;
+
+		FBPOpenVRActionInfo & SkeletalAction = HandSkeletalActions[Hand.ActionIndex];
+
+		if (Hand.bDetectStatic)
+			ApplyDetectedGesture(SkeletalAction, Job.Results[i].StaticMatch);
+
+		BroadcastDynamicGestures(SkeletalAction, Job.Results[i].DynamicMatches);
+	}
+}
+
+bool UOpenInputSkeletalMeshComponent::K2_DetectCurrentPose(FBPOpenVRActionInfo &SkeletalAction, FOpenInputGesture & GestureOut)
+{
+	const int32 GestureIndex = FindGestureMatch(SkeletalAction);
+
+	return GestureIndex != INDEX_NONE && GesturesDB->GetGesture(GestureIndex, GestureOut);
+}
+
+bool UOpenInputSkeletalMeshComponent::DetectCurrentPose(FBPOpenVRActionInfo &SkeletalAction)
+{
+	if (!GesturesDB || GesturesDB->GetNumGestures() < 1)
+		return false;
+
+	return ApplyDetectedGesture(SkeletalAction, FindGestureMatch(SkeletalAction));
+}
+
+int32 UOpenInputSkeletalMeshComponent::FindGestureMatch(const FBPOpenVRActionInfo &SkeletalAction)
+{
+	if (!GesturesDB || GesturesDB->GetNumGestures() < 1)
+		return INDEX_NONE;
+
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> ActiveGestures = GetActiveGestures();
+	if (!ActiveGestures.IsValid())
+		return INDEX_NONE;
+
+	float Distance = 0.f;
+	return GesturesDB->MatchGesture(SkeletalAction.PoseFingerData, SkeletalAction.SkeletalTrackingLevel, bUseClosestGestureMatch, Distance, *ActiveGestures);
+}
+
+void UOpenInputSkeletalMeshComponent::SetGestureContextEnabled(FName Context, bool bEnabled)
+{
+	if (bEnabled)
+		DisabledGestureContexts.Remove(Context);
+	else
+		DisabledGestureContexts.AddUnique(Context);
+
+	bDisabledContextBitsDirty = true;
+}
+
+bool UOpenInputSkeletalMeshComponent::IsGestureContextEnabled(FName Context) const
+{
+	return !DisabledGestureContexts.Contains(Context);
+}
+
+TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> UOpenInputSkeletalMeshComponent::GetActiveGestures()
+{
+	if (!GesturesDB)
+		return nullptr;
+
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> FullSet = GesturesDB->GetSharedCompiledGestures();
+
+	// Context names only get looked up again once they change or the database swaps in a new compile, which also covers a new database
+	if (bDisabledContextBitsDirty || !DisabledContextBitsSource.HasSameObject(FullSet.Get()))
+	{
+		DisabledContextBits = DisabledGestureContexts.Num() > 0 ? FullSet->GetContextBits(DisabledGestureContexts) : 0;
+		DisabledContextBitsSource = FullSet;
+		bDisabledContextBitsDirty = false;
+	}
+
+	return GesturesDB->GetSharedActiveGestures(DisabledContextBits);
+}
+
+bool UOpenInputSkeletalMeshComponent::ApplyDetectedGesture(FBPOpenVRActionInfo &SkeletalAction, int32 GestureIndex)
+{
+	if (!GesturesDB || GestureIndex >= GesturesDB->GetNumGestures())
+		GestureIndex = INDEX_NONE;
+
+	FName GestureName = GestureIndex != INDEX_NONE ? GesturesDB->GetGestureName(GestureIndex) : NAME_None;
+
+	FOpenInputGestureHoldState & HoldState = SkeletalAction.GestureHoldState;
+
+	if (SkeletalAction.LastHandGesture == GestureName)
+	{
+		// Same gesture, whatever change was pending didn't last
+		HoldState.ClearPending();
+		return false;
+	}
+
+	const double CurrentTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+	bool bSuppressed = false;
+
+	// Each change the matcher reports is timed from when it first showed up, and counted once however long it is held back
+	if (!HoldState.bHasPending || HoldState.PendingGestureIndex != GestureIndex)
+	{
+		HoldState.bHasPending = true;
+		HoldState.bPendingCounted = false;
+		HoldState.PendingGestureIndex = GestureIndex;
+		HoldState.PendingStartTime = CurrentTime;
+	}
+
+	// The active set so that a held gesture whose context was just disabled can't be kept by its exit threshold
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> ActiveGestures = GetActiveGestures();
+	const FOpenInputCompiledGestureSet * Compiled = ActiveGestures.Get();
+
+	// A gesture that just ended can't come straight back, the hand is treated as making no gesture until its cooldown is up
+	if (GestureIndex != INDEX_NONE && GestureIndex == HoldState.CoolingGestureIndex && CurrentTime < HoldState.CooldownEndTime)
+	{
+		GestureIndex = INDEX_NONE;
+		GestureName = NAME_None;
+		bSuppressed = true;
+	}
+
+	// A new gesture has to persist for its own MinHoldTime before it is committed, a single frame near its thresholds isn't detected
+	if (GestureIndex != INDEX_NONE && Compiled && Compiled->HoldSettings.IsValidIndex(GestureIndex) &&
+		(CurrentTime - HoldState.PendingStartTime) < Compiled->HoldSettings[GestureIndex].MinHoldTime)
+	{
+		CountSuppressedFlip(HoldState);
+		return false;
+	}
+
+	// The held gesture has to have been held long enough, and the hand has to have left its widened thresholds
+	if (SkeletalAction.LastHandGesture != NAME_None && Compiled && Compiled->HoldSettings.IsValidIndex(SkeletalAction.LastHandGestureIndex))
+	{
+		const FOpenInputGestureHoldSettings & HeldSettings = Compiled->HoldSettings[SkeletalAction.LastHandGestureIndex];
+
+		if ((CurrentTime - HoldState.CommitTime) < HeldSettings.MinHoldTime ||
+			(HeldSettings.ExitThresholdScale > 1.f && Compiled->IsPoseWithinGesture(SkeletalAction.LastHandGestureIndex, SkeletalAction.PoseFingerData, HeldSettings.ExitThresholdScale)))
+		{
+			CountSuppressedFlip(HoldState);
+			return false;
+		}
+	}
+
+	if (bSuppressed)
+	{
+		CountSuppressedFlip(HoldState);
+
+		if (SkeletalAction.LastHandGesture == NAME_None)
+			return false;
+	}
+
+	if (SkeletalAction.LastHandGesture != NAME_None)
+	{
+		BroadcastGestureEvent(EOpenInputGestureEventType::Ended, SkeletalAction, SkeletalAction.LastHandGesture, SkeletalAction.LastHandGestureIndex, false);
+
+		if (Compiled && Compiled->HoldSettings.IsValidIndex(SkeletalAction.LastHandGestureIndex))
+		{
+			HoldState.CoolingGestureIndex = SkeletalAction.LastHandGestureIndex;
+			HoldState.CooldownEndTime = CurrentTime + Compiled->HoldSettings[SkeletalAction.LastHandGestureIndex].Cooldown;
+		}
+	}
+
+	SkeletalAction.LastHandGesture = GestureName;
+	SkeletalAction.LastHandGestureIndex = GestureIndex;
+	HoldState.CommitTime = CurrentTime;
+	HoldState.ClearPending();
+
+	if (GestureIndex == INDEX_NONE)
+		return false;
+
+	BroadcastGestureEvent(EOpenInputGestureEventType::Detected, SkeletalAction, SkeletalAction.LastHandGesture, SkeletalAction.LastHandGestureIndex, false);
+	return true;
+}
+
+void UOpenInputSkeletalMeshComponent::BroadcastGestureEvent(EOpenInputGestureEventType Type, const FBPOpenVRActionInfo & Hand, FName GestureName, int32 GestureIndex, bool bDynamicGesture)
+{
+	const EVRActionHand TargetHand = Hand.SkeletalData.TargetHand;
+
+	if (OnGestureEventNative.IsBound())
+	{
+		FOpenInputGestureEvent Event;
+		Event.Type = Type;
+		Event.TargetHand = TargetHand;
+		Event.GestureName = GestureName;
+		Event.GestureIndex = GestureIndex;
+		Event.bDynamicGesture = bDynamicGesture;
+		Event.Hand = &Hand;
+		OnGestureEventNative.Broadcast(Event);
+	}
+
+	// Skips building the parameter frame when nothing in blueprint is listening
+	if (Type == EOpenInputGestureEventType::Detected)
+	{
+		if (OnNewGestureDetected.IsBound())
+			OnNewGestureDetected.Broadcast(GestureName, GestureIndex, TargetHand);
+	}
+	else if (OnGestureEnded.IsBound())
+	{
+		OnGestureEnded.Broadcast(GestureName, GestureIndex, TargetHand);
+	}
+}
+
+int32 UOpenInputSkeletalMeshComponent::GetSuppressedGestureFlips(EVRActionHand TargetHand) const
+{
+	for (const FBPOpenVRActionInfo & SkeletalAction : HandSkeletalActions)
+	{
+		if (SkeletalAction.SkeletalData.TargetHand == TargetHand)
+			return (int32)SkeletalAction.GestureHoldState.SuppressedFlips;
+	}
+
+	return 0;
+}
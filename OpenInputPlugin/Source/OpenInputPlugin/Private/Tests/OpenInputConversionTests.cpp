@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputFunctionLibrary.h"
+#include "OpenInputSkeletalBackend.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOpenInputBoneConversionTest, "OpenInput.Conversion.BatchMatchesScalar",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FOpenInputBoneConversionTest::RunTest(const FString & Parameters)
+{
+	// Poses across the open / close cycle, both hands, timed separately by vr.OpenInput.BenchmarkBoneConversion
+	const double SampleTimes[] = { 0.0, 0.37, 0.81, 1.5 };
+	const float WorldToMeters[] = { 100.f, 37.5f };
+
+	FOpenInputSyntheticHandFrame Frame;
+	TArray<FTransform> ScalarOut, VectorOut;
+	int32 Mismatches = 0;
+	int32 Conversions = 0;
+
+	for (double SampleTime : SampleTimes)
+	{
+		for (int32 Hand = 0; Hand < 2; ++Hand)
+		{
+			FOpenInputSyntheticSkeletalBackend::GenerateHandFrame(SampleTime, 2.f, Hand != 0, Frame);
+			const int32 BoneCount = Frame.BoneTransforms.Num();
+
+			for (float Scale : WorldToMeters)
+			{
+				for (int32 Mirror = 0; Mirror < 2; ++Mirror)
+				{
+					// Every prefix length so the batch path's remainder handling is covered as well as full batches
+					for (int32 Count = 1; Count <= BoneCount; ++Count)
+					{
+						ScalarOut.Reset(Count);
+						ScalarOut.AddDefaulted(Count);
+						VectorOut.Reset(Count);
+						VectorOut.AddDefaulted(Count);
+
+						UOpenInputFunctionLibrary::CONVERT_STEAMTRANS_TO_FTRANS_BATCH_Scalar(Frame.BoneTransforms.GetData(), ScalarOut.GetData(), Count, Scale, Mirror != 0);
+						UOpenInputFunctionLibrary::CONVERT_STEAMTRANS_TO_FTRANS_BATCH(Frame.BoneTransforms.GetData(), VectorOut.GetData(), Count, Scale, Mirror != 0);
+
+						for (int32 i = 0; i < Count; ++i)
+						{
+							if (!ScalarOut[i].Equals(VectorOut[i], 0.f))
+							{
+								if (Mismatches == 0)
+								{
+									AddError(FString::Printf(TEXT("Bone %d of %d differs (time %.2f, %s, scale %.1f, %s): scalar %s, batch %s"), i, Count, SampleTime,
+										Hand ? TEXT("left") : TEXT("right"), Scale, Mirror ? TEXT("mirrored") : TEXT("unmirrored"), *ScalarOut[i].ToString(), *VectorOut[i].ToString()));
+								}
+
+								++Mismatches;
+							}
+						}
+
+						++Conversions;
+					}
+				}
+			}
+		}
+	}
+
+	TestTrue(TEXT("Conversions ran"), Conversions > 0);
+	TestEqual(TEXT("Bones where the batch conversion differs from the scalar one"), Mismatches, 0);
+
+	return true;
+}
+
+#endif
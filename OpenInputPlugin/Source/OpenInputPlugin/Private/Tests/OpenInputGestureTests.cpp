@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputGestureMatcher.h"
+#include "OpenInputSkeletalMeshComponent.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOpenInputGestureIndexTest, "OpenInput.Gestures.CompiledMatchesLinear",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FOpenInputGestureIndexTest::RunTest(const FString & Parameters)
+{
+	// The same spread vr.OpenInput.BenchmarkGestureIndex times, one in four gestures records splays
+	const int32 DatabaseSizes[] = { 10, 100, 1000, 10000 };
+	const int32 NumQueries = 1000;
+	const EVROpenInputSkeletalTrackingLevel TrackingLevel = EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Partial;
+
+	FRandomStream Stream(0x4f49);
+	TArray<FOpenInputGesture> Gestures;
+
+	for (int32 NumGestures : DatabaseSizes)
+	{
+		Gestures.Reset(NumGestures);
+
+		for (int32 i = 0; i < NumGestures; ++i)
+		{
+			FOpenInputGesture Gesture(Stream.FRand() < 0.75f);
+
+			for (FOpenInputGestureFingerPosition & FingerValue : Gesture.FingerValues)
+			{
+				FingerValue.Value = Stream.FRand();
+				FingerValue.Threshold = Stream.FRandRange(0.05f, 0.15f);
+			}
+
+			Gestures.Add(Gesture);
+		}
+
+		FOpenInputCompiledGestureSet Compiled;
+		Compiled.Compile(Gestures, true);
+
+		int32 FirstMismatches = 0;
+		int32 BestMismatches = 0;
+		int32 Matched = 0;
+
+		for (int32 i = 0; i < NumQueries; ++i)
+		{
+			// Perturbed copies of database entries so most queries land inside a gesture or two
+			const FOpenInputGesture & Source = Gestures[Stream.RandHelper(NumGestures)];
+			FBPOpenVRGesturePoseData Query;
+
+			for (int32 Finger = 0; Finger < vr::VRFinger_Count; ++Finger)
+				Query.PoseFingerCurls.Add(FMath::Clamp(Source.FingerValues[Finger].Value + Stream.FRandRange(-0.1f, 0.1f), 0.f, 1.f));
+
+			for (int32 Splay = 0; Splay < vr::VRFingerSplay_Count; ++Splay)
+				Query.PoseFingerSplays.Add(Stream.FRand());
+
+			const int32 FirstMatch = Compiled.FindFirstMatch(Gestures, Query, TrackingLevel);
+			FirstMismatches += FirstMatch != FOpenInputCompiledGestureSet::FindFirstMatchScalar(Gestures, Query, TrackingLevel);
+
+			float LinearDistance = 0.f;
+			float IndexedDistance = 0.f;
+			const int32 LinearMatch = Compiled.FindBestMatchLinear(Gestures, Query, TrackingLevel, LinearDistance);
+			const int32 IndexedMatch = Compiled.FindBestMatch(Gestures, Query, TrackingLevel, IndexedDistance);
+
+			BestMismatches += IndexedMatch != LinearMatch || (LinearMatch != INDEX_NONE && !FMath::IsNearlyEqual(IndexedDistance, LinearDistance, KINDA_SMALL_NUMBER));
+			Matched += LinearMatch != INDEX_NONE;
+		}
+
+		TestEqual(FString::Printf(TEXT("%d gestures, compiled first match disagreements with the scalar loop"), NumGestures), FirstMismatches, 0);
+		TestEqual(FString::Printf(TEXT("%d gestures, spatial index closest match disagreements with the linear scan"), NumGestures), BestMismatches, 0);
+
+		// A run where nothing matches wouldn't be comparing anything
+		TestTrue(FString::Printf(TEXT("%d gestures, queries matched something"), NumGestures), Matched > 0);
+	}
+
+	return true;
+}
+
+#endif
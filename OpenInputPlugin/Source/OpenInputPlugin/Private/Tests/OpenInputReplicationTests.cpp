@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputFunctionLibrary.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/CoreNet.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOpenInputQuatCodecRoundTripTest, "OpenInput.Replication.QuatCodecRoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FOpenInputQuatCodecRoundTripTest::RunTest(const FString & Parameters)
+{
+	FRandomStream Random(0x0E1A);
+
+	// Wrist, metacarpals and phalanges at different widths so a narrow class follows a wide one in the same packet
+	const uint8 MixedBits[(uint8)EOpenInputHandBoneClass::Count] = { 11, 9, 8 };
+	const int32 NumBones = (uint8)EVROpenInputBones::eBone_Count - 11;
+
+	FBPSkeletalRepContainer Source;
+	Source.ReplicationType = EVRSkeletalReplicationType::Rep_HardTransforms;
+	Source.bAllowDeformingMesh = false;
+	FMemory::Memcpy(Source.RotationBits, MixedBits, sizeof(MixedBits));
+
+	for (int32 Bone = 0; Bone < NumBones; ++Bone)
+	{
+		Source.SkeletalTransforms.Add(FTransform(FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI))));
+	}
+
+	FNetBitWriter Writer(nullptr, 0);
+	bool bSuccess = true;
+	Source.NetSerialize(Writer, nullptr, bSuccess);
+	TestTrue(TEXT("Serialized"), bSuccess);
+
+	FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+	FBPSkeletalRepContainer Received;
+	Received.NetSerialize(Reader, nullptr, bSuccess);
+	TestTrue(TEXT("Deserialized"), bSuccess && !Reader.IsError());
+
+	if (!TestEqual(TEXT("Bone count"), Received.SkeletalTransforms.Num(), NumBones))
+		return false;
+
+	for (int32 Bone = 0; Bone < NumBones; ++Bone)
+	{
+		const int32 Bits = MixedBits[(uint8)FOpenInputQuatCodec::GetRepBoneClass(Bone)];
+
+		// Exactly what the sender quantized to, anything else means bits leaked between bones
+		uint16 Expected[3];
+		uint8 ExpectedLargest = 0;
+		FOpenInputQuatCodec::Quantize(Source.SkeletalTransforms[Bone].GetRotation(), Bits, Expected, ExpectedLargest);
+		const FQuat ExpectedRotation = FOpenInputQuatCodec::Dequantize(Expected, ExpectedLargest, Bits);
+
+		TestTrue(FString::Printf(TEXT("Bone %d decodes to the sent value"), Bone), Received.SkeletalTransforms[Bone].GetRotation().Equals(ExpectedRotation, KINDA_SMALL_NUMBER));
+	}
+
+	// The codec on its own, read over components holding every bit set
+	for (int32 Bits = FOpenInputQuatCodec::MinBits; Bits <= FOpenInputQuatCodec::MaxBits; ++Bits)
+	{
+		uint16 Sent[3];
+		uint8 SentLargest = 0;
+		FOpenInputQuatCodec::Quantize(FQuat(Random.GetUnitVector(), Random.FRandRange(-PI, PI)), Bits, Sent, SentLargest);
+
+		FNetBitWriter CodecWriter(nullptr, 0);
+		FOpenInputQuatCodec::Serialize(CodecWriter, Sent, SentLargest, Bits);
+
+		uint16 Read[3] = { MAX_uint16, MAX_uint16, MAX_uint16 };
+		uint8 ReadLargest = MAX_uint8;
+		FNetBitReader CodecReader(nullptr, CodecWriter.GetData(), CodecWriter.GetNumBits());
+		FOpenInputQuatCodec::Serialize(CodecReader, Read, ReadLargest, Bits);
+
+		TestTrue(FString::Printf(TEXT("%d bit components round trip"), Bits), FMemory::Memcmp(Sent, Read, sizeof(Sent)) == 0 && SentLargest == ReadLargest);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "OpenInputFunctionLibrary.h"
+#include "OpenInputPlugin.h"
+#include "OpenInputPoseSampler.h"
+#include "OpenInputSkeletalBackend.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/Optional.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Allocations made by this thread while inside an FOpenInputScopedAllocationCount
+static thread_local int32 GOpenInputCountingDepth = 0;
+static thread_local int32 GOpenInputCountedAllocations = 0;
+
+// Layered over GMalloc the first time a count is taken and left there, it is never swapped back out from under other threads.
+// Outside of a scope it only forwards.
+class FOpenInputCountingMalloc : public FMalloc
+{
+public:
+
+	explicit FOpenInputCountingMalloc(FMalloc * InInner) : Inner(InInner) {}
+
+	static void InstallOnce()
+	{
+		static FOpenInputCountingMalloc * Installed = nullptr;
+
+		if (!Installed)
+		{
+			Installed = new FOpenInputCountingMalloc(GMalloc);
+			GMalloc = Installed;
+		}
+	}
+
+	virtual void * Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		CountAllocation();
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void * Realloc(void * Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0)
+			CountAllocation();
+
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void * Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void * Original, SIZE_T & SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual const TCHAR * GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+private:
+
+	FMalloc * Inner;
+
+	static void CountAllocation()
+	{
+		if (GOpenInputCountingDepth > 0)
+			++GOpenInputCountedAllocations;
+	}
+};
+
+// Counts the heap allocations the current thread makes while in scope, other threads allocating at the same time aren't seen
+class FOpenInputScopedAllocationCount
+{
+public:
+
+	FOpenInputScopedAllocationCount()
+	{
+		FOpenInputCountingMalloc::InstallOnce();
+		StartCount = GOpenInputCountedAllocations;
+		++GOpenInputCountingDepth;
+	}
+
+	~FOpenInputScopedAllocationCount()
+	{
+		--GOpenInputCountingDepth;
+	}
+
+	int32 GetAllocations() const { return GOpenInputCountedAllocations - StartCount; }
+
+private:
+
+	int32 StartCount;
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOpenInputPosePathAllocationTest, "OpenInput.Sampling.ZeroSteadyStateAllocations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FOpenInputPosePathAllocationTest::RunTest(const FString & Parameters)
+{
+	FOpenInputPluginModule * Module = FOpenInputPluginModule::Get();
+	FOpenInputPoseSampler * PoseSampler = FOpenInputPluginModule::GetPoseSampler();
+
+	if (!TestNotNull(TEXT("Plugin module"), Module) || !TestNotNull(TEXT("Pose sampler"), PoseSampler) || !Module->GetSyntheticSkeletalBackend())
+		return false;
+
+	IOpenInputSkeletalBackend * PreviousBackend = FOpenInputPluginModule::GetSkeletalBackend();
+	FOpenInputSyntheticSkeletalBackend * Synthetic = Module->GetSyntheticSkeletalBackend();
+	Module->SetActiveSkeletalBackend(Synthetic);
+
+	// Decompression only needs a world for its scale
+	UWorld * World = GWorld;
+	if (!World)
+		AddWarning(TEXT("No world to decompress against, only covering the local path"));
+
+	FBPOpenVRActionInfo Local;
+	Local.SkeletalData.TargetHand = EVRActionHand::EActionHand_Right;
+
+	FBPOpenVRActionInfo Remote = Local;
+	FBPOpenVRActionInfo Consumer = Local;
+	FOpenInputPoseSubscription Subscription = PoseSampler->Subscribe(Consumer, nullptr);
+
+	const EOpenInputPoseProducts ConsumerProducts = EOpenInputPoseProducts::Bones | EOpenInputPoseProducts::Summary | EOpenInputPoseProducts::Compressed;
+	const int32 WarmUpFrames = 8;
+	const int32 MeasuredFrames = 64;
+
+	TOptional<FOpenInputScopedAllocationCount> AllocationCount;
+	int32 Allocations = 0;
+	bool bAllSucceeded = true;
+
+	for (int32 Frame = 0; Frame < WarmUpFrames + MeasuredFrames; ++Frame)
+	{
+		if (Frame == WarmUpFrames)
+			AllocationCount.Emplace();
+
+		// A new pose each pass, the way a running hand would give one
+		Synthetic->SetSampleTime(Frame * 0.011);
+
+		bAllSucceeded &= UOpenInputFunctionLibrary::GetActionPose(Local, nullptr, true, true);
+
+		if (World)
+		{
+			// What the remote end of replication gets handed
+			Remote.BoneCount = Local.BoneCount;
+			Remote.CompressedTransforms.SetNumUninitialized(Local.CompressedTransforms.Num(), false);
+			FMemory::Memcpy(Remote.CompressedTransforms.GetData(), Local.CompressedTransforms.GetData(), Local.CompressedTransforms.Num());
+			bAllSucceeded &= UOpenInputFunctionLibrary::DecompressSkeletalData(Remote, World);
+		}
+
+		bAllSucceeded &= PoseSampler->AcquirePose(Subscription, Consumer, nullptr, ConsumerProducts);
+	}
+
+	if (AllocationCount.IsSet())
+	{
+		Allocations = AllocationCount->GetAllocations();
+		AllocationCount.Reset();
+	}
+
+	PoseSampler->Unsubscribe(Subscription);
+	Synthetic->SetSampleTime(-1.0);
+	Module->SetActiveSkeletalBackend(PreviousBackend);
+
+	TestTrue(TEXT("Every pose read succeeded"), bAllSucceeded);
+	TestEqual(TEXT("Heap allocations after warm up"), Allocations, 0);
+
+	return true;
+}
+
+#endif
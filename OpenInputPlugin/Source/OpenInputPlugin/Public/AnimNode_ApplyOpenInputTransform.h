@@ -247,10 +247,11 @@ public:
 
 		if (BoneIndex >= 0)
 		{
+			// Walk up the parents rather than recursing, deep chains were costing a call per bone
 			BoneTransform = RefBones[BoneIndex];
-			if (RefBonesInfo[BoneIndex].ParentIndex >= 0)
+			for (int32 ParentIndex = RefBonesInfo[BoneIndex].ParentIndex; ParentIndex >= 0; ParentIndex = RefBonesInfo[ParentIndex].ParentIndex)
 			{
-				BoneTransform *= GetRefBoneInCS(RefBones, RefBonesInfo, RefBonesInfo[BoneIndex].ParentIndex);
+				BoneTransform *= RefBones[ParentIndex];
 			}
 		}
 
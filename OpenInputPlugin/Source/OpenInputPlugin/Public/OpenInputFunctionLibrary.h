@@ -22,6 +22,26 @@
 #include "openvr.h"
 #endif // STEAMVR_SUPPORTED_PLATFORM
 
+DECLARE_LOG_CATEGORY_EXTERN(OpenInputFunctionLibraryLog, Log, All);
+DECLARE_STATS_GROUP(TEXT("OpenInput"), STATGROUP_OpenInput, STATCAT_Advanced);
+
+struct FOpenInputRawPoseSample;
+
+// The separate pieces of a skeletal action a pose read can fetch, each one not asked for is a runtime call skipped
+enum class EOpenInputPoseProducts : uint8
+{
+	None = 0,
+	// Parent space bone transforms
+	Bones = 1 << 0,
+	// Finger curl / splay summary
+	Summary = 1 << 1,
+	// The runtimes own compressed bone blob, for replication
+	Compressed = 1 << 2,
+	// Tracking level and skeleton metadata, cached in the registry so it only costs the active check
+	TrackingLevel = 1 << 3
+};
+ENUM_CLASS_FLAGS(EOpenInputPoseProducts);
+
 #include "OpenInputFunctionLibrary.generated.h"
 
 namespace OpenInputFunctionLibraryStatics
@@ -202,7 +222,135 @@ enum class EVRSkeletalReplicationType : uint8
 	/*Replicate the given transforms, this is more costly than any other method, I suggest NOT having bAllowDeformingMesh enabled with this active*/
 	Rep_HardTransforms,
 	/*Replicates using the built in SteamVR compression technique, this cannot be used cross platform but is the best choice when you know everyone will be launch with steamVR*/
-	Rep_SteamVRCompressedTransforms
+	Rep_SteamVRCompressedTransforms,
+	/*Replicates the whole hand with the plugins own codec, smaller than the SteamVR blob and decodable anywhere including servers and clients without SteamVR.
+	Rotations are sent to the HardTransformRotationErrors budget, tip and aux bones are rebuilt on the receiver*/
+	Rep_OpenInputCompressedTransforms
+};
+
+// Pushes each bone along the rate it is currently turning at so the hand lines up with display time rather than sample time
+USTRUCT(BlueprintType, Category = "VRExpansionFunctions|SteamVR|HandSkeleton")
+struct OPENINPUTPLUGIN_API FBPOpenVRPosePredictionSettings
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default)
+		bool bPredictPose;
+
+	// Seconds past the current time to predict to, roughly how long until the frame reaches the display
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "0.1"))
+		float LeadTime;
+
+	// Never extrapolate further than this many seconds past the sample, covers hitches and late packets
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "0.25"))
+		float MaxLeadTime;
+
+	// Largest rotation in degrees that any one bone can be moved past its sampled pose
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "90.0"))
+		float MaxBoneAngle;
+
+	// How much of each new velocity estimate is taken in (0 - 1), lower is steadier but slower to react
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.01", ClampMax = "1.0", UIMin = "0.01", UIMax = "1.0"))
+		float VelocitySmoothing;
+
+	FBPOpenVRPosePredictionSettings()
+	{
+		bPredictPose = false;
+		LeadTime = 0.02f;
+		MaxLeadTime = 0.1f;
+		MaxBoneAngle = 20.f;
+		VelocitySmoothing = 0.5f;
+	}
+};
+
+// Per bone rotation history for FOpenInputPosePredictor, kept apart from OldSkeletalTransforms as those end up holding predicted poses
+struct OPENINPUTPLUGIN_API FOpenInputPosePredictionState
+{
+	// Parent space rotations as last sampled, not predicted
+	TArray<FQuat> LastRotations;
+
+	// Rotation axis scaled by radians per second, parent space
+	TArray<FVector> AngularVelocities;
+
+	double LastSampleTime;
+
+	// The time the most recent prediction targeted, lets later readers of the same frame match it
+	double LastTargetTime;
+
+	FOpenInputPosePredictionState()
+	{
+		LastSampleTime = 0.0;
+		LastTargetTime = 0.0;
+	}
+
+	void Reset()
+	{
+		LastRotations.Reset();
+		AngularVelocities.Reset();
+		LastSampleTime = 0.0;
+		LastTargetTime = 0.0;
+	}
+};
+
+// Model and world space versions of an actions pose, built on request and kept until the pose changes
+struct OPENINPUTPLUGIN_API FOpenInputBoneSpaceCache
+{
+	TArray<FTransform> ComponentSpaceTransforms;
+	TArray<FTransform> WorldSpaceTransforms;
+	FTransform WorldSpaceBase;
+
+	// The action PoseSerial each array was built from, 0 is never valid
+	uint32 ComponentSpaceSerial;
+	uint32 WorldSpaceSerial;
+
+	// Scratch for resolving hierarchies that aren't parent first
+	TBitArray<> ResolvedBones;
+
+	FOpenInputBoneSpaceCache()
+	{
+		ComponentSpaceSerial = 0;
+		WorldSpaceSerial = 0;
+	}
+};
+
+// Decides when a hand is allowed to change its current gesture, see the hold and cooldown settings on FOpenInputGesture
+struct OPENINPUTPLUGIN_API FOpenInputGestureHoldState
+{
+	// World time the current gesture was committed at
+	double CommitTime;
+
+	// The gesture that last ended, it can't be detected again until CooldownEndTime
+	int32 CoolingGestureIndex;
+	double CooldownEndTime;
+
+	// The change the matcher is reporting that hasn't been committed yet, and the world time it first showed up at
+	bool bHasPending;
+	bool bPendingCounted;
+	int32 PendingGestureIndex;
+	double PendingStartTime;
+
+	// Changes the matcher reported that were held back, each counted once however many frames it lasted
+	uint32 SuppressedFlips;
+
+	FOpenInputGestureHoldState()
+	{
+		CommitTime = 0.0;
+		CoolingGestureIndex = INDEX_NONE;
+		CooldownEndTime = 0.0;
+		bHasPending = false;
+		bPendingCounted = false;
+		PendingGestureIndex = INDEX_NONE;
+		PendingStartTime = 0.0;
+		SuppressedFlips = 0;
+	}
+
+	void ClearPending()
+	{
+		bHasPending = false;
+		bPendingCounted = false;
+		PendingGestureIndex = INDEX_NONE;
+	}
 };
 
 USTRUCT(BlueprintType, Category = "VRExpansionFunctions|SteamVR|HandSkeleton")
@@ -234,6 +382,32 @@ public:
 	UPROPERTY(BlueprintReadOnly, NotReplicated, Transient, Category = Default)
 		TArray<FTransform> OldSkeletalTransforms;
 
+	// Local hands only, remote ones use the owning components settings
+	UPROPERTY(EditAnywhere, NotReplicated, BlueprintReadWrite, Category = Default)
+		FBPOpenVRPosePredictionSettings PredictionSettings;
+
+	FOpenInputPosePredictionState PredictionState;
+
+	// FPlatformTime::Seconds() of when the current skeletal transforms were taken from the runtime
+	double SampleTime;
+
+	// Bumped by everything that writes SkeletalTransforms, the space caches rebuild when it moves
+	uint32 PoseSerial;
+	mutable FOpenInputBoneSpaceCache BoneSpaceCache;
+
+	FORCEINLINE void NotifyPoseChanged()
+	{
+		// Skip 0, it marks an empty cache
+		if (++PoseSerial == 0)
+			PoseSerial = 1;
+	}
+
+	// Bones relative to the skeleton root, built at most once per pose
+	const TArray<FTransform> & GetComponentSpaceTransforms() const;
+
+	// Component space bones placed under ComponentToWorld, rebuilt only for a new pose or a moved base
+	const TArray<FTransform> & GetWorldSpaceTransforms(const FTransform & ComponentToWorld) const;
+
 	UPROPERTY(BlueprintReadOnly, NotReplicated, Transient, Category = Default)
 		bool bHasValidData;
 
@@ -242,8 +416,14 @@ public:
 		EVROpenInputSkeletalTrackingLevel SkeletalTrackingLevel;
 
 	FBPOpenVRActionHandle ActionHandleContainer;
+
+	// Slot in the module action registry and the metadata serial last copied from it
+	int32 RegistryIndex;
+	uint32 RegistrySerial;
+
 	FName LastHandGesture;
 	int32 LastHandGestureIndex;
+	FOpenInputGestureHoldState GestureHoldState;
 
 	UPROPERTY()
 	TArray<uint8> CompressedTransforms;
@@ -262,9 +442,149 @@ public:
 		bGetSkeletalTransforms_WithController = false;
 		LastHandGestureIndex = INDEX_NONE;
 		LastHandGesture = NAME_None;
+		RegistryIndex = INDEX_NONE;
+		RegistrySerial = 0;
+		SampleTime = 0.0;
+		PoseSerial = 1;
 	}
 };
 
+// Groups of the bones Rep_HardTransforms sends, each gets its own rotation precision
+enum class EOpenInputHandBoneClass : uint8
+{
+	Wrist,
+	Metacarpal,
+	Phalanx,
+	Count
+};
+
+// Largest rotation error in degrees Rep_HardTransforms may add to each group of bones, sets how many bits their rotations are sent with.
+// Errors at the wrist move the whole hand, out at the finger joints they are barely visible.
+USTRUCT(BlueprintType, Category = "VRExpansionFunctions|SteamVR|HandSkeleton")
+struct OPENINPUTPLUGIN_API FBPOpenInputRotationErrorBudget
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.005", UIMin = "0.05", UIMax = "5.0"))
+		float WristMaxError;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.005", UIMin = "0.05", UIMax = "5.0"))
+		float MetacarpalMaxError;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.005", UIMin = "0.05", UIMax = "5.0"))
+		float PhalanxMaxError;
+
+	FBPOpenInputRotationErrorBudget()
+	{
+		WristMaxError = 0.1f;
+		MetacarpalMaxError = 0.5f;
+		PhalanxMaxError = 1.f;
+	}
+
+	// Bits per quaternion component for each EOpenInputHandBoneClass
+	void GetComponentBits(uint8 * OutBits) const;
+};
+
+// Smallest three quaternion quantization. The largest component is dropped and rebuilt from the other three,
+// which lie within +-1/sqrt(2) and are sent with a fixed number of bits each, so a rotation is always 2 + 3 * Bits bits.
+struct OPENINPUTPLUGIN_API FOpenInputQuatCodec
+{
+	static const int32 MinBits = 4;
+	static const int32 MaxBits = 16;
+
+	// Fewest bits per component that keep the rotation within MaxErrorDegrees of the original
+	static int32 GetBitsForMaxError(float MaxErrorDegrees);
+
+	static void Quantize(const FQuat & Rotation, int32 Bits, uint16 * OutComponents, uint8 & OutLargest);
+	static FQuat Dequantize(const uint16 * Components, uint8 Largest, int32 Bits);
+
+	static void Serialize(FArchive & Ar, uint16 * Components, uint8 & Largest, int32 Bits);
+
+	// Which group a bone in a containers SkeletalTransforms is budgeted as
+	static EOpenInputHandBoneClass GetRepBoneClass(int32 RepBoneIndex);
+};
+
+// A Rep_HardTransforms / Rep_OpenInputCompressedTransforms hand as delta compression sends it, both ends rebuild from these exact values so deltas never drift
+struct OPENINPUTPLUGIN_API FOpenInputQuantizedHandPose
+{
+	// Positions are kept in steps of 1 / PositionScale, the same precision as the full format
+	static const int32 PositionScale = 10;
+
+	uint16 Sequence;
+	bool bAllowDeformingMesh;
+
+	// Sent as Rep_OpenInputCompressedTransforms, the receiver rebuilds the tip and aux bones
+	bool bOpenInputCompressed;
+
+	// Component bits per bone class the rotations were quantized with
+	uint8 RotationBits[(uint8)EOpenInputHandBoneClass::Count];
+
+	// The three smallest quaternion components per bone and which one was dropped, as FOpenInputQuatCodec gives them
+	TArray<uint16> Rotations;
+	TArray<uint8> LargestComponents;
+
+	// Three per bone when deforming, empty otherwise
+	TArray<int32> Positions;
+
+	FOpenInputQuantizedHandPose()
+	{
+		Sequence = 0;
+		bAllowDeformingMesh = false;
+		bOpenInputCompressed = false;
+		FMemory::Memzero(RotationBits);
+	}
+
+	int32 GetNumBones() const
+	{
+		return LargestComponents.Num();
+	}
+
+	bool HasSameLayout(const FOpenInputQuantizedHandPose & Other) const
+	{
+		return bAllowDeformingMesh == Other.bAllowDeformingMesh && bOpenInputCompressed == Other.bOpenInputCompressed && LargestComponents.Num() == Other.LargestComponents.Num() &&
+			Positions.Num() == Other.Positions.Num() && FMemory::Memcmp(RotationBits, Other.RotationBits, sizeof(RotationBits)) == 0;
+	}
+
+	bool HasSameValues(const FOpenInputQuantizedHandPose & Other) const
+	{
+		return HasSameLayout(Other) && Rotations == Other.Rotations && LargestComponents == Other.LargestComponents && Positions == Other.Positions;
+	}
+};
+
+// How much of a hand a receiving connection is sent, picked per connection by UOpenInputHandLODSubsystem
+UENUM(BlueprintType)
+enum class EOpenInputHandRepTier : uint8
+{
+	// The hand as the components ReplicationType sends it
+	Tier_Full,
+	// Curl hands as they are at the full rate. Nothing builds bones from curls on receivers, so transform hands
+	// are sent in full at the low rate instead.
+	Tier_CurlAndSplay,
+	// Only the curls at the low rate, transform hands in full at the low rate
+	Tier_CurlOnly,
+	// Nothing at all
+	Tier_None
+};
+
+// Every receiving connections tier for one component, shared by both of its hands
+struct OPENINPUTPLUGIN_API FOpenInputHandRepTiers
+{
+	// Weak so a connection freed and reallocated at the same address between LOD passes can't pick up another clients tier
+	TMap<TWeakObjectPtr<const class UNetConnection>, EOpenInputHandRepTier> ConnectionTiers;
+
+	// Seconds between sends to connections at Tier_CurlOnly, or below Tier_Full for transform hands
+	float LowRateInterval;
+
+	FOpenInputHandRepTiers()
+	{
+		LowRateInterval = 0.5f;
+	}
+
+	// Connections the LOD pass hasn't seen yet, replays included, get the hand in full
+	EOpenInputHandRepTier GetTier(const class UNetConnection * Connection) const;
+};
+
 USTRUCT(BlueprintType, Category = "VRExpansionFunctions|SteamVR|HandSkeleton")
 struct OPENINPUTPLUGIN_API FBPSkeletalRepContainer
 {
@@ -292,6 +612,33 @@ public:
 	UPROPERTY(Transient, NotReplicated)
 		TArray<uint8> CompressedTransforms;
 
+	// Bits per quaternion component transforms are sent with for each EOpenInputHandBoneClass, travels in the packet
+	uint8 RotationBits[(uint8)EOpenInputHandBoneClass::Count];
+
+	// As a replicated property, send Rep_HardTransforms / Rep_OpenInputCompressedTransforms as the bones that changed since the pose each connection last acknowledged.
+	// RPCs have nothing to delta against and always go out in full through NetSerialize.
+	UPROPERTY(Transient, NotReplicated)
+		bool bDeltaCompress;
+
+	// Server side, the fidelity each receiving connection gets this container at, everyone gets it in full when unset
+	TSharedPtr<const FOpenInputHandRepTiers> RepTiers;
+
+	// Receive side, the last poses decoded so a delta against any the sender may still think we have can be applied
+	static const int32 ReceivedPoseHistorySize = 16;
+	TArray<FOpenInputQuantizedHandPose> ReceivedPoses;
+	int32 ReceivedPoseHead;
+
+	// Server side, bumped whenever the content is replaced, 0 is never valid
+	uint32 ContentSerial;
+
+	// Server side, the sequence the last delta compressed pose of this container went out with and the ContentSerial it named.
+	// Per container so it only moves when this hands pose does, however many hands and connections there are.
+	uint16 PoseSequence;
+	uint32 SequencedSerial;
+
+	// Receive side, set when the last update was a delta against a pose no longer in ReceivedPoses.
+	// Nothing else in the container was touched, it still holds the previous pose and should not be treated as new.
+	bool bStaleDelta;
 
 	FBPSkeletalRepContainer()
 	{
@@ -299,6 +646,39 @@ public:
 		ReplicationType = EVRSkeletalReplicationType::Rep_CurlAndSplay;
 		bAllowDeformingMesh = false;
 		BoneCount = 0;
+		bDeltaCompress = false;
+		ReceivedPoseHead = 0;
+		bStaleDelta = false;
+		ContentSerial = 1;
+		PoseSequence = 0;
+		SequencedSerial = 0;
+		FBPOpenInputRotationErrorBudget().GetComponentBits(RotationBits);
+	}
+
+	void MarkContentChanged()
+	{
+		if (++ContentSerial == 0)
+			ContentSerial = 1;
+	}
+
+	// Server side, takes on what a client sent up while keeping this containers send state counting on from where it was
+	void TakeContentFrom(const FBPSkeletalRepContainer & Other)
+	{
+		const uint32 PreviousSerial = ContentSerial;
+		const uint16 PreviousSequence = PoseSequence;
+		const uint32 PreviousSequencedSerial = SequencedSerial;
+
+		*this = Other;
+
+		ContentSerial = PreviousSerial;
+		PoseSequence = PreviousSequence;
+		SequencedSerial = PreviousSequencedSerial;
+		MarkContentChanged();
+	}
+
+	void SetRotationErrorBudget(const FBPOpenInputRotationErrorBudget & Budget)
+	{
+		Budget.GetComponentBits(RotationBits);
 	}
 
 	bool bHasValidData()
@@ -308,6 +688,7 @@ public:
 
 	void CopyForReplication(FBPOpenVRActionInfo& Other, EVRSkeletalReplicationType RepType)
 	{
+		MarkContentChanged();
 		TargetHand = Other.SkeletalData.TargetHand;
 		ReplicationType = RepType;
 
@@ -323,6 +704,7 @@ public:
 		}break;
 
 		case EVRSkeletalReplicationType::Rep_HardTransforms:
+		case EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms:
 		{
 			bAllowDeformingMesh = Other.SkeletalData.bAllowDeformingMesh;
 
@@ -376,6 +758,9 @@ public:
 
 	static void CopyReplicatedTo(const FBPSkeletalRepContainer & Container, FBPOpenVRActionInfo& Other)
 	{
+		if (Container.bStaleDelta)
+			return;
+
 		switch (Container.ReplicationType)
 		{
 		case EVRSkeletalReplicationType::Rep_CurlOnly:
@@ -386,6 +771,7 @@ public:
 		}break;
 
 		case EVRSkeletalReplicationType::Rep_HardTransforms:
+		case EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms:
 		{
 			if (Container.SkeletalTransforms.Num() < ((uint8)EVROpenInputBones::eBone_Count - 11))
 			{
@@ -431,21 +817,30 @@ public:
 			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger2] = Container.SkeletalTransforms[18];
 			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger3] = Container.SkeletalTransforms[19];
 
+			if (Container.ReplicationType == EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms)
+			{
+				// Only the bones that carry animation were sent, the rest are rebuilt from them
+				DeriveUnsentBones(Other.SkeletalData.SkeletalTransforms);
+			}
+			else
+			{
+				// These are "tip" bones and serve no animation purpose, we need to project them from the last bone forward by a set amount.
+				// For now I am just setting to the last bone until I finalize things.
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Thumb3] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Thumb2];// Need to project this from last joint
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_IndexFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_IndexFinger3];// Need to project this from last joint
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_MiddleFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_MiddleFinger3];// Need to project this from last joint
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_RingFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_RingFinger3];// Need to project this from last joint
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger3];// Need to project this from last joint
+
+				// These are copied from the 3rd joints as they use the same transform but a different root
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_Thumb] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Thumb2];
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_IndexFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_IndexFinger3];
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_MiddleFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_MiddleFinger3];
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_RingFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_RingFinger3];
+				Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_PinkyFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger3];
+			}
 
-			// These are "tip" bones and serve no animation purpose, we need to project them from the last bone forward by a set amount.
-			// For now I am just setting to the last bone until I finalize things.
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Thumb3] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Thumb2];// Need to project this from last joint
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_IndexFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_IndexFinger3];// Need to project this from last joint
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_MiddleFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_MiddleFinger3];// Need to project this from last joint
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_RingFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_RingFinger3];// Need to project this from last joint
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger4] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger3];// Need to project this from last joint
-
-			// These are copied from the 3rd joints as they use the same transform but a different root
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_Thumb] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Thumb2];
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_IndexFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_IndexFinger3];
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_MiddleFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_MiddleFinger3];
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_RingFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_RingFinger3];
-			Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_PinkyFinger] = Other.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger3];
+			Other.NotifyPoseChanged();
 			Other.bHasValidData = true;
 		}break;
 
@@ -459,60 +854,67 @@ public:
 		}
 	}
 
-	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	// Curls, and splays if asked for, as the curl replication types send them
+	void SerializeFingerSummary(FArchive& Ar, bool bWithSplays, bool& bOutSuccess)
 	{
-		bOutSuccess = true;
-
-		Ar.SerializeBits(&TargetHand, 1);
-		Ar.SerializeBits(&ReplicationType, 2);
+		bool bHasCurlData = PoseFingerData.PoseFingerCurls.Num() > 0;
+		Ar.SerializeBits(&bHasCurlData, 1);
 
-		switch (ReplicationType)
-		{
-		case EVRSkeletalReplicationType::Rep_CurlOnly:
-		case EVRSkeletalReplicationType::Rep_CurlAndSplay:
+		if (bHasCurlData)
 		{
+			int NumFingers = PoseFingerData.PoseFingerCurls.Num();
+			Ar.SerializeBits(&NumFingers, 8);
 
-			bool bHasCurlData = PoseFingerData.PoseFingerCurls.Num() > 0;
-			Ar.SerializeBits(&bHasCurlData, 1);
+			if (PoseFingerData.PoseFingerCurls.Num() < NumFingers)
+			{
+				PoseFingerData.PoseFingerCurls.Reset(NumFingers);
+				PoseFingerData.PoseFingerCurls.AddUninitialized(NumFingers);
+			}
 
-			if (bHasCurlData)
+			for (int i = 0; i < NumFingers; i++)
 			{
-				int NumFingers = PoseFingerData.PoseFingerCurls.Num();
-				Ar.SerializeBits(&NumFingers, 8);
+				bOutSuccess &= WriteFixedCompressedFloat<1, 16>(PoseFingerData.PoseFingerCurls[i], Ar);
+			}
 
-				if (PoseFingerData.PoseFingerCurls.Num() < NumFingers)
-				{
-					PoseFingerData.PoseFingerCurls.Reset(NumFingers);
-					PoseFingerData.PoseFingerCurls.AddUninitialized(NumFingers);
-				}
+			if (bWithSplays)
+			{
+				int NumSplays = PoseFingerData.PoseFingerSplays.Num();
+				Ar.SerializeBits(&NumSplays, 8);
 
-				for (int i = 0; i < NumFingers; i++)
+				if (PoseFingerData.PoseFingerSplays.Num() < NumSplays)
 				{
-					bOutSuccess &= WriteFixedCompressedFloat<1, 16>(PoseFingerData.PoseFingerCurls[i], Ar);
+					PoseFingerData.PoseFingerSplays.Reset(NumSplays);
+					PoseFingerData.PoseFingerSplays.AddUninitialized(NumSplays);
 				}
 
-				if (ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay)
+				for (int i = 0; i < NumSplays; i++)
 				{
-					int NumSplays = PoseFingerData.PoseFingerSplays.Num();
-					Ar.SerializeBits(&NumSplays, 8);
-
-					if (PoseFingerData.PoseFingerSplays.Num() < NumSplays)
-					{
-						PoseFingerData.PoseFingerSplays.Reset(NumSplays);
-						PoseFingerData.PoseFingerSplays.AddUninitialized(NumSplays);
-					}
-
-					for (int i = 0; i < NumSplays; i++)
-					{
-						bOutSuccess &= WriteFixedCompressedFloat<1, 16>(PoseFingerData.PoseFingerSplays[i], Ar);
-					}
+					bOutSuccess &= WriteFixedCompressedFloat<1, 16>(PoseFingerData.PoseFingerSplays[i], Ar);
 				}
 			}
+		}
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		bOutSuccess = true;
+
+		Ar.SerializeBits(&TargetHand, 1);
+		Ar.SerializeBits(&ReplicationType, 3);
+
+		switch (ReplicationType)
+		{
+		case EVRSkeletalReplicationType::Rep_CurlOnly:
+		case EVRSkeletalReplicationType::Rep_CurlAndSplay:
+		{
+
+			SerializeFingerSummary(Ar, ReplicationType == EVRSkeletalReplicationType::Rep_CurlAndSplay, bOutSuccess);
 
 			//PoseFingerData.NetSerialize(Ar, Map, bOutSuccess);
 		}break;
 
 		case EVRSkeletalReplicationType::Rep_HardTransforms:
+		case EVRSkeletalReplicationType::Rep_OpenInputCompressedTransforms:
 		{
 			//Ar.SerializeBits(SkeletalTrackingLevel, 2);
 			Ar.SerializeBits(&bAllowDeformingMesh, 1);
@@ -521,31 +923,44 @@ public:
 
 			Ar << TransformCount;
 
+			// Sent as bits - 1 so all of MinBits to MaxBits fit
+			for (int i = 0; i < (uint8)EOpenInputHandBoneClass::Count; i++)
+			{
+				uint8 BitsMinusOne = FMath::Clamp<uint8>(RotationBits[i], FOpenInputQuatCodec::MinBits, FOpenInputQuatCodec::MaxBits) - 1;
+				Ar.SerializeBits(&BitsMinusOne, 4);
+				RotationBits[i] = FMath::Max<uint8>(BitsMinusOne + 1, FOpenInputQuatCodec::MinBits);
+			}
+
 			if (Ar.IsLoading())
 			{
 				SkeletalTransforms.Reset(TransformCount);
 			}
 
 			FVector Position = FVector::ZeroVector;
-			FRotator Rot = FRotator::ZeroRotator;
+			uint16 Components[3] = { 0, 0, 0 };
+			uint8 Largest = 0;
 
 			for (int i = 0; i < TransformCount; i++)
 			{
+				const int32 Bits = RotationBits[(uint8)FOpenInputQuatCodec::GetRepBoneClass(i)];
+
 				if (Ar.IsSaving())
 				{
 					if (bAllowDeformingMesh)
 						Position = SkeletalTransforms[i].GetLocation();
 
-					Rot = SkeletalTransforms[i].Rotator();
+					FOpenInputQuatCodec::Quantize(SkeletalTransforms[i].GetRotation(), Bits, Components, Largest);
 				}
 
 				if (bAllowDeformingMesh)
 					bOutSuccess &= SerializePackedVector<10, 11>(Position, Ar);
 
-				Rot.SerializeCompressed(Ar); // Short? 10 bit?
+				FOpenInputQuatCodec::Serialize(Ar, Components, Largest, Bits);
 
 				if (Ar.IsLoading())
 				{
+					const FQuat Rot = FOpenInputQuatCodec::Dequantize(Components, Largest, Bits);
+
 					if (bAllowDeformingMesh)
 						SkeletalTransforms.Add(FTransform(Rot, Position));
 					else
@@ -564,6 +979,19 @@ public:
 
 		return bOutSuccess;
 	}
+
+	// Fills in the tip and aux bones of a full hand from the replicated ones, which must already be in place
+	static void DeriveUnsentBones(TArray<FTransform> & Transforms);
+
+	// What NetSerialize would write worked out from the replication type and counts without writing it, packed positions are counted at their largest
+	int32 EstimateSerializedBits() const;
+
+	// Hash of the content NetSerialize sends for the current replication type, equal hashes send the same packet
+	uint32 HashReplicatedContent() const;
+
+	// Property replication, unchanged containers aren't resent and delta compressed hard transforms are keyed to each connections baseline.
+	// Everything else is written exactly as NetSerialize writes it.
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo & DeltaParms);
 };
 
 template<>
@@ -571,7 +999,8 @@ struct TStructOpsTypeTraits< FBPSkeletalRepContainer > : public TStructOpsTypeTr
 {
 	enum
 	{
-		WithNetSerializer = true
+		WithNetSerializer = true,
+		WithNetDeltaSerializer = true
 	};
 };
 
@@ -587,6 +1016,12 @@ public:
 	~UOpenInputFunctionLibrary();
 public:
 
+	// Action name used when an action info leaves its name empty
+	static const FString & GetDefaultSkeletalActionName(EVRActionHand TargetHand);
+
+	// Parent of each EVROpenInputBones bone in the OpenVR hand skeleton (eBone_Count entries, -1 for the root)
+	static const int8 * GetDefaultBoneParents();
+
 	/** Converts a FBPOpenInputActioInfo into a FBPSkeletalRepContainer */
 	UFUNCTION(BlueprintCallable, Category = "OpenInputReplication")
 	static void FillRepContainerFromActionInfo(UPARAM(ref) FBPOpenVRActionInfo& ActionInfo, UPARAM(ref) FBPSkeletalRepContainer & TargetRepContainer, EVRSkeletalReplicationType ReplicationType)
@@ -617,6 +1052,36 @@ public:
 		return FTransform::Identity;
 	}
 
+	// Every bone of the action relative to the skeleton root, cached on the action until its pose changes
+	UFUNCTION(BlueprintCallable, Category = "OpenInputFunctions|SteamVR")
+	static void GetOpenVRComponentSpaceTransforms(UPARAM(ref) FBPOpenVRActionInfo & HandSkeletalAction, TArray<FTransform> & ComponentSpaceTransforms)
+	{
+		ComponentSpaceTransforms = HandSkeletalAction.GetComponentSpaceTransforms();
+	}
+
+	// Every bone of the action in world space given the transform of the hands root (generally the hand mesh), cached like the component space ones
+	UFUNCTION(BlueprintCallable, Category = "OpenInputFunctions|SteamVR")
+	static void GetOpenVRWorldSpaceTransforms(UPARAM(ref) FBPOpenVRActionInfo & HandSkeletalAction, FTransform ComponentToWorld, TArray<FTransform> & WorldSpaceTransforms)
+	{
+		WorldSpaceTransforms = HandSkeletalAction.GetWorldSpaceTransforms(ComponentToWorld);
+	}
+
+	// A single bone from the cached spaces, for finger tip pokes and pinches
+	UFUNCTION(BlueprintCallable, Category = "OpenInputFunctions|SteamVR")
+	static bool GetOpenVRBoneTransformInSpace(UPARAM(ref) FBPOpenVRActionInfo & HandSkeletalAction, EVROpenInputBones BoneToGet, bool bWorldSpace, FTransform ComponentToWorld, FTransform & BoneTransform)
+	{
+		const TArray<FTransform> & Transforms = bWorldSpace ? HandSkeletalAction.GetWorldSpaceTransforms(ComponentToWorld) : HandSkeletalAction.GetComponentSpaceTransforms();
+
+		if (!Transforms.IsValidIndex((uint8)BoneToGet))
+		{
+			BoneTransform = FTransform::Identity;
+			return false;
+		}
+
+		BoneTransform = Transforms[(uint8)BoneToGet];
+		return true;
+	}
+
 #if STEAMVR_SUPPORTED_PLATFORM
 
 	FORCEINLINE static FTransform CONVERT_STEAMTRANS_TO_FTRANS(const vr::VRBoneTransform_t InTrans, float WorldToMeters)
@@ -628,7 +1093,16 @@ public:
 	}
 
 
-	static void MIRROR_OPENINPUT_BONES(TArray<vr::VRBoneTransform_t> &BoneTransforms)
+	// Converts a whole skeleton in one pass, fusing the axis swap, quaternion sign flips, world scale and optional
+	// left / right mirroring per bone. Uses VectorRegister math where FTransform is vectorized, produces the same
+	// results as MIRROR_OPENINPUT_BONES followed by CONVERT_STEAMTRANS_TO_FTRANS on every bone.
+	static void CONVERT_STEAMTRANS_TO_FTRANS_BATCH(const vr::VRBoneTransform_t * InTransforms, FTransform * OutTransforms, int32 BoneCount, float WorldToMeters, bool bMirrorLeftRight);
+
+	// Reference version of the above, mirror pass then per bone conversion
+	static void CONVERT_STEAMTRANS_TO_FTRANS_BATCH_Scalar(const vr::VRBoneTransform_t * InTransforms, FTransform * OutTransforms, int32 BoneCount, float WorldToMeters, bool bMirrorLeftRight);
+
+	template<typename AllocatorType>
+	static void MIRROR_OPENINPUT_BONES(TArray<vr::VRBoneTransform_t, AllocatorType> &BoneTransforms)
 	{
 
 		/*
@@ -739,495 +1213,32 @@ public:
 
 #endif
 
-	// Decompresses compressed bone data from OpenInput
-	static bool DecompressSkeletalData(FBPOpenVRActionInfo & Action, UWorld * WorldToUseForScale)
-	{
-#if !STEAMVR_SUPPORTED_PLATFORM
-		return false;
-#else
-		if (Action.CompressedTransforms.Num() < 1 || !WorldToUseForScale)
-			return false;
-
-		vr::IVRInput * VRInput =  vr::VRInput();
-
-		Action.bHasValidData = false;
-
-		if (!VRInput)
-			return false;
-
-		TArray<vr::VRBoneTransform_t> BoneTransforms;
-		BoneTransforms.AddZeroed(Action.BoneCount);
-
-		Action.CompressedSize = Action.CompressedTransforms.Num();
-
-		vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
-		vr::EVRSkeletalTransformSpace TransSpace = /*Action.SkeletalData.bGetTransformsInParentSpace ?*/ vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Parent;// : vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Model;
-		InputError = VRInput->DecompressSkeletalBoneData(Action.CompressedTransforms.GetData(), Action.CompressedSize, TransSpace, BoneTransforms.GetData(), Action.BoneCount);
-
-		if (InputError != vr::EVRInputError::VRInputError_None)
-			return false;
+	// Fills an action from a sample taken by the background sampling thread instead of querying the runtime
+	static bool ApplyRawPoseSample(FBPOpenVRActionInfo & Action, const FOpenInputRawPoseSample & Sample, UObject* WorldContextObject, bool bGetGestureValues = true);
 
-		if (Action.SkeletalData.SkeletalTransforms.Num() > 0)
-		{
-			Action.OldSkeletalTransforms = Action.SkeletalData.SkeletalTransforms;
-		}
-
-		if (Action.SkeletalData.SkeletalTransforms.Num() != Action.BoneCount)
-		{
-			Action.SkeletalData.SkeletalTransforms.Reset(Action.BoneCount);
-			Action.SkeletalData.SkeletalTransforms.AddUninitialized(Action.BoneCount);
-		}
-
-		float WorldToMeters = Action.SkeletalData.WorldScaleOverride > 0.0f ?  Action.SkeletalData.WorldScaleOverride : ((WorldToUseForScale != nullptr) ? WorldToMeters = WorldToUseForScale->GetWorldSettings()->WorldToMeters : 100.f);
-
-		if (Action.SkeletalData.bMirrorLeftRight)
-			MIRROR_OPENINPUT_BONES(BoneTransforms);
-
-		for (int i = 0; i < BoneTransforms.Num(); ++i)
-			Action.SkeletalData.SkeletalTransforms[i] = CONVERT_STEAMTRANS_TO_FTRANS(BoneTransforms[i], WorldToMeters);
-
-		Action.bHasValidData = true;
-		return true;
-#endif
-	}
+	// Decompresses compressed bone data from OpenInput
+	static bool DecompressSkeletalData(FBPOpenVRActionInfo & Action, UWorld * WorldToUseForScale);
 
 	// Checks if a specific OpenVR device is connected, index names are assumed, they may not be exact
 	UFUNCTION(BlueprintCallable, Category = "OpenInputFunctions|SteamVR", meta = (bIgnoreSelf = "true", WorldContext = "WorldContextObject", CallableWithoutWorldContext))
-		static bool GetActionPose(UPARAM(ref)FBPOpenVRActionInfo & Action, class UObject* WorldContextObject, bool bGetCompressedData = false, bool bGetGestureValues = true)
-	{
-#if !STEAMVR_SUPPORTED_PLATFORM
-		Action.bHasValidData = false;
-		return false;
-#else
-		// An exported valid hand pose for testing, don't mine me
-		/*Action.bHasValidData = true;
-		Action.BoneCount = 31;
-		Action.SkeletalData.SkeletalTransforms.Reset(Action.BoneCount);
-
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-6.12323426e-17, -6.12323426e-17, -3.74939939e-33, -1.00000000), FVector(0.000000, 0.000000, 0.000000)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.078608, -0.920279, 0.379296, 0.055147), FVector(0.034038, 0.036503, 0.164722)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.032980, 0.642452, 0.177896, -0.744661), FVector(0.015893, 0.037202, 0.129626)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.062613, -0.641222, -0.081999, 0.760388), FVector(0.011399, 0.049619, 0.091439)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.202745, -0.594267, -0.249441, 0.737239), FVector(0.006059, 0.056285, 0.060064)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.202745, -0.594267, -0.249441, 0.737239), FVector(0.000903, 0.074831, 0.036452)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.602551, 0.647012, 0.373282, -0.281014), FVector(0.029019, 0.044768, 0.135503)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.669277, -0.604607, -0.318717, 0.291441), FVector(0.042551, 0.002262, 0.075993)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.626055, -0.648056, -0.305172, 0.308137), FVector(0.039663, -0.025130, 0.041770)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.623527, -0.663809, -0.293734, 0.290331), FVector(0.040416, -0.043018, 0.019345)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.623527, -0.663809, -0.293734, 0.290331), FVector(0.041644, -0.058017, 0.002189)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.569604, 0.714872, 0.237212, -0.328998), FVector(0.034164, 0.030176, 0.147938)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.681727, -0.647574, -0.284311, 0.187252), FVector(0.043159, -0.017431, 0.096086)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.711895, -0.608206, -0.269531, 0.225043), FVector(0.043175, -0.050903, 0.068921)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.678062, -0.659285, -0.265683, 0.187047), FVector(0.039354, -0.075674, 0.047048)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.703971, -0.631547, -0.257964, 0.197557), FVector(0.039625, -0.096250, 0.031333)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.604345, 0.717512, 0.205713, -0.278612), FVector(0.035078, 0.020420, 0.157607)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.687871, -0.683120, -0.164126, 0.182327), FVector(0.040958, -0.029928, 0.115490)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.708515, -0.661749, -0.160099, 0.185643), FVector(0.040436, -0.065739, 0.096164)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.736793, -0.634757, -0.143936, 0.183037), FVector(0.038340, -0.090987, 0.082579)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.736793, -0.634757, -0.143936, 0.183037), FVector(0.034914, -0.110785, 0.072609)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.649283, 0.709908, 0.228285, -0.149493), FVector(0.034509, 0.012210, 0.167464)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.729502, -0.662042, -0.169427, 0.028676), FVector(0.038718, -0.041785, 0.135390)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.796114, -0.580514, -0.164037, 0.047926), FVector(0.036724, -0.070681, 0.126773)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.759130, -0.638501, -0.126582, 0.003951), FVector(0.031774, -0.087206, 0.121011)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.759130, -0.638501, -0.126582, 0.003951), FVector(0.029025, -0.104654, 0.117457)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(0.202745, -0.594267, -0.249441, 0.737238), FVector(0.006059, 0.056285, 0.060064)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.623527, -0.663809, -0.293734, 0.290331), FVector(0.040416, -0.043018, 0.019345)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.678062, -0.659285, -0.265683, 0.187047), FVector(0.039354, -0.075674, 0.047048)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.736793, -0.634757, -0.143936, 0.183037), FVector(0.038340, -0.090987, 0.082579)));
-		Action.SkeletalData.SkeletalTransforms.Add(FTransform(FQuat(-0.759130, -0.638501, -0.126581, 0.003950), FVector(0.031774, -0.087205, 0.121011)));
-
-		for (int i = 0; i < Action.SkeletalData.SkeletalTransforms.Num(); i++)
-		{
-
-			vr::VRBoneTransform_t trans;
-			FQuat rot = Action.SkeletalData.SkeletalTransforms[i].GetRotation();
-			FVector pos = Action.SkeletalData.SkeletalTransforms[i].GetTranslation();
-
-			trans.orientation.w = rot.W;
-			trans.orientation.x = rot.X;
-			trans.orientation.y = rot.Y;
-			trans.orientation.z = rot.Z;
-
-			trans.position.v[0] = pos.X;
-			trans.position.v[1] = pos.Y;
-			trans.position.v[2] = pos.Z;
-
-			Action.SkeletalData.SkeletalTransforms[i] = CONVERT_STEAMTRANS_TO_FTRANS(trans, 100.0f);
-		}
-
-		return true;*/
-
-
-		vr::IVRInput * VRInput =  vr::VRInput();
-
-		Action.bHasValidData = false;
-
-		if (!VRInput)
-			return false;
-
-		vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
-
-		if (Action.ActionHandleContainer.ActionHandle == vr::k_ulInvalidActionHandle)
-		{
-
-			// Not filling in the field as that is a waste, just assuming from the data sent in
-			// Still allowing overriding manually though
-
-			if (Action.ActionName.IsEmpty())
-			{
-				switch (Action.SkeletalData.TargetHand)
-				{
-				case EVRActionHand::EActionHand_Left:
-				{
-					Action.ActionName = OpenInputFunctionLibraryStatics::LeftHand_SkeletalActionName;
-				}break;
-				case EVRActionHand::EActionHand_Right:
-				{
-					Action.ActionName = OpenInputFunctionLibraryStatics::RightHand_SkeletalActionName;
-				}break;
-				default:break;
-				}
-			}
-
-			InputError = VRInput->GetActionHandle(TCHAR_TO_UTF8(*Action.ActionName), &Action.ActionHandleContainer.ActionHandle);
-			if (InputError != vr::EVRInputError::VRInputError_None)
-			{
-				Action.ActionHandleContainer.ActionHandle = vr::k_ulInvalidActionHandle;
-				return false;
-			}
-		}
-
-		uint32_t boneCount = 0;
-		InputError = VRInput->GetBoneCount(Action.ActionHandleContainer.ActionHandle, &boneCount);
-
-		// If the handle doesn't map to a correct action handle
-		// Should likely throw an error here and stop getting a handle
-		if (InputError == vr::EVRInputError::VRInputError_InvalidHandle)
-		{
-			Action.ActionHandleContainer.ActionHandle = vr::k_ulInvalidActionHandle;
-			return false;
-
-		}
-
-		vr::InputSkeletalActionData_t SkeletalData;
-		uint32_t ActionDataSize = sizeof(SkeletalData);
-		InputError = VRInput->GetSkeletalActionData(Action.ActionHandleContainer.ActionHandle, &SkeletalData, ActionDataSize);
-
-		if (InputError != vr::EVRInputError::VRInputError_None || !SkeletalData.bActive || boneCount < 1)
-			return false;
-
-		// Set bone count so we can reference it later
-		Action.BoneCount = boneCount;
-
-		// On first tick using this, load the bone parent index array
-		if (!Action.BoneParentIndexes.Num())
-		{
-			Action.BoneParentIndexes.AddZeroed(Action.BoneCount);
-			InputError = VRInput->GetBoneHierarchy(Action.ActionHandleContainer.ActionHandle, Action.BoneParentIndexes.GetData(), Action.BoneCount);
-
-			if (InputError != vr::EVRInputError::VRInputError_None)
-				return false;
-		}
-
-		// On first tick using this, load the skeletal tracking level
-		if (Action.SkeletalTrackingLevel == EVROpenInputSkeletalTrackingLevel::VRSkeletalTrackingLevel_Max)
-		{
-			vr::EVRSkeletalTrackingLevel TrackingLevel;
-			VRInput->GetSkeletalTrackingLevel(Action.ActionHandleContainer.ActionHandle, &TrackingLevel);
-
-			if (InputError != vr::EVRInputError::VRInputError_None)
-				return false;
-
-			Action.SkeletalTrackingLevel = (EVROpenInputSkeletalTrackingLevel)TrackingLevel;
-		}
-
-		// If we are supposed to get gesture values, load them too
-		if (bGetGestureValues)
-		{
-			vr::VRSkeletalSummaryData_t SkeletalSummaryData;
-			VRInput->GetSkeletalSummaryData(Action.ActionHandleContainer.ActionHandle, vr::EVRSummaryType::VRSummaryType_FromAnimation, &SkeletalSummaryData);
-
-			if (InputError != vr::EVRInputError::VRInputError_None)
-				return false;
-
-			Action.PoseFingerData.PoseFingerCurls.Reset(vr::VRFinger_Count);
-			for (int i = 0; i < vr::VRFinger_Count; ++i)
-			{
-				Action.PoseFingerData.PoseFingerCurls.Add(SkeletalSummaryData.flFingerCurl[i]);
-			}
-
-			if (Action.SkeletalTrackingLevel == EVROpenInputSkeletalTrackingLevel::VRSkeletalTracking_Full)
-			{
-				Action.PoseFingerData.PoseFingerSplays.Reset(vr::VRFingerSplay_Count);
-				for (int i = 0; i < vr::VRFingerSplay_Count; ++i)
-				{
-					Action.PoseFingerData.PoseFingerSplays.Add(SkeletalSummaryData.flFingerSplay[i]);
-				}
-			}
-		}
-
-		TArray<vr::VRBoneTransform_t> BoneTransforms;
-		BoneTransforms.AddZeroed(Action.BoneCount);
-
-		vr::EVRSkeletalMotionRange MotionTypeToGet = Action.bGetSkeletalTransforms_WithController ? vr::EVRSkeletalMotionRange::VRSkeletalMotionRange_WithController : vr::EVRSkeletalMotionRange::VRSkeletalMotionRange_WithoutController;
-		
-		{
-			InputError = VRInput->GetSkeletalBoneData(Action.ActionHandleContainer.ActionHandle, /*Action.SkeletalData.bGetTransformsInParentSpace ? */vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Parent/* : vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Model*/, MotionTypeToGet, BoneTransforms.GetData(), Action.BoneCount);
-			Action.CompressedSize = 0;
-			Action.CompressedTransforms.Empty(bGetCompressedData ? Action.BoneCount : 0);
-		}
-		
-		// We got the transforms normally for the local player as they don't have the artifacts, but we get the compressed ones for remote sending
-		if (bGetCompressedData)
-		{			
-			int32 MaxArraySize = ((sizeof(vr::VRBoneTransform_t) * Action.BoneCount) + 2);
-			TArray<uint8> TempBuffer;
-			TempBuffer.AddUninitialized(MaxArraySize);
-
-			InputError = VRInput->GetSkeletalBoneDataCompressed(Action.ActionHandleContainer.ActionHandle, MotionTypeToGet, TempBuffer.GetData(), MaxArraySize, &Action.CompressedSize);
-			Action.CompressedTransforms.Reset(Action.CompressedSize);
-			Action.CompressedTransforms.AddUninitialized(Action.CompressedSize);
-			FMemory::Memcpy(Action.CompressedTransforms.GetData(), TempBuffer.GetData(), Action.CompressedSize);
-		}
-
-		if (InputError != vr::EVRInputError::VRInputError_None)
-			return false;
-
-		if (Action.SkeletalData.SkeletalTransforms.Num() > 0)
-		{
-			Action.OldSkeletalTransforms = Action.SkeletalData.SkeletalTransforms;
-		}
-
-		if (Action.SkeletalData.SkeletalTransforms.Num() != Action.BoneCount)
-		{
-			Action.SkeletalData.SkeletalTransforms.Reset(Action.BoneCount);
-			Action.SkeletalData.SkeletalTransforms.AddUninitialized(Action.BoneCount);
-		}
-
-		UWorld* World = (WorldContextObject) ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
-		float WorldToMeters = Action.SkeletalData.WorldScaleOverride > 0.0f ? Action.SkeletalData.WorldScaleOverride : ((World != nullptr) ? WorldToMeters = World->GetWorldSettings()->WorldToMeters : 100.f);
+		static bool GetActionPose(UPARAM(ref)FBPOpenVRActionInfo & Action, class UObject* WorldContextObject, bool bGetCompressedData = false, bool bGetGestureValues = true);
 
+	// GetActionPose that only makes the runtime calls the requested products need, anything not requested is left as it was.
+	// Bone count, hierarchy and tracking level are always refreshed.
+	static bool GetActionPoseProducts(FBPOpenVRActionInfo & Action, UObject* WorldContextObject, EOpenInputPoseProducts Products);
 
-		if(Action.SkeletalData.bMirrorLeftRight)
-			MIRROR_OPENINPUT_BONES(BoneTransforms);
-
-		for (int i = 0; i < BoneTransforms.Num(); ++i)
-		{
-			Action.SkeletalData.SkeletalTransforms[i] = CONVERT_STEAMTRANS_TO_FTRANS(BoneTransforms[i], WorldToMeters);
-		}
-
-		/*if (UPrimitiveComponent* PrimPar = Cast<UPrimitiveComponent>(WorldContextObject))
-		{
-			FTransform SkeleTrans = Action.SkeletalData.SkeletalTransforms[1];
-			SkeleTrans.SetRotation(SkeleTrans.GetRotation() * FRotator(0.f, 90.f, 90.f).Quaternion());
-			FTransform WorldTrans = (SkeleTrans * PrimPar->GetComponentTransform());
-			DrawDebugSphere(WorldContextObject->GetWorld(), WorldTrans.GetLocation(), 4.f, 32.f, FColor::White);
-			DrawDebugLine(WorldContextObject->GetWorld(), WorldTrans.GetLocation(), WorldTrans.GetLocation() + (WorldTrans.GetRotation().GetForwardVector() * 100.f), FColor::Red);
-			DrawDebugLine(WorldContextObject->GetWorld(), WorldTrans.GetLocation(), WorldTrans.GetLocation() + (WorldTrans.GetRotation().GetRightVector() * 100.f), FColor::Green);
-			DrawDebugLine(WorldContextObject->GetWorld(), WorldTrans.GetLocation(), WorldTrans.GetLocation() + (WorldTrans.GetRotation().GetUpVector() * 100.f), FColor::Blue);
-		}*/
-
-		Action.bHasValidData = true;
-		return true;
-
-#endif
-	}
+	static EOpenInputPoseProducts MakePoseProducts(bool bGetBones, bool bGetGestureValues, bool bGetCompressedData);
 
 	// Checks if a specific OpenVR device is connected, index names are assumed, they may not be exact
 	UFUNCTION(BlueprintCallable, Category = "OpenInputFunctions|SteamVR", meta = (bIgnoreSelf = "true", WorldContext = "WorldContextObject", CallableWithoutWorldContext))
-		static bool GetReferencePose(UPARAM(ref)FBPOpenVRActionInfo & BlankActionToFill, FBPOpenVRActionHandle ActionHandleToQuery, /*bool bGetTransformsInParentSpace,*/ class UObject* WorldContextObject, EVROpenInputReferencePose PoseTypeToRetreive)
-	{
-#if !STEAMVR_SUPPORTED_PLATFORM
-		Action.bHasValidData = false;
-		return false;
-#else
-
-		vr::IVRInput * VRInput =  vr::VRInput();
-
-		BlankActionToFill.bHasValidData = false;
-		//BlankActionToFill.SkeletalData.bGetTransformsInParentSpace = bGetTransformsInParentSpace;
-		BlankActionToFill.ActionHandleContainer = ActionHandleToQuery;
-
-		if (!VRInput)
-			return false;
-
-		vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
-
-		uint32_t boneCount = 0;
-		InputError = VRInput->GetBoneCount(BlankActionToFill.ActionHandleContainer.ActionHandle, &boneCount);
-
-		// If the handle doesn't map to a correct action handle
-		// Should likely throw an error here and stop getting a handle
-		if (InputError == vr::EVRInputError::VRInputError_InvalidHandle)
-		{
-			BlankActionToFill.ActionHandleContainer.ActionHandle = vr::k_ulInvalidActionHandle;
-			return false;
-		}
-
-		vr::InputSkeletalActionData_t SkeletalData;
-		uint32_t ActionDataSize = sizeof(SkeletalData);
-		InputError = VRInput->GetSkeletalActionData(BlankActionToFill.ActionHandleContainer.ActionHandle, &SkeletalData, ActionDataSize);
-
-		if (InputError != vr::EVRInputError::VRInputError_None || !SkeletalData.bActive || boneCount < 1)
-			return false;
-
-		// Set bone count so we can reference it later
-		BlankActionToFill.BoneCount = boneCount;
-
-		TArray<vr::VRBoneTransform_t> BoneTransforms;
-		BoneTransforms.AddZeroed(BlankActionToFill.BoneCount);
-
-		{
-			InputError = VRInput->GetSkeletalReferenceTransforms(
-				BlankActionToFill.ActionHandleContainer.ActionHandle, 
-				vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Parent,
-				//BlankActionToFill.SkeletalData.bGetTransformsInParentSpace ? vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Parent : vr::EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Model, 
-				(vr::EVRSkeletalReferencePose)PoseTypeToRetreive,
-				BoneTransforms.GetData(), 
-				BlankActionToFill.BoneCount);
-
-			BlankActionToFill.CompressedSize = 0;
-			BlankActionToFill.CompressedTransforms.Empty();
-		}
-
-		if (InputError != vr::EVRInputError::VRInputError_None)
-			return false;
-
-		if (BlankActionToFill.SkeletalData.SkeletalTransforms.Num() > 0)
-		{
-			BlankActionToFill.OldSkeletalTransforms = BlankActionToFill.SkeletalData.SkeletalTransforms;
-		}
-
-		if (BlankActionToFill.SkeletalData.SkeletalTransforms.Num() != BlankActionToFill.BoneCount)
-		{
-			BlankActionToFill.SkeletalData.SkeletalTransforms.Reset(BlankActionToFill.BoneCount);
-			BlankActionToFill.SkeletalData.SkeletalTransforms.AddUninitialized(BlankActionToFill.BoneCount);
-		}
-
-		UWorld* World = (WorldContextObject) ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
-		float WorldToMeters = BlankActionToFill.SkeletalData.WorldScaleOverride > 0.0f ? BlankActionToFill.SkeletalData.WorldScaleOverride : ((World != nullptr) ? WorldToMeters = World->GetWorldSettings()->WorldToMeters : 100.f);
-
-		if (BlankActionToFill.SkeletalData.bMirrorLeftRight)
-			MIRROR_OPENINPUT_BONES(BoneTransforms);
-
-		for (int i = 0; i < BoneTransforms.Num(); ++i)
-			BlankActionToFill.SkeletalData.SkeletalTransforms[i] = CONVERT_STEAMTRANS_TO_FTRANS(BoneTransforms[i], WorldToMeters);
-
-		BlankActionToFill.bHasValidData = true;
-		return true;
-#endif
-	}
+		static bool GetReferencePose(UPARAM(ref)FBPOpenVRActionInfo & BlankActionToFill, FBPOpenVRActionHandle ActionHandleToQuery, /*bool bGetTransformsInParentSpace,*/ class UObject* WorldContextObject, EVROpenInputReferencePose PoseTypeToRetreive);
 
 	// Gets the curl and splay values of a hand, this is generally only used if you aren't getting the full pose and filling out an ActionInfo structure.
 	// If the optional custom action name is blank then it will use the plugins default values
 	UFUNCTION(BlueprintCallable, Category = "OpenInputFunctions|SteamVR", meta = (bIgnoreSelf = "true", WorldContext = "WorldContextObject", CallableWithoutWorldContext))
-		static bool GetHandCurlAndSplayValues(EVRActionHand TargetHand, UPARAM(ref) FBPOpenVRGesturePoseData & CurlAndSplayValuesOut, class UObject* WorldContextObject, FString OptionalCustomActionName)
-	{
-#if !STEAMVR_SUPPORTED_PLATFORM
-		return false;
-#else
-		vr::IVRInput * VRInput =  vr::VRInput();
-
-		if (!VRInput)
-			return false;
-
-		vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
-
-		if (OptionalCustomActionName.IsEmpty())
-		{
-			switch (TargetHand)
-			{
-			case EVRActionHand::EActionHand_Left:
-			{
-				OptionalCustomActionName = OpenInputFunctionLibraryStatics::LeftHand_SkeletalActionName;
-			}break;
-			case EVRActionHand::EActionHand_Right:
-			{
-				OptionalCustomActionName = OpenInputFunctionLibraryStatics::RightHand_SkeletalActionName;
-			}break;
-			default:break;
-			}
-		}
-
-		vr::VRActionHandle_t ActionHandle;
-		InputError = VRInput->GetActionHandle(TCHAR_TO_UTF8(*OptionalCustomActionName), &ActionHandle);
-		if (InputError != vr::EVRInputError::VRInputError_None || ActionHandle == vr::k_ulInvalidActionHandle)
-		{
-			return false;
-		}
-
-		vr::VRSkeletalSummaryData_t SkeletalSummaryData;
-		VRInput->GetSkeletalSummaryData(ActionHandle, vr::EVRSummaryType::VRSummaryType_FromAnimation, &SkeletalSummaryData);
-
-		if (InputError != vr::EVRInputError::VRInputError_None)
-			return false;
-
-		CurlAndSplayValuesOut.PoseFingerCurls.Reset(vr::VRFinger_Count);
-		for (int i = 0; i < vr::VRFinger_Count; ++i)
-		{
-			CurlAndSplayValuesOut.PoseFingerCurls.Add(SkeletalSummaryData.flFingerCurl[i]);
-		}
-
-		CurlAndSplayValuesOut.PoseFingerSplays.Reset(vr::VRFingerSplay_Count);
-		for (int i = 0; i < vr::VRFingerSplay_Count; ++i)
-		{
-			CurlAndSplayValuesOut.PoseFingerSplays.Add(SkeletalSummaryData.flFingerSplay[i]);
-		}
-
-		return true;
-#endif
-	}
+		static bool GetHandCurlAndSplayValues(EVRActionHand TargetHand, UPARAM(ref) FBPOpenVRGesturePoseData & CurlAndSplayValuesOut, class UObject* WorldContextObject, FString OptionalCustomActionName);
 
 	// Checks if a specific OpenVR device is connected, index names are assumed, they may not be exact
 	UFUNCTION(BlueprintCallable, Category = "OpenInputFunctions|SteamVR", meta = (bIgnoreSelf = "true", WorldContext = "WorldContextObject", CallableWithoutWorldContext))
-	static bool GetSkeletalTrackingLevel(EVROpenInputSkeletalTrackingLevel & SkeletalTrackingLevelOut, EVRActionHand HandToRetreive)
-	{
-#if !STEAMVR_SUPPORTED_PLATFORM
-		SkeletalTrackingLevelOut = EVROpenInputSkeletalTrackingLevel::VRSkeletalTrackingLevel_Max;
-		return false;
-#else
-		vr::IVRInput * VRInput =  vr::VRInput();
-
-		if (!VRInput)
-			return false;
-
-		vr::EVRInputError InputError = vr::EVRInputError::VRInputError_None;
-
-		vr::VRActionHandle_t ActionHandle = vr::k_ulInvalidActionHandle;
-		FString ActionName;
-
-		switch (HandToRetreive)
-		{
-		case EVRActionHand::EActionHand_Left:
-		{
-			ActionName = OpenInputFunctionLibraryStatics::LeftHand_SkeletalActionName;
-		}break;
-		case EVRActionHand::EActionHand_Right:
-		{
-			ActionName = OpenInputFunctionLibraryStatics::RightHand_SkeletalActionName;
-		}break;
-		default:break;
-		}
-
-		InputError = VRInput->GetActionHandle(TCHAR_TO_UTF8(*ActionName), &ActionHandle);
-		if (InputError != vr::EVRInputError::VRInputError_None)
-		{
-			SkeletalTrackingLevelOut = EVROpenInputSkeletalTrackingLevel::VRSkeletalTrackingLevel_Max;
-			return false;
-		}
-
-		vr::EVRSkeletalTrackingLevel TrackingLevel;
-		VRInput->GetSkeletalTrackingLevel(ActionHandle, &TrackingLevel);
-
-		if (InputError != vr::EVRInputError::VRInputError_None)
-		{
-			SkeletalTrackingLevelOut = EVROpenInputSkeletalTrackingLevel::VRSkeletalTrackingLevel_Max;
-			return false;
-		}
-
-		SkeletalTrackingLevelOut = (EVROpenInputSkeletalTrackingLevel)TrackingLevel;
-		return true;
-
-#endif
-	}
+	static bool GetSkeletalTrackingLevel(EVROpenInputSkeletalTrackingLevel & SkeletalTrackingLevelOut, EVRActionHand HandToRetreive);
 };	
@@ -0,0 +1,308 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "OpenInputFunctionLibrary.h"
+
+struct FOpenInputGesture;
+struct FOpenInputDynamicGesture;
+
+// A gestures hold settings, kept with the tables so they survive the source being stripped
+struct OPENINPUTPLUGIN_API FOpenInputGestureHoldSettings
+{
+	float ExitThresholdScale;
+	float MinHoldTime;
+	float Cooldown;
+
+	FOpenInputGestureHoldSettings()
+	{
+		ExitThresholdScale = 1.f;
+		MinHoldTime = 0.f;
+		Cooldown = 0.f;
+	}
+
+	friend FArchive & operator<<(FArchive & Ar, FOpenInputGestureHoldSettings & Settings)
+	{
+		return Ar << Settings.ExitThresholdScale << Settings.MinHoldTime << Settings.Cooldown;
+	}
+};
+
+// One group of gestures laid out lane major (all gestures values for curl 0, then curl 1...) so four gestures test per instruction.
+// Padded to a multiple of four with gestures that can never match.
+struct OPENINPUTPLUGIN_API FOpenInputGestureTable
+{
+	// Five curls followed by four splays, same order as a gestures FingerValues
+	static const int32 NumLanes = vr::VRFinger_Count + vr::VRFingerSplay_Count;
+
+	int32 NumGestures;
+	int32 NumPadded;
+
+	TArray<float> Values;
+	TArray<float> Thresholds;
+
+	// Index into the source database of each column
+	TArray<int32> GestureIndices;
+
+	FOpenInputGestureTable()
+	{
+		NumGestures = 0;
+		NumPadded = 0;
+	}
+
+	void Reset()
+	{
+		NumGestures = 0;
+		NumPadded = 0;
+		Values.Reset();
+		Thresholds.Reset();
+		GestureIndices.Reset();
+	}
+
+	// First column where every one of the first NumLanesToTest lanes is within threshold, INDEX_NONE if none are
+	int32 FindFirstMatch(const float * HandValues, int32 NumLanesToTest) const;
+
+	void Serialize(FArchive & Ar);
+};
+
+// Bounds tree over the columns of one gesture table for closest match queries on large databases.
+// Each node keeps the box of its gestures values and the box they reach once widened by their thresholds,
+// a pose outside the reach box can't match anything below it and the value box gives a lower bound on distance.
+struct OPENINPUTPLUGIN_API FOpenInputGestureKDTree
+{
+	static const int32 LeafSize = 8;
+
+	struct FNode
+	{
+		float ValueMin[FOpenInputGestureTable::NumLanes];
+		float ValueMax[FOpenInputGestureTable::NumLanes];
+		float ReachMin[FOpenInputGestureTable::NumLanes];
+		float ReachMax[FOpenInputGestureTable::NumLanes];
+
+		// Children are stored next to each other, INDEX_NONE for leaves
+		int32 FirstChild;
+
+		// Range of Columns under this node
+		int32 Start;
+		int32 Count;
+	};
+
+	TArray<FNode> Nodes;
+
+	// Table columns reordered so every node covers a contiguous range
+	TArray<int32> Columns;
+
+	void Reset()
+	{
+		Nodes.Reset();
+		Columns.Reset();
+	}
+
+	void Build(const FOpenInputGestureTable & Table);
+
+	void Serialize(FArchive & Ar);
+
+	// Tightens InOutBestIndex / InOutBestDistSq (source index and squared distance) with any closer match from this tree
+	void FindBestMatch(const FOpenInputGestureTable & Table, const float * HandValues, int32 NumLanesToTest, int32 & InOutBestIndex, float & InOutBestDistSq) const;
+
+private:
+
+	void BuildNode(const FOpenInputGestureTable & Table, int32 NodeIndex, int32 Start, int32 Count);
+	void SearchNode(const FOpenInputGestureTable & Table, int32 NodeIndex, const float * HandValues, int32 NumLanesToTest, int32 & InOutBestIndex, float & InOutBestDistSq) const;
+};
+
+// A gesture database flattened for matching, curl only gestures and curl + splay gestures are kept apart
+// as the latter are skipped entirely on fully tracked hands.
+struct OPENINPUTPLUGIN_API FOpenInputCompiledGestureSet
+{
+	FOpenInputGestureTable CurlOnly;
+	FOpenInputGestureTable CurlAndSplay;
+
+	// Only built when asked for, closest match queries fall back to a linear scan without it
+	FOpenInputGestureKDTree CurlOnlyTree;
+	FOpenInputGestureKDTree CurlAndSplayTree;
+	bool bHasSpatialIndex;
+
+	// Number of gestures in the source when compiled, a mismatch means it was added to without being recompiled
+	int32 SourceGestureCount;
+
+	// Per source gesture, so events can be named and held without the source
+	TArray<FName> Names;
+	TArray<FOpenInputGestureHoldSettings> HoldSettings;
+
+	// Every context used in the source, a gestures bit in ContextMasks is its index in here
+	static const int32 MaxContexts = 64;
+	TArray<FName> ContextNames;
+
+	// Per source gesture, zero for gestures without a context which are always active
+	TArray<uint64> ContextMasks;
+
+	// Contexts left out of the tables when this was filtered from a full set, zero for a full set
+	uint64 DisabledContextBits;
+
+	FOpenInputCompiledGestureSet()
+	{
+		SourceGestureCount = INDEX_NONE;
+		bHasSpatialIndex = false;
+		DisabledContextBits = 0;
+	}
+
+	void Compile(const TArray<FOpenInputGesture> & Gestures, bool bBuildSpatialIndex = false);
+
+	// Copies Source keeping only the table columns of gestures still active with InDisabledContextBits turned off.
+	// Everything indexed by source gesture is kept whole so indices mean the same in both.
+	void CompileFiltered(const FOpenInputCompiledGestureSet & Source, uint64 InDisabledContextBits);
+
+	// Bits of the named contexts this set knows about, names it doesn't know are ignored
+	uint64 GetContextBits(const TArray<FName> & Contexts) const;
+
+	FORCEINLINE bool IsGestureActive(int32 GestureIndex) const
+	{
+		// Gestures added since the compile have no mask yet and are treated as untagged
+		const uint64 Mask = ContextMasks.IsValidIndex(GestureIndex) ? ContextMasks[GestureIndex] : 0;
+		return Mask == 0 || (Mask & ~DisabledContextBits) != 0;
+	}
+
+	// Index in the source database of the first gesture matching the pose, same rules as walking the database in order
+	int32 FindFirstMatch(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel) const;
+
+	// Index of the matching gesture closest to the pose (euclidean over the values the gesture checks), ties go to the lower index.
+	// Uses the spatial index if one was built.
+	int32 FindBestMatch(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, float & OutDistance) const;
+
+	// Same as FindBestMatch but always tests every gesture, the baseline the spatial index is measured against
+	int32 FindBestMatchLinear(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, float & OutDistance) const;
+
+	// Versions that only touch the compiled data, safe off the game thread while the source is being edited.
+	// The pose must have exactly five curls.
+	int32 FindFirstMatchCompiled(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel) const;
+	int32 FindBestMatchCompiled(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, bool bUseSpatialIndex, float & OutDistance) const;
+
+	// The reference gesture by gesture loop, used for hands that don't report the standard five curls.
+	// Skips gestures ActiveFilter has disabled if one is given.
+	static int32 FindFirstMatchScalar(const TArray<FOpenInputGesture> & Gestures, const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, const FOpenInputCompiledGestureSet * ActiveFilter = nullptr);
+
+	// If the pose is within the gestures thresholds scaled by ThresholdScale, ignoring what the hand doesn't report
+	bool IsPoseWithinGesture(int32 GestureIndex, const FBPOpenVRGesturePoseData & PoseData, float ThresholdScale) const;
+
+	// Rebuilds source gestures from the tables, what was never compiled (splays on curl only gestures, gestures too short to match) comes back at defaults
+	bool ExpandGesture(int32 GestureIndex, FOpenInputGesture & OutGesture) const;
+	void ExpandGestures(TArray<FOpenInputGesture> & OutGestures) const;
+
+	// The tables and trees only, Names and ContextNames are left to the owner so they can go through its package name table
+	void Serialize(FArchive & Ar);
+};
+
+// A dynamic gestures samples flattened to NumLanes floats each, missing splays are zero
+struct OPENINPUTPLUGIN_API FOpenInputDynamicGestureTemplate
+{
+	int32 GestureIndex;
+	int32 NumSamples;
+	bool bUseFingerCurlOnly;
+
+	// MatchThreshold scaled by the sample count, compared against the accumulated warp cost
+	float MaxCost;
+
+	// Into FOpenInputCompiledDynamicGestures::Values and into a recognizers per template state
+	int32 ValueOffset;
+	int32 StateOffset;
+};
+
+struct OPENINPUTPLUGIN_API FOpenInputCompiledDynamicGestures
+{
+	TArray<FOpenInputDynamicGestureTemplate> Templates;
+	TArray<float> Values;
+
+	// Cells a recognizer needs, one per template sample plus a leading one per template
+	int32 StateSize;
+
+	// Number of gestures in the source when compiled, a mismatch means it was added to without being recompiled
+	int32 SourceGestureCount;
+
+	// Changes every compile so recognizers know their state is for an old layout
+	uint32 Serial;
+
+	FOpenInputCompiledDynamicGestures()
+	{
+		StateSize = 0;
+		SourceGestureCount = INDEX_NONE;
+		Serial = 0;
+	}
+
+	void Compile(const TArray<FOpenInputDynamicGesture> & Gestures);
+};
+
+// Streaming subsequence DTW (SPRING) against every compiled template at once, one hand per recognizer.
+// Each frame advances a single warp column per template so the cost is O(templates * template length) with no rescans,
+// the column carries where its best path started so a match is reported once it can no longer be improved on.
+struct OPENINPUTPLUGIN_API FOpenInputDynamicGestureRecognizer
+{
+	TArray<float> Costs;
+	TArray<int32> Starts;
+
+	// Best complete match per template waiting to be reported
+	TArray<float> PendingCost;
+	TArray<int32> PendingStart;
+	TArray<int32> PendingEnd;
+
+	int32 FrameNumber;
+	uint32 CompiledSerial;
+
+	// Time towards the next sample, the component feeds frames at a fixed rate so templates are rate independent
+	float TimeSinceSample;
+
+	FOpenInputDynamicGestureRecognizer()
+	{
+		FrameNumber = 0;
+		CompiledSerial = 0;
+		TimeSinceSample = 0.f;
+	}
+
+	void Reset(const FOpenInputCompiledDynamicGestures & Compiled);
+
+	// Feeds the next sample, adds the source index of every gesture that just finished to OutRecognized
+	void AddFrame(const FOpenInputCompiledDynamicGestures & Compiled, const FBPOpenVRGesturePoseData & PoseData, TArray<int32> & OutRecognized);
+};
+
+// One frames gesture detection for a components hands, filled on the game thread once every pose is in and run on a worker.
+// Only the compiled data is touched off thread, the component applies the results back on the game thread in hand order.
+struct OPENINPUTPLUGIN_API FOpenInputGestureJob
+{
+	struct FHandInput
+	{
+		// Into the components HandSkeletalActions, and Recognizers
+		int32 ActionIndex;
+		EVRActionHand TargetHand;
+		EVROpenInputSkeletalTrackingLevel TrackingLevel;
+		FBPOpenVRGesturePoseData PoseData;
+
+		// Static matching needs the standard five curls, dynamic is only fed on sample frames
+		bool bDetectStatic;
+		bool bFeedDynamic;
+	};
+
+	struct FHandResult
+	{
+		int32 StaticMatch;
+		TArray<int32> DynamicMatches;
+	};
+
+	TArray<FHandInput> Hands;
+
+	// One per entry in Hands
+	TArray<FHandResult> Results;
+
+	// Moved in from the component for the duration of the job
+	TArray<FOpenInputDynamicGestureRecognizer> Recognizers;
+
+	// Held so a recompile on the game thread can't pull the data out from under the worker
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> CompiledGestures;
+	TSharedPtr<const FOpenInputCompiledDynamicGestures, ESPMode::ThreadSafe> CompiledDynamicGestures;
+	bool bUseClosestMatch;
+
+	FOpenInputGestureJob()
+	{
+		bUseClosestMatch = false;
+	}
+
+	void Run();
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "OpenInputFunctionLibrary.h"
+
+#include "OpenInputHandLOD.generated.h"
+
+class UOpenInputSkeletalMeshComponent;
+class UNetConnection;
+
+// Picks an EOpenInputHandRepTier for every receiving connection of every component with bUseHandLOD, from how far away the hands are,
+// whether they are in front of the connections view and how much of vr.OpenInput.HandBytesPerConnection the nearer hands already took.
+// Runs every vr.OpenInput.HandLODInterval seconds on servers, the containers read the result as they are written to each connection.
+UCLASS()
+class OPENINPUTPLUGIN_API UOpenInputHandLODSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// Game thread only
+	void RegisterComponent(UOpenInputSkeletalMeshComponent * Component);
+	void UnregisterComponent(UOpenInputSkeletalMeshComponent * Component);
+
+	// Rough bytes per second a component costs a connection at a tier, both hands together
+	static float EstimateBytesPerSecond(UOpenInputSkeletalMeshComponent & Component, EOpenInputHandRepTier Tier);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+private:
+
+	struct FHandSource
+	{
+		UOpenInputSkeletalMeshComponent * Component;
+		FVector Location;
+		float TierCost[(uint8)EOpenInputHandRepTier::Tier_None];
+	};
+
+	struct FHandCandidate
+	{
+		int32 SourceIndex;
+		float DistanceSquared;
+		bool bInView;
+	};
+
+	TArray<TWeakObjectPtr<UOpenInputSkeletalMeshComponent>> Components;
+
+	// Rebuilt every pass, kept to avoid reallocating
+	TArray<FHandSource> Sources;
+	TArray<FHandCandidate> Candidates;
+
+	float TimeSinceUpdate;
+};
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "SceneViewExtension.h"
+
+class UOpenInputSkeletalMeshComponent;
+
+// Gives hand meshes a last chance to refresh their finger bones once the frame has finished ticking.
+// BeginRenderViewFamily runs on the game thread right before the view family is handed to the renderer,
+// so anything marked dirty here goes out with this frames dynamic data. Owned by FOpenInputPluginModule.
+class OPENINPUTPLUGIN_API FOpenInputLateUpdateViewExtension : public FSceneViewExtensionBase
+{
+public:
+
+	FOpenInputLateUpdateViewExtension(const FAutoRegister& AutoRegister);
+
+	// Game thread only
+	void RegisterComponent(UOpenInputSkeletalMeshComponent * Component);
+	void UnregisterComponent(UOpenInputSkeletalMeshComponent * Component);
+
+	// ISceneViewExtension
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override {}
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {}
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override;
+	virtual void PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override {}
+	virtual void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override {}
+	virtual bool IsActiveThisFrame(class FViewport* InViewport) const override;
+
+private:
+
+	TArray<TWeakObjectPtr<UOpenInputSkeletalMeshComponent>> Components;
+};
@@ -4,6 +4,13 @@
 
 #include "Modules/ModuleManager.h"
 
+class IOpenInputSkeletalBackend;
+class FOpenInputSyntheticSkeletalBackend;
+class FOpenInputPoseSampler;
+class FOpenInputSkeletalActionRegistry;
+class FOpenInputSamplingThread;
+class FOpenInputLateUpdateViewExtension;
+
 class FOpenInputPluginModule : public IModuleInterface
 {
 public:
@@ -11,12 +18,60 @@ public:
 	FOpenInputPluginModule()
 	{
 		//OpenVRDLLHandle = nullptr;
+		ActiveSkeletalBackend = nullptr;
 	}
 
+	// Out of line so the owned backends can stay forward declared here
+	virtual ~FOpenInputPluginModule();
+
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 
+	// Cached so that per frame callers don't go through the module manager map
+	static FOpenInputPluginModule* Get() { return ModuleInstance; }
+
+	// The backend that all skeletal queries are routed through, null before startup / after shutdown
+	static IOpenInputSkeletalBackend* GetSkeletalBackend() { return ModuleInstance ? ModuleInstance->ActiveSkeletalBackend : nullptr; }
+
+	// Swaps the active backend, passing in null restores the OpenVR backend
+	// Externally owned backends must outlive their use here
+	void SetActiveSkeletalBackend(IOpenInputSkeletalBackend* NewBackend);
+
+	// Selects one of the built in backends by name (OpenVR, Synthetic), returns false if there is no match
+	bool SetActiveSkeletalBackendByName(FName BackendName);
+
+	FOpenInputSyntheticSkeletalBackend* GetSyntheticSkeletalBackend() const { return SyntheticSkeletalBackend.Get(); }
+
+	// Shared per frame sampler that local consumers read hand poses through, null before startup / after shutdown
+	static FOpenInputPoseSampler* GetPoseSampler() { return ModuleInstance ? ModuleInstance->PoseSampler.Get() : nullptr; }
+
+	// Cached action handles and skeleton metadata, shared by every query
+	static FOpenInputSkeletalActionRegistry* GetActionRegistry() { return ModuleInstance ? ModuleInstance->ActionRegistry.Get() : nullptr; }
+
+	// Background poller, only exists while vr.OpenInput.SamplingThread is enabled and the active backend supports off thread reads
+	static FOpenInputSamplingThread* GetSamplingThread() { return ModuleInstance ? ModuleInstance->SamplingThread.Get() : nullptr; }
+
+	// Starts / stops / re-rates the sampling thread to match its console variables
+	void RefreshSamplingThread();
+
+	// Pre render hook for late finger updates, created on first use as the engine has to be up to register it
+	static FOpenInputLateUpdateViewExtension* GetLateUpdateExtension();
+
+private:
+
+	static FOpenInputPluginModule* ModuleInstance;
+
+	TUniquePtr<IOpenInputSkeletalBackend> OpenVRSkeletalBackend;
+	TUniquePtr<FOpenInputSyntheticSkeletalBackend> SyntheticSkeletalBackend;
+	IOpenInputSkeletalBackend* ActiveSkeletalBackend;
+	TUniquePtr<FOpenInputPoseSampler> PoseSampler;
+	TUniquePtr<FOpenInputSkeletalActionRegistry> ActionRegistry;
+	TUniquePtr<FOpenInputSamplingThread> SamplingThread;
+	TSharedPtr<FOpenInputLateUpdateViewExtension, ESPMode::ThreadSafe> LateUpdateExtension;
+
+public:
+
 	//bool LoadOpenVRModule();
 	//void UnloadOpenVRModule();
 
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "OpenInputFunctionLibrary.h"
+
+// Constant angular velocity extrapolation of parent space bone rotations.
+// Velocities come from the change between consecutive samples, translations are left alone as finger bones don't stretch.
+class OPENINPUTPLUGIN_API FOpenInputPosePredictor
+{
+public:
+
+	// Feeds a sampled (not predicted) pose taken at SampleTime into the history, repeat times are ignored
+	static void AddSample(FOpenInputPosePredictionState & State, const FBPOpenVRPosePredictionSettings & Settings, const TArray<FTransform> & Transforms, double SampleTime);
+
+	// Writes Transforms pushed forward from SampleTime to TargetTime into OutTransforms, Transforms and OutTransforms may be the same array
+	static void Extrapolate(const FOpenInputPosePredictionState & State, const FBPOpenVRPosePredictionSettings & Settings, const TArray<FTransform> & Transforms, double SampleTime, double TargetTime, TArray<FTransform> & OutTransforms);
+
+	// Local hand stage, run on a freshly acquired action: records its sample then overwrites its transforms with the prediction for TargetTime
+	static void PredictActionPose(FBPOpenVRActionInfo & Action, double TargetTime);
+};
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "OpenInputFunctionLibrary.h"
+
+// Everything that changes what a shared sample looks like after conversion
+struct OPENINPUTPLUGIN_API FOpenInputPoseSamplerKey
+{
+	FString ActionName;
+	EVRActionHand TargetHand;
+	bool bWithController;
+	bool bMirrorLeftRight;
+	float WorldToMeters;
+
+	FOpenInputPoseSamplerKey()
+	{
+		TargetHand = EVRActionHand::EActionHand_Right;
+		bWithController = false;
+		bMirrorLeftRight = false;
+		WorldToMeters = 100.f;
+	}
+
+	FOpenInputPoseSamplerKey(const FBPOpenVRActionInfo & Action, float InWorldToMeters);
+
+	FORCEINLINE bool operator==(const FOpenInputPoseSamplerKey & Other) const
+	{
+		return TargetHand == Other.TargetHand &&
+			bWithController == Other.bWithController &&
+			bMirrorLeftRight == Other.bMirrorLeftRight &&
+			WorldToMeters == Other.WorldToMeters &&
+			ActionName == Other.ActionName;
+	}
+};
+
+// Handle a consumer holds onto for its shared sample
+struct OPENINPUTPLUGIN_API FOpenInputPoseSubscription
+{
+	int32 ChannelIndex;
+
+	FOpenInputPoseSubscription()
+	{
+		ChannelIndex = INDEX_NONE;
+	}
+
+	bool IsValid() const { return ChannelIndex != INDEX_NONE; }
+};
+
+// Queries each skeletal action from the runtime at most once per frame and hands the converted result to every subscriber.
+// Owned by FOpenInputPluginModule, game thread only.
+class OPENINPUTPLUGIN_API FOpenInputPoseSampler
+{
+public:
+
+	// Registers interest in the action described by this info, the returned subscription is used for reads
+	FOpenInputPoseSubscription Subscribe(const FBPOpenVRActionInfo & Action, UObject * WorldContextObject);
+	void Unsubscribe(FOpenInputPoseSubscription & Subscription);
+
+	// Fills the requested products of the consumers action from this frames shared sample, sampling the runtime first if no one has
+	// this frame or earlier consumers asked for less. Products not requested are left untouched on the action.
+	// Re-subscribes on its own if the action settings changed since the last call.
+	bool AcquirePose(FOpenInputPoseSubscription & Subscription, FBPOpenVRActionInfo & Action, UObject * WorldContextObject, EOpenInputPoseProducts Products);
+
+	// With the sampling thread running, fills the action from the sample closest to an FPlatformTime::Seconds() time.
+	// Returns false if there is no thread or no history for this subscription yet.
+	bool ReadSampleNearTime(const FOpenInputPoseSubscription & Subscription, double TargetTime, FBPOpenVRActionInfo & Action, UObject * WorldContextObject);
+
+	// A second, fresher read of the subscriptions action for consumers that patch the pose right before rendering.
+	// Sampled at most once per frame per channel and kept apart from the frames shared sample, bones only.
+	// Returns null if the action has no valid data right now, or if the read holds nothing newer than this frames shared sample.
+	// That is the usual case with OpenVR, which only updates once a frame on the game thread, so this only pays off with a
+	// sampling thread or backend that can see data newer than the tick.
+	const FBPOpenVRActionInfo * AcquireLatePose(const FOpenInputPoseSubscription & Subscription, UObject * WorldContextObject);
+
+	static float GetWorldToMeters(const FBPOpenVRActionInfo & Action, UObject * WorldContextObject);
+
+private:
+
+	struct FSampledChannel
+	{
+		FOpenInputPoseSamplerKey Key;
+
+		// Configured from the key, this is what actually gets sampled
+		FBPOpenVRActionInfo SharedAction;
+
+		// Same configuration as SharedAction, filled by AcquirePose
+		FBPOpenVRActionInfo LateAction;
+		uint64 LateSampledFrame;
+		bool bLateSampleIsNewer;
+
+		uint64 SampledFrame;
+		bool bSampleSucceeded;
+		EOpenInputPoseProducts SampledProducts;
+		int32 SubscriberCount;
+
+		FSampledChannel()
+		{
+			SampledFrame = MAX_uint64;
+			LateSampledFrame = MAX_uint64;
+			bLateSampleIsNewer = false;
+			bSampleSucceeded = false;
+			SampledProducts = EOpenInputPoseProducts::None;
+			SubscriberCount = 0;
+		}
+	};
+
+	// Released channels are left in place with no subscribers and reused
+	TArray<FSampledChannel> Channels;
+
+	void SampleChannel(int32 ChannelIndex, FSampledChannel & Channel, UObject * WorldContextObject, EOpenInputPoseProducts Products);
+
+	// Tops up a channel already sampled this frame with products it doesn't have yet, leaving the ones it does untouched
+	void SampleMissingProducts(FSampledChannel & Channel, UObject * WorldContextObject, EOpenInputPoseProducts MissingProducts);
+	static void CopySampleTo(const FSampledChannel & Channel, FBPOpenVRActionInfo & Action, EOpenInputPoseProducts Products);
+};
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Templates/Atomic.h"
+#include "OpenInputFunctionLibrary.h"
+
+class IOpenInputSkeletalBackend;
+
+// One poll of a skeletal action straight from the runtime, nothing converted yet
+struct OPENINPUTPLUGIN_API FOpenInputRawPoseSample
+{
+	// FPlatformTime::Seconds() when the thread first saw this pose, polls that find it unchanged don't restamp it
+	double Timestamp;
+
+	vr::VRActionHandle_t ActionHandle;
+	vr::VRInputValueHandle_t ActiveOrigin;
+	bool bActive;
+
+	uint32 BoneCount;
+	vr::VRBoneTransform_t BoneTransforms[(uint8)EVROpenInputBones::eBone_Count];
+	float FingerCurls[vr::VRFinger_Count];
+	float FingerSplays[vr::VRFingerSplay_Count];
+
+	FOpenInputRawPoseSample()
+	{
+		Timestamp = 0.0;
+		ActionHandle = vr::k_ulInvalidActionHandle;
+		ActiveOrigin = vr::k_ulInvalidInputValueHandle;
+		bActive = false;
+		BoneCount = 0;
+	}
+};
+
+// Polls skeletal actions at a fixed rate off the game thread and keeps a short timestamped history of each.
+// There is one writer (this thread) per channel, readers never block: each ring slot is guarded by a sequence
+// counter that is odd while being written, a reader that sees it change simply retries or skips the slot.
+// Channels are configured from the game thread, the backend is captured on start and must report SupportsOffThreadReads.
+//
+// Only poses that differ from the last one published make it into the history, so timestamps mark when a pose appeared.
+// A changed pose is read twice and only published if both reads agree, so a read torn by the backend updating is dropped rather than stored.
+class OPENINPUTPLUGIN_API FOpenInputSamplingThread : public FRunnable
+{
+public:
+
+	static const int32 MaxChannels = 8;
+	static const int32 HistoryLength = 64;
+
+	FOpenInputSamplingThread(IOpenInputSkeletalBackend * InBackend, int32 InSampleRate);
+	virtual ~FOpenInputSamplingThread();
+
+	// Points a channel at an action, passing an invalid handle idles the channel
+	void SetChannelSource(int32 ChannelIndex, vr::VRActionHandle_t ActionHandle, bool bWithController);
+
+	// Samples per second, clamped to 30 - 2000
+	void SetSampleRate(int32 NewSampleRate);
+
+	// Copies the newest sample of the channel, false if there isn't one yet
+	bool ReadLatest(int32 ChannelIndex, FOpenInputRawPoseSample & OutSample) const;
+
+	// Copies the sample closest to the given FPlatformTime::Seconds() time
+	bool ReadNearest(int32 ChannelIndex, double TargetTime, FOpenInputRawPoseSample & OutSample) const;
+
+	// FPlatformTime::Seconds() the channel was last polled, whether or not that found a new pose. 0 if never.
+	double GetLastPollTime(int32 ChannelIndex) const;
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	struct FSlot
+	{
+		TAtomic<uint32> Sequence;
+		FOpenInputRawPoseSample Sample;
+
+		FSlot() : Sequence(0) {}
+	};
+
+	struct FChannel
+	{
+		TAtomic<uint64> ActionHandle;
+		TAtomic<bool> bWithController;
+
+		// Total samples ever written, the newest is in slot (WriteCount - 1) % HistoryLength
+		TAtomic<uint64> WriteCount;
+		FSlot Slots[HistoryLength];
+
+		// Bit pattern of the FPlatformTime::Seconds() of the last poll
+		TAtomic<uint64> LastPollTimeBits;
+
+		// Thread owned, what was last published to compare polls against
+		FOpenInputRawPoseSample LastPublished;
+		bool bHasPublished;
+
+		FChannel() : ActionHandle(vr::k_ulInvalidActionHandle), bWithController(false), WriteCount(0), LastPollTimeBits(0), bHasPublished(false) {}
+	};
+
+	IOpenInputSkeletalBackend * Backend;
+	FChannel Channels[MaxChannels];
+	TAtomic<int32> SampleRate;
+	TAtomic<bool> bStopRequested;
+	FRunnableThread * Thread;
+
+	// Thread owned, filled before being published into a slot
+	FOpenInputRawPoseSample ScratchSample;
+	FOpenInputRawPoseSample ConfirmSample;
+
+	// Reads the action into the sample, everything but the timestamp
+	void PollChannel(const FChannel & Channel, FOpenInputRawPoseSample & Sample) const;
+	static bool IsSamePose(const FOpenInputRawPoseSample & A, const FOpenInputRawPoseSample & B);
+
+	void SampleChannel(FChannel & Channel);
+	bool ReadSlot(const FChannel & Channel, uint64 SampleNumber, FOpenInputRawPoseSample & OutSample) const;
+};
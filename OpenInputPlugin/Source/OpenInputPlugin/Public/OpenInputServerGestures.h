@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "OpenInputGestureMatcher.h"
+
+#include "OpenInputServerGestures.generated.h"
+
+class UOpenInputSkeletalMeshComponent;
+
+// Matches the curls clients send up with Rep_CurlOnly / Rep_CurlAndSplay against every remote hands gesture database on the server.
+// All hands that received new data are gathered once a tick, matched in parallel and then have their events fired on the game thread
+// in registration order, so gameplay can trust gestures without each client reporting its own.
+UCLASS()
+class OPENINPUTPLUGIN_API UOpenInputServerGestureSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Hands per worker task, matching a hand is far too cheap to hand out one at a time
+	static const int32 HandsPerBatch = 16;
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// Game thread only
+	void RegisterComponent(UOpenInputSkeletalMeshComponent * Component);
+	void UnregisterComponent(UOpenInputSkeletalMeshComponent * Component);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+private:
+
+	struct FHandQuery
+	{
+		// Events fired while applying can destroy components further down the list
+		TWeakObjectPtr<UOpenInputSkeletalMeshComponent> Component;
+		int32 ActionIndex;
+
+		// Held so an event recompiling the database mid pass can't free it
+		TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> CompiledGestures;
+		const FBPOpenVRGesturePoseData * PoseData;
+		EVROpenInputSkeletalTrackingLevel TrackingLevel;
+		bool bUseClosestMatch;
+
+		// Not the standard five curls, left out of the batches and matched against the source gestures while applying
+		bool bScalar;
+
+		int32 Result;
+	};
+
+	TArray<TWeakObjectPtr<UOpenInputSkeletalMeshComponent>> Components;
+
+	// Rebuilt every pass, kept to avoid reallocating
+	TArray<FHandQuery> Queries;
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "OpenInputFunctionLibrary.h"
+
+class IOpenInputSkeletalBackend;
+
+// Everything about a skeletal action that only changes when the device or bindings behind it do
+struct OPENINPUTPLUGIN_API FOpenInputSkeletalActionEntry
+{
+	FString ActionName;
+	vr::VRActionHandle_t ActionHandle;
+
+	// The input source the runtime last reported for this action, a change means a different device is driving it
+	vr::VRInputValueHandle_t ActiveOrigin;
+
+	uint32 BoneCount;
+	TArray<int32> BoneParentIndexes;
+	EVROpenInputSkeletalTrackingLevel TrackingLevel;
+	bool bMetadataValid;
+
+	// Changes every time the metadata is reloaded, action infos compare against it to know when to re-copy
+	uint32 Serial;
+
+	FOpenInputSkeletalActionEntry()
+	{
+		ActionHandle = vr::k_ulInvalidActionHandle;
+		ActiveOrigin = vr::k_ulInvalidInputValueHandle;
+		BoneCount = 0;
+		TrackingLevel = EVROpenInputSkeletalTrackingLevel::VRSkeletalTrackingLevel_Max;
+		bMetadataValid = false;
+		Serial = 0;
+	}
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOpenInputSkeletalActionChanged, const FString& /*ActionName*/);
+
+// Process wide cache of action handles and skeleton metadata keyed by action name.
+// Entries are only reloaded when the runtime reports a different device behind an action, the handle goes bad,
+// or the whole registry is invalidated (backend swap / manifest reload). Owned by FOpenInputPluginModule, game thread only.
+class OPENINPUTPLUGIN_API FOpenInputSkeletalActionRegistry
+{
+public:
+
+	FOpenInputSkeletalActionRegistry()
+	{
+		NextSerial = 1;
+		LastPollFrame = MAX_uint64;
+	}
+
+	// Returns the entry with a valid handle for this action, or null if the runtime doesn't know it.
+	// InOutCachedIndex lets callers that query every frame skip the name lookup.
+	FOpenInputSkeletalActionEntry * ResolveAction(IOpenInputSkeletalBackend * Backend, const FString & ActionName, int32 & InOutCachedIndex);
+
+	// Loads bone count, hierarchy and tracking level if they aren't cached
+	bool EnsureMetadata(IOpenInputSkeletalBackend * Backend, FOpenInputSkeletalActionEntry & Entry);
+
+	// Feed in the active origin from skeletal action data, drops the cached metadata if it changed
+	void NotifyActiveOrigin(FOpenInputSkeletalActionEntry & Entry, vr::VRInputValueHandle_t NewActiveOrigin);
+
+	// The runtime no longer recognizes the handle, it will be looked up again on next use
+	void InvalidateHandle(FOpenInputSkeletalActionEntry & Entry);
+
+	// Drops every cached handle and all metadata, call when the backend changes or the action manifest is reloaded
+	void InvalidateAll();
+
+	// Checks every known action for a device change, at most once per frame.
+	// For callers that don't otherwise pull skeletal action data.
+	void PollDeviceChanges(IOpenInputSkeletalBackend * Backend);
+
+	// Broadcast when an actions cached data is dropped
+	FOpenInputSkeletalActionChanged OnActionChanged;
+
+private:
+
+	// Never shrinks so that cached indices stay valid
+	TArray<FOpenInputSkeletalActionEntry> Entries;
+	TMap<FString, int32> EntryIndexByName;
+
+	uint32 NextSerial;
+	uint64 LastPollFrame;
+
+	void InvalidateMetadata(FOpenInputSkeletalActionEntry & Entry);
+};
@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "OpenInputFunctionLibrary.h"
+
+// The skeletal input runtime that the function library reads hand data from.
+// Mirrors the subset of vr::IVRInput that the plugin uses so that the whole hand pipeline
+// can be driven by something other than SteamVR (headless build agents, load tests, replays).
+// Transforms are always returned in parent space, which is the only space the plugin consumes.
+class OPENINPUTPLUGIN_API IOpenInputSkeletalBackend
+{
+public:
+
+	virtual ~IOpenInputSkeletalBackend() {}
+
+	// Name used to select this backend from the command line / console
+	virtual FName GetBackendName() const = 0;
+
+	// False if the runtime behind this backend isn't running, callers should early out
+	virtual bool IsAvailable() const = 0;
+
+	// True if every getter may be called from another thread while the game thread is using the backend.
+	// The sampling thread is only started on backends that say so.
+	virtual bool SupportsOffThreadReads() const { return false; }
+
+	virtual vr::EVRInputError GetActionHandle(const FString & ActionName, vr::VRActionHandle_t & OutActionHandle) = 0;
+	virtual vr::EVRInputError GetBoneCount(vr::VRActionHandle_t ActionHandle, uint32 & OutBoneCount) = 0;
+	virtual vr::EVRInputError GetSkeletalActionData(vr::VRActionHandle_t ActionHandle, vr::InputSkeletalActionData_t & OutActionData) = 0;
+	virtual vr::EVRInputError GetBoneHierarchy(vr::VRActionHandle_t ActionHandle, vr::BoneIndex_t * OutParentIndices, uint32 IndexCount) = 0;
+	virtual vr::EVRInputError GetSkeletalTrackingLevel(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalTrackingLevel & OutTrackingLevel) = 0;
+	virtual vr::EVRInputError GetSkeletalSummaryData(vr::VRActionHandle_t ActionHandle, vr::VRSkeletalSummaryData_t & OutSummaryData) = 0;
+	virtual vr::EVRInputError GetSkeletalBoneData(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) = 0;
+	virtual vr::EVRInputError GetSkeletalReferenceTransforms(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalReferencePose ReferencePose, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) = 0;
+	virtual vr::EVRInputError GetSkeletalBoneDataCompressed(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, void * OutCompressedData, uint32 CompressedBufferSize, uint32 * OutRequiredCompressedSize) = 0;
+	virtual vr::EVRInputError DecompressSkeletalBoneData(const void * CompressedData, uint32 CompressedSize, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) = 0;
+};
+
+// Forwards straight to vr::VRInput(), this is the default backend
+class OPENINPUTPLUGIN_API FOpenInputOpenVRSkeletalBackend : public IOpenInputSkeletalBackend
+{
+public:
+
+	virtual FName GetBackendName() const override { return FName(TEXT("OpenVR")); }
+	virtual bool IsAvailable() const override;
+
+	// UpdateActionState rewrites the skeletal data on the game thread and OpenVR makes no promise its getters are safe against it
+	virtual bool SupportsOffThreadReads() const override { return false; }
+
+	virtual vr::EVRInputError GetActionHandle(const FString & ActionName, vr::VRActionHandle_t & OutActionHandle) override;
+	virtual vr::EVRInputError GetBoneCount(vr::VRActionHandle_t ActionHandle, uint32 & OutBoneCount) override;
+	virtual vr::EVRInputError GetSkeletalActionData(vr::VRActionHandle_t ActionHandle, vr::InputSkeletalActionData_t & OutActionData) override;
+	virtual vr::EVRInputError GetBoneHierarchy(vr::VRActionHandle_t ActionHandle, vr::BoneIndex_t * OutParentIndices, uint32 IndexCount) override;
+	virtual vr::EVRInputError GetSkeletalTrackingLevel(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalTrackingLevel & OutTrackingLevel) override;
+	virtual vr::EVRInputError GetSkeletalSummaryData(vr::VRActionHandle_t ActionHandle, vr::VRSkeletalSummaryData_t & OutSummaryData) override;
+	virtual vr::EVRInputError GetSkeletalBoneData(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) override;
+	virtual vr::EVRInputError GetSkeletalReferenceTransforms(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalReferencePose ReferencePose, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) override;
+	virtual vr::EVRInputError GetSkeletalBoneDataCompressed(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, void * OutCompressedData, uint32 CompressedBufferSize, uint32 * OutRequiredCompressedSize) override;
+	virtual vr::EVRInputError DecompressSkeletalBoneData(const void * CompressedData, uint32 CompressedSize, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) override;
+};
+
+// A single recorded hand sample for the synthetic backend to play back
+struct OPENINPUTPLUGIN_API FOpenInputSyntheticHandFrame
+{
+	TArray<vr::VRBoneTransform_t> BoneTransforms;
+	float FingerCurls[vr::VRFinger_Count];
+	float FingerSplays[vr::VRFingerSplay_Count];
+
+	FOpenInputSyntheticHandFrame()
+	{
+		FMemory::Memzero(FingerCurls);
+		FMemory::Memzero(FingerSplays);
+	}
+};
+
+// In process hand driver that needs no runtime or hardware.
+// Generates a deterministic 31 bone hand that opens and closes over time, or plays back recorded frames if given any.
+// Time is derived from the engine frame counter unless explicitly set, so two runs of the same frames produce the same data
+// (when polled from the sampling thread it follows the platform clock instead).
+class OPENINPUTPLUGIN_API FOpenInputSyntheticSkeletalBackend : public IOpenInputSkeletalBackend
+{
+public:
+
+	FOpenInputSyntheticSkeletalBackend();
+
+	// Total bones in the OpenVR hand skeleton
+	static const uint32 SyntheticBoneCount = (uint32)EVROpenInputBones::eBone_Count;
+
+	// Seconds per engine frame when time isn't explicitly set
+	float FixedFrameTime;
+
+	// How long a full open -> closed -> open cycle takes
+	float CurlCycleTime;
+
+	// What we report to consumers, defaults to a knuckles style controller
+	EVROpenInputSkeletalTrackingLevel TrackingLevel;
+
+	// Replaces the generated hand with recorded frames, passing in an empty array returns to generating
+	void SetReplayFrames(EVRActionHand Hand, const TArray<FOpenInputSyntheticHandFrame> & Frames);
+
+	// Pins the sample time instead of following the engine frame counter, negative values release it
+	void SetSampleTime(double NewSampleTime) { ExplicitSampleTime = NewSampleTime; }
+	double GetSampleTime() const;
+
+	// Reports a new active origin for every action, as if the user had swapped controllers
+	void SimulateDeviceChange() { ++DeviceGeneration; }
+
+	// Fills a frame with the generated pose for the given time
+	static void GenerateHandFrame(double SampleTime, float CycleTime, bool bLeftHand, FOpenInputSyntheticHandFrame & OutFrame);
+
+	virtual FName GetBackendName() const override { return FName(TEXT("Synthetic")); }
+	virtual bool IsAvailable() const override { return true; }
+	virtual bool SupportsOffThreadReads() const override { return true; }
+
+	virtual vr::EVRInputError GetActionHandle(const FString & ActionName, vr::VRActionHandle_t & OutActionHandle) override;
+	virtual vr::EVRInputError GetBoneCount(vr::VRActionHandle_t ActionHandle, uint32 & OutBoneCount) override;
+	virtual vr::EVRInputError GetSkeletalActionData(vr::VRActionHandle_t ActionHandle, vr::InputSkeletalActionData_t & OutActionData) override;
+	virtual vr::EVRInputError GetBoneHierarchy(vr::VRActionHandle_t ActionHandle, vr::BoneIndex_t * OutParentIndices, uint32 IndexCount) override;
+	virtual vr::EVRInputError GetSkeletalTrackingLevel(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalTrackingLevel & OutTrackingLevel) override;
+	virtual vr::EVRInputError GetSkeletalSummaryData(vr::VRActionHandle_t ActionHandle, vr::VRSkeletalSummaryData_t & OutSummaryData) override;
+	virtual vr::EVRInputError GetSkeletalBoneData(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) override;
+	virtual vr::EVRInputError GetSkeletalReferenceTransforms(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalReferencePose ReferencePose, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) override;
+	virtual vr::EVRInputError GetSkeletalBoneDataCompressed(vr::VRActionHandle_t ActionHandle, vr::EVRSkeletalMotionRange MotionRange, void * OutCompressedData, uint32 CompressedBufferSize, uint32 * OutRequiredCompressedSize) override;
+	virtual vr::EVRInputError DecompressSkeletalBoneData(const void * CompressedData, uint32 CompressedSize, vr::VRBoneTransform_t * OutTransforms, uint32 TransformCount) override;
+
+private:
+
+	// Handles are 1 based index into this, handle 0 is k_ulInvalidActionHandle
+	TArray<FString> ActionNames;
+
+	TArray<FOpenInputSyntheticHandFrame> ReplayFrames[2];
+	FOpenInputSyntheticHandFrame ScratchFrame;
+	double ExplicitSampleTime;
+	uint32 DeviceGeneration;
+	FCriticalSection SyntheticLock;
+
+	bool IsValidHandle(vr::VRActionHandle_t ActionHandle) const
+	{
+		return ActionHandle != vr::k_ulInvalidActionHandle && ActionHandle <= (vr::VRActionHandle_t)ActionNames.Num();
+	}
+
+	bool IsLeftHandHandle(vr::VRActionHandle_t ActionHandle) const
+	{
+		return ActionNames[ActionHandle - 1].Contains(TEXT("left"));
+	}
+
+	// Returns the frame to report for this handle, either a replay frame or the scratch frame filled with generated data
+	const FOpenInputSyntheticHandFrame & GetCurrentFrame(vr::VRActionHandle_t ActionHandle);
+};
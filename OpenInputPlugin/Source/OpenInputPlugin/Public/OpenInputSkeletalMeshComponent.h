@@ -16,6 +16,10 @@
 #endif
 
 #include "OpenInputFunctionLibrary.h"
+#include "OpenInputPoseSampler.h"
+#include "OpenInputPosePredictor.h"
+#include "OpenInputGestureMatcher.h"
+#include "OpenInputHandLOD.h"
 #include "Engine/DataAsset.h"
 
 #include "OpenInputSkeletalMeshComponent.generated.h"
@@ -70,9 +74,29 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture")
 		bool bUseFingerCurlOnly;
 
+	// Thresholds are multiplied by this while the gesture is held, above 1 the hand has to move further to leave it than it did to enter it
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture", meta = (ClampMin = "1.0", UIMin = "1.0", UIMax = "3.0"))
+		float ExitThresholdScale;
+
+	// Seconds the hand has to hold the gesture before it is detected, and the least it then stays detected for
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "1.0"))
+		float MinHoldTime;
+
+	// Seconds after the gesture ends before it can be detected again on the same hand
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "1.0"))
+		float Cooldown;
+
+	// Contexts this gesture belongs to, it is only matched while the component has at least one of them enabled.
+	// Gestures without any are always matched.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture")
+		TArray<FName> Contexts;
+
 	FOpenInputGesture()
 	{
 		bUseFingerCurlOnly = false;
+		ExitThresholdScale = 1.f;
+		MinHoldTime = 0.f;
+		Cooldown = 0.f;
 		InitPoseValues();
 		Name = NAME_None;
 	}
@@ -80,6 +104,9 @@ public:
 	FOpenInputGesture(bool bOnlyFingerCurl)
 	{
 		bUseFingerCurlOnly = bOnlyFingerCurl;
+		ExitThresholdScale = 1.f;
+		MinHoldTime = 0.f;
+		Cooldown = 0.f;
 		InitPoseValues();
 		Name = NAME_None;
 	}
@@ -97,6 +124,60 @@ public:
 	}
 };
 
+// A motion rather than a held pose (wave, snap, beckon), matched against the hand stream with dynamic time warping
+USTRUCT(BlueprintType, Category = "VRGestures")
+struct OPENINPUTPLUGIN_API FOpenInputDynamicGesture
+{
+	GENERATED_BODY()
+public:
+
+	// Name of the recorded gesture
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture")
+		FName Name;
+
+	// Curl / splay values sampled at the recording components DynamicGestureSampleRate, the motion can be performed faster or slower than this
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture")
+		TArray<FBPOpenVRGesturePoseData> Samples;
+
+	// If we should only use the curl values, splays are only reported by fully tracked hands
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture")
+		bool bUseFingerCurlOnly;
+
+	// Average distance between the hand and the recording per sample that still counts as performing it
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGesture", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "1.0"))
+		float MatchThreshold;
+
+	FOpenInputDynamicGesture()
+	{
+		Name = NAME_None;
+		bUseFingerCurlOnly = true;
+		MatchThreshold = 0.15f;
+	}
+};
+
+// Versions of UOpenInputGestureDatabase's own serialized data
+struct OPENINPUTPLUGIN_API FOpenInputGestureDatabaseVersion
+{
+	enum Type
+	{
+		BeforeCustomVersionWasAdded = 0,
+
+		// Cooked packages carry the compiled match tables, optionally in place of Gestures
+		CookedMatchTables,
+
+		// Cooked tables carry each gestures hold settings
+		GestureHoldSettings,
+
+		// Cooked tables carry each gestures contexts
+		GestureContexts,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	const static FGuid GUID;
+};
+
 /**
 * Items Database DataAsset, here we can save all of our game items
 */
@@ -110,14 +191,390 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
 		TArray <FOpenInputGesture> Gestures;
 
+	// Motion gestures in this database, detected when bDetectDynamicGestures is set on the component
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		TArray <FOpenInputDynamicGesture> DynamicGestures;
+
+	// Build a spatial index alongside the compiled gestures, speeds up closest match detection on databases with hundreds or more gestures.
+	// vr.OpenInput.BenchmarkGestureIndex shows where it starts paying off.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bBuildSpatialIndex;
+
+	// Cook only the flat match tables and leave Gestures empty in the cooked package, large libraries then load without a struct per gesture.
+	// Gestures stays empty at runtime until RestoreGestures is called, use GetNumGestures / GetGestureName to read the database instead.
+	UPROPERTY(EditAnywhere, Category = "VRGestures")
+		bool bStripGesturesOnCook;
+
+	// Fills Gestures back in from the cooked tables when they were stripped, call before reading or editing Gestures from blueprint
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+		void RestoreGestures();
+
+	UFUNCTION(BlueprintPure, Category = "VRGestures")
+		int32 GetNumGestures() const;
+
+	UFUNCTION(BlueprintPure, Category = "VRGestures")
+		FName GetGestureName(int32 GestureIndex) const;
+
+	// Copy of the gesture whether Gestures was stripped or not
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+		bool GetGesture(int32 GestureIndex, FOpenInputGesture & GestureOut) const;
+
+	// Index of the first (or closest) gesture matching the pose, INDEX_NONE if none do.
+	// Gestures only in DisabledContexts are skipped.
+	int32 MatchGesture(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, bool bClosestMatch, float & OutDistance, const TArray<FName> * DisabledContexts = nullptr);
+
+	// Same against a set the caller already holds, one of this databases GetSharedActiveGestures sets
+	int32 MatchGesture(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, bool bClosestMatch, float & OutDistance, const FOpenInputCompiledGestureSet & Compiled);
+
+	// The matching gesture closest to the pose rather than the first in the list, false if none match
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+		bool FindClosestGesture(const FBPOpenVRGesturePoseData & PoseData, EVROpenInputSkeletalTrackingLevel TrackingLevel, int32 & GestureIndex, float & Distance);
+
+	// Call after changing Gestures from blueprint, additions are picked up on their own but edits in place are not
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+		void RecompileGestures();
+
+	// Gestures flattened for matching, every component using this asset shares it
+	const FOpenInputCompiledGestureSet & GetCompiledGestures();
+	const FOpenInputCompiledDynamicGestures & GetCompiledDynamicGestures();
+
+	// For work running off the game thread, a recompile swaps in new data rather than changing what these point to
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> GetSharedCompiledGestures();
+	TSharedPtr<const FOpenInputCompiledDynamicGestures, ESPMode::ThreadSafe> GetSharedCompiledDynamicGestures();
+
+	// The compiled gestures with everything only in DisabledContexts left out of the tables.
+	// Built once per combination of disabled contexts and shared by every component using it, the full set when nothing is filtered.
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> GetSharedActiveGestures(const TArray<FName> & DisabledContexts);
+
+	// Same with the contexts already turned into bits of the current compiled set by GetContextBits
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> GetSharedActiveGestures(uint64 DisabledBits);
+
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 	UOpenInputGestureDatabase()
 	{
+		bBuildSpatialIndex = false;
+		bStripGesturesOnCook = false;
+		bGesturesStripped = false;
+	}
+
+private:
+
+	// Loaded from a cook with bStripGesturesOnCook, CompiledGestures is the only copy of the gestures
+	bool bGesturesStripped;
+
+	TSharedPtr<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> CompiledGestures;
+	TSharedPtr<FOpenInputCompiledDynamicGestures, ESPMode::ThreadSafe> CompiledDynamicGestures;
+
+	// Filtered copies of CompiledGestures keyed by their disabled context bits, emptied whenever it is rebuilt
+	TMap<uint64, TSharedPtr<FOpenInputCompiledGestureSet, ESPMode::ThreadSafe>> ActiveGestureSets;
+};
+
+// Tracks whether a locally sampled hand has stopped moving, an idle hand only has its curls checked each frame
+struct OPENINPUTPLUGIN_API FOpenInputIdleHandState
+{
+	// The pose the hand was last seen changing to, compared against rather than the previous frame so slow creep still wakes it
+	TArray<float> ReferenceCurls;
+	TArray<float> ReferenceSplays;
+	TArray<FQuat> ReferenceRotations;
+	bool bHasReference;
+
+	int32 StillFrames;
+	bool bIdle;
+
+	// Changed since the last time this hand was sent to the server / copied for replication
+	bool bDirtySinceSend;
+	uint32 LastSentCompressedHash;
+	double LastSendTime;
+
+	FOpenInputIdleHandState()
+	{
+		bHasReference = false;
+		StillFrames = 0;
+		bIdle = false;
+		bDirtySinceSend = true;
+		LastSentCompressedHash = 0;
+		LastSendTime = 0.0;
+	}
+
+	void Wake()
+	{
+		StillFrames = 0;
+		bIdle = false;
+	}
+
+	bool MatchesCurls(const FBPOpenVRGesturePoseData & PoseData, float Epsilon) const
+	{
+		if (PoseData.PoseFingerCurls.Num() != ReferenceCurls.Num() || PoseData.PoseFingerSplays.Num() != ReferenceSplays.Num())
+			return false;
+
+		for (int i = 0; i < ReferenceCurls.Num(); ++i)
+		{
+			if (!FMath::IsNearlyEqual(PoseData.PoseFingerCurls[i], ReferenceCurls[i], Epsilon))
+				return false;
+		}
+
+		for (int i = 0; i < ReferenceSplays.Num(); ++i)
+		{
+			if (!FMath::IsNearlyEqual(PoseData.PoseFingerSplays[i], ReferenceSplays[i], Epsilon))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool MatchesBones(const TArray<FTransform> & Transforms, float MaxAngleRadians) const
+	{
+		if (Transforms.Num() != ReferenceRotations.Num())
+			return false;
+
+		for (int i = 0; i < Transforms.Num(); ++i)
+		{
+			if (ReferenceRotations[i].AngularDistance(Transforms[i].GetRotation()) > MaxAngleRadians)
+				return false;
+		}
+
+		return true;
+	}
+
+	void CaptureReference(const FBPOpenVRActionInfo & Action, EOpenInputPoseProducts Products)
+	{
+		if (EnumHasAnyFlags(Products, EOpenInputPoseProducts::Summary))
+		{
+			ReferenceCurls = Action.PoseFingerData.PoseFingerCurls;
+			ReferenceSplays = Action.PoseFingerData.PoseFingerSplays;
+		}
+
+		if (EnumHasAnyFlags(Products, EOpenInputPoseProducts::Bones))
+		{
+			const TArray<FTransform> & Transforms = Action.SkeletalData.SkeletalTransforms;
+			ReferenceRotations.SetNumUninitialized(Transforms.Num(), false);
+
+			for (int i = 0; i < Transforms.Num(); ++i)
+			{
+				ReferenceRotations[i] = Transforms[i].GetRotation();
+			}
+		}
+
+		bHasReference = true;
+	}
+
+	// Compares a freshly sampled pose against the reference, returns true if it moved
+	bool UpdateStillness(const FBPOpenVRActionInfo & Action, EOpenInputPoseProducts Products, float CurlEpsilon, float MaxBoneAngleRadians, int32 FramesBeforeIdle)
+	{
+		bool bStill = bHasReference;
+
+		if (bStill && EnumHasAnyFlags(Products, EOpenInputPoseProducts::Summary))
+			bStill = MatchesCurls(Action.PoseFingerData, CurlEpsilon);
+
+		if (bStill && EnumHasAnyFlags(Products, EOpenInputPoseProducts::Bones))
+			bStill = MatchesBones(Action.SkeletalData.SkeletalTransforms, MaxBoneAngleRadians);
+
+		if (bStill)
+		{
+			if (++StillFrames >= FramesBeforeIdle)
+				bIdle = true;
+
+			return false;
+		}
+
+		CaptureReference(Action, Products);
+		Wake();
+		bDirtySinceSend = true;
+		return true;
+	}
+};
+
+// Decides when a locally sampled hand is next due to replicate with bAdaptiveReplicationRate, from how fast its fingers are moving
+struct OPENINPUTPLUGIN_API FOpenInputHandSendScheduler
+{
+	// Seconds the achieved rate is averaged over
+	static constexpr float RateTimeConstant = 1.0f;
+
+	// Seconds a burst of finger motion keeps the rate raised for after it stops
+	static constexpr float MotionHoldTime = 0.25f;
+
+	float TimeSinceDue;
+	bool bDue;
+
+	// Fastest curl change in curls per second, decays over MotionHoldTime
+	float CurlSpeed;
+	TArray<float> PreviousCurls;
+
+	// Hash of the last packet this hand was sent with, an identical one is only resent as a heartbeat
+	uint32 LastSentPayloadHash;
+
+	// Exponential average of sends per second
+	float AchievedRate;
+
+	FOpenInputHandSendScheduler()
+	{
+		TimeSinceDue = 0.0f;
+		bDue = false;
+		CurlSpeed = 0.0f;
+		LastSentPayloadHash = 0;
+		AchievedRate = 0.0f;
+	}
+
+	void UpdateMotion(const FBPOpenVRGesturePoseData & PoseData, float DeltaTime)
+	{
+		const TArray<float> & Curls = PoseData.PoseFingerCurls;
+
+		if (DeltaTime > 0.0f && Curls.Num() == PreviousCurls.Num())
+		{
+			float MaxChange = 0.0f;
+
+			for (int i = 0; i < Curls.Num(); ++i)
+			{
+				MaxChange = FMath::Max(MaxChange, FMath::Abs(Curls[i] - PreviousCurls[i]));
+			}
+
+			CurlSpeed = FMath::Max(CurlSpeed, MaxChange / DeltaTime);
+		}
+
+		PreviousCurls = Curls;
+	}
+
+	// Moves the schedule forward a frame, bDue is set if the hand should be sent this frame at the rate its motion calls for
+	void Advance(float DeltaTime, float BaseRate, float MaxRate, float FullRateCurlSpeed)
+	{
+		CurlSpeed *= FMath::Exp(-DeltaTime / MotionHoldTime);
+		AchievedRate *= FMath::Max(1.0f - DeltaTime / RateTimeConstant, 0.0f);
+
+		const float Alpha = FullRateCurlSpeed > 0.0f ? FMath::Clamp(CurlSpeed / FullRateCurlSpeed, 0.0f, 1.0f) : 0.0f;
+		const float TargetRate = FMath::Lerp(BaseRate, FMath::Max(BaseRate, MaxRate), Alpha);
+
+		TimeSinceDue += DeltaTime;
+		bDue = TargetRate > 0.0f && TimeSinceDue >= 1.0f / TargetRate;
+
+		if (bDue)
+			TimeSinceDue = 0.0f;
+	}
+
+	void NotifySent(uint32 PayloadHash)
+	{
+		LastSentPayloadHash = PayloadHash;
+		AchievedRate += 1.0f / RateTimeConstant;
+	}
+};
+
+// Which EOpenInputHandRepTier a server sends this components hands to each connection at, see UOpenInputHandLODSubsystem
+USTRUCT(BlueprintType, Category = "SkeletalData|HandLOD")
+struct OPENINPUTPLUGIN_API FBPOpenInputHandLODSettings
+{
+	GENERATED_BODY()
+public:
+
+	// Connections viewing from within this many cm get the hands in full
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandLOD", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float FullDistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandLOD", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float CurlAndSplayDistance;
+
+	// Connections further away than this get nothing
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandLOD", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float CurlOnlyDistance;
+
+	// Sends per second at Tier_CurlOnly, and at every tier below Tier_Full for transform replication types
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandLOD", meta = (ClampMin = "0.01", UIMin = "0.01"))
+		float LowRate;
+
+	// Half angle in degrees of the cone in front of a connections view the hands count as seen within
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandLOD", meta = (ClampMin = "0.0", ClampMax = "180.0", UIMin = "0.0", UIMax = "180.0"))
+		float ViewHalfAngle;
+
+	// The most a connection looking away from the hands gets, they stay roughly current for when it turns back
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "HandLOD")
+		EOpenInputHandRepTier OutOfViewTier;
+
+	FBPOpenInputHandLODSettings()
+	{
+		FullDistance = 500.f;
+		CurlAndSplayDistance = 1500.f;
+		CurlOnlyDistance = 5000.f;
+		LowRate = 2.f;
+		ViewHalfAngle = 70.f;
+		OutOfViewTier = EOpenInputHandRepTier::Tier_CurlOnly;
+	}
+
+	EOpenInputHandRepTier GetTierForDistance(float DistanceSquared) const
+	{
+		if (DistanceSquared <= FMath::Square(FullDistance))
+			return EOpenInputHandRepTier::Tier_Full;
+		else if (DistanceSquared <= FMath::Square(CurlAndSplayDistance))
+			return EOpenInputHandRepTier::Tier_CurlAndSplay;
+		else if (DistanceSquared <= FMath::Square(CurlOnlyDistance))
+			return EOpenInputHandRepTier::Tier_CurlOnly;
+
+		return EOpenInputHandRepTier::Tier_None;
 	}
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOpenVRGestureDetected, const FName &, GestureDetected, int32, GestureIndex, EVRActionHand, ActionHandType);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOpenVRGestureEnded, const FName &, GestureEnded, int32, GestureIndex, EVRActionHand, ActionHandType);
 
+enum class EOpenInputGestureEventType : uint8
+{
+	Detected,
+	Ended
+};
+
+// One gesture transition as seen by native listeners
+struct OPENINPUTPLUGIN_API FOpenInputGestureEvent
+{
+	EOpenInputGestureEventType Type;
+	EVRActionHand TargetHand;
+	FName GestureName;
+
+	// Into the databases DynamicGestures when bDynamicGesture, otherwise into Gestures
+	int32 GestureIndex;
+	bool bDynamicGesture;
+
+	// The hand that made the gesture, only valid for the duration of the broadcast
+	const FBPOpenVRActionInfo * Hand;
+};
+
+// Native versions of the gesture delegates, no reflection involved so C++ listeners can be called every frame without cost.
+// They fire before the blueprint delegates and in the same order.
+DECLARE_MULTICAST_DELEGATE_OneParam(FOpenInputNativeGestureEvent, const FOpenInputGestureEvent &);
+
+// A hand received a new pose, from the runtime on the owning client or from the network on everyone else
+DECLARE_MULTICAST_DELEGATE_OneParam(FOpenInputNativePoseEvent, const FBPOpenVRActionInfo &);
+
+class UOpenInputSkeletalMeshComponent;
+
+// Delivers the results of a components async gesture job, runs after the components own tick late in the frame
+USTRUCT()
+struct FOpenInputGestureEventTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	UOpenInputSkeletalMeshComponent * Target;
+
+	FOpenInputGestureEventTickFunction()
+	{
+		Target = nullptr;
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FOpenInputGestureEventTickFunction> : public TStructOpsTypeTraitsBase2<FOpenInputGestureEventTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
 UCLASS(Blueprintable, meta = (BlueprintSpawnableComponent))
 class OPENINPUTPLUGIN_API UOpenInputSkeletalMeshComponent : public USkeletalMeshComponent
 {
@@ -136,6 +593,16 @@ public:
 		bDetectGestures = bNewDetectGestures;
 	}
 
+	// Detect the matching gesture closest to the hand instead of the first one in the database, for large or overlapping databases.
+	// Pair with bBuildSpatialIndex on the database.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bUseClosestGestureMatch;
+
+	// Keeps the finger curl / splay values updated even when nothing on this component needs them,
+	// for blueprints reading GetFingerCurlAndSplayData without gesture detection or curl replication
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bAlwaysGetFingerCurlAndSplay;
+
 	UFUNCTION(BlueprintCallable, Category = "VRGestures")
 	bool GetFingerCurlAndSplayData(EVRActionHand TargetHand, FBPOpenVRGesturePoseData & OutFingerPoseData)
 	{
@@ -157,6 +624,18 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "VRGestures")
 		FOpenVRGestureEnded OnGestureEnded;
 
+	FOpenInputNativeGestureEvent OnGestureEventNative;
+	FOpenInputNativePoseEvent OnNewPoseNative;
+
+	// Fires the native then the blueprint delegates for one transition
+	void BroadcastGestureEvent(EOpenInputGestureEventType Type, const FBPOpenVRActionInfo & Hand, FName GestureName, int32 GestureIndex, bool bDynamicGesture);
+
+	FORCEINLINE void BroadcastNewPose(const FBPOpenVRActionInfo & Hand)
+	{
+		if (OnNewPoseNative.IsBound())
+			OnNewPoseNative.Broadcast(Hand);
+	}
+
 	// Known sequences
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
 		UOpenInputGestureDatabase *GesturesDB;
@@ -170,6 +649,93 @@ public:
 	// This version throws events
 	bool DetectCurrentPose(FBPOpenVRActionInfo &SkeletalAction);
 
+	// Index of the gesture matching the hand by the components rules, INDEX_NONE if nothing does
+	int32 FindGestureMatch(const FBPOpenVRActionInfo &SkeletalAction);
+
+	// Gesture contexts turned off on this component, gestures tagged only with these are not matched.
+	// Everything is enabled by default so untouched databases behave as before.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "VRGestures")
+		TArray<FName> DisabledGestureContexts;
+
+	// Turns a gesture context on or off for this components hands, takes effect from the next detection
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+		void SetGestureContextEnabled(FName Context, bool bEnabled);
+
+	UFUNCTION(BlueprintPure, Category = "VRGestures")
+		bool IsGestureContextEnabled(FName Context) const;
+
+	// The compiled gestures this component currently matches against, filtered by DisabledGestureContexts
+	TSharedPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> GetActiveGestures();
+
+	// DisabledGestureContexts as bits of the compiled set they were looked up in, redone only when the contexts change or the database recompiles
+	uint64 DisabledContextBits;
+	TWeakPtr<const FOpenInputCompiledGestureSet, ESPMode::ThreadSafe> DisabledContextBitsSource;
+	bool bDisabledContextBitsDirty;
+
+	// Fires the ended / detected events for the hand moving to GestureIndex (INDEX_NONE for no gesture), true if it changed.
+	// Changes the hold settings don't allow yet are held back, a new gesture until it has lasted its MinHoldTime, and counted once each in the hands GestureHoldState.
+	bool ApplyDetectedGesture(FBPOpenVRActionInfo &SkeletalAction, int32 GestureIndex);
+
+	// Gesture changes held back by MinHoldTime, ExitThresholdScale or Cooldown on this hand since play began
+	UFUNCTION(BlueprintPure, Category = "VRGestures")
+		int32 GetSuppressedGestureFlips(EVRActionHand TargetHand) const;
+
+	// Run gesture detection as a task graph job started once every hand is sampled instead of inline in the tick.
+	// Events for all hands are delivered together late in the frame, in hand order with each hands pose event before its motion events.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bDetectGesturesAsync;
+
+	// Filled during the tick and handed to a worker, only touched on the game thread while GestureJobEvent is clear
+	TSharedPtr<FOpenInputGestureJob, ESPMode::ThreadSafe> GestureJob;
+	FGraphEventRef GestureJobEvent;
+	FOpenInputGestureEventTickFunction GestureEventTickFunction;
+
+	void LaunchGestureJob();
+
+	// Waits for the in flight job if there is one and hands the recognizers back, optionally firing its events
+	void FinishGestureJob(bool bDeliverEvents);
+
+	virtual void RegisterComponentTickFunctions(bool bRegister) override;
+
+	// On a server, match the curls remote players replicate up (Rep_CurlOnly / Rep_CurlAndSplay) against GesturesDB
+	// and fire OnNewGestureDetected / OnGestureEnded for their hands. Every such hand on the server is matched in one batched pass a tick.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bDetectGesturesOnServer;
+
+	// Bit per entry in HandSkeletalActions that has received curls since the server gesture pass last ran
+	uint32 ServerPendingGestureHands;
+
+	// Match the DynamicGestures in GesturesDB against each hand as it moves.
+	// A recognized motion fires OnNewGestureDetected then OnGestureEnded straight away, with its index into DynamicGestures.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures")
+		bool bDetectDynamicGestures;
+
+	// How often hands are sampled for dynamic gestures, recording and detection should use the same rate
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "VRGestures", meta = (ClampMin = "1.0", UIMin = "10.0", UIMax = "90.0"))
+		float DynamicGestureSampleRate;
+
+	// Starts sampling a hand into a new dynamic gesture, needs bDetectDynamicGestures
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+		void StartRecordingDynamicGesture(FName RecordingName, bool bUseFingerCurlOnly = true, EVRActionHand HandToSave = EVRActionHand::EActionHand_Right);
+
+	// Adds the recording to GesturesDB, false if nothing usable was recorded
+	UFUNCTION(BlueprintCallable, Category = "VRGestures")
+		bool StopRecordingDynamicGesture();
+
+	bool bRecordingDynamicGesture;
+	EVRActionHand DynamicRecordingHand;
+	FOpenInputDynamicGesture DynamicRecording;
+
+	// One per entry in HandSkeletalActions, sized alongside PoseSubscriptions
+	TArray<FOpenInputDynamicGestureRecognizer> DynamicGestureRecognizers;
+	TArray<int32> RecognizedDynamicGestures;
+
+	void DetectDynamicGestures(FBPOpenVRActionInfo &SkeletalAction, FOpenInputDynamicGestureRecognizer & Recognizer, float DeltaTime);
+
+	// Advances the sample clock and records if needed, true when the recognizer is due a frame
+	bool ConsumeDynamicGestureSample(const FBPOpenVRActionInfo &SkeletalAction, FOpenInputDynamicGestureRecognizer & Recognizer, float DeltaTime);
+	void BroadcastDynamicGestures(const FBPOpenVRActionInfo &SkeletalAction, const TArray<int32> & GestureIndices);
+
 	// Need this as I can't think of another way for an actor component to make sure it isn't on the server
 	inline bool IsLocallyControlled() const
 	{
@@ -201,6 +767,10 @@ public:
 
 	virtual void OnUnregister() override;
 	virtual void BeginPlay() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Activate(bool bReset = false) override;
 	virtual void Deactivate() override;
@@ -208,6 +778,84 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|Actions")
 		TArray<FBPOpenVRActionInfo> HandSkeletalActions;
 
+	// One per entry in HandSkeletalActions, reads go through the module sampler so the runtime is only queried once a frame per action
+	TArray<FOpenInputPoseSubscription> PoseSubscriptions;
+	void ReleasePoseSubscriptions();
+
+	// What this components consumers need from the runtime this tick, the sampler skips every call outside of it
+	EOpenInputPoseProducts GetRequiredPoseProducts(bool bReplicationTick) const;
+
+	// Stop converting, predicting and replicating a local hand once it has held still for IdleFramesBeforeSkipping frames.
+	// While idle only the finger curls are read each frame, to notice it moving again and to keep gesture detection running.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|Idle")
+		bool bSkipIdleHands;
+
+	// How far a curl or splay value can drift from where the hand came to rest before it counts as moving
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|Idle", meta = (ClampMin = "0.0", ClampMax = "1.0", UIMin = "0.0", UIMax = "0.1"))
+		float IdleCurlEpsilon;
+
+	// How far in degrees any bone can rotate from where the hand came to rest before it counts as moving, checked on frames that convert bones
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|Idle", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "5.0"))
+		float IdleBoneAngleThreshold;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|Idle", meta = (ClampMin = "1", UIMin = "1"))
+		int32 IdleFramesBeforeSkipping;
+
+	// An idle hand is still fully sampled and replicated this often so that late joiners and dropped packets converge
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|Idle", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float IdleKeyframeInterval;
+
+	// Set bNoSkeletonUpdate while every local hand is idle so the anim graph isn't evaluated at all.
+	// Only use this if the hands are the only thing animating on this mesh.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|Idle")
+		bool bSkipAnimationWhenIdle;
+
+	UFUNCTION(BlueprintCallable, Category = "SkeletalData|Idle")
+		bool IsHandIdle(EVRActionHand TargetHand) const;
+
+	// One per entry in HandSkeletalActions, sized alongside PoseSubscriptions
+	TArray<FOpenInputIdleHandState> IdleHandStates;
+
+	// We set bNoSkeletonUpdate ourselves and need to give it back
+	bool bIdlePausedSkeletonUpdate;
+
+	void UpdateIdleAnimationPause(bool bAllHandsIdle);
+
+	// Re-reads the hand right before rendering and rotates the mapped finger bones by how far they moved since the anim graph ran.
+	// Local hands only, assumes an ApplyOpenInputTransform node drives those bones at full alpha.
+	// The root and wrist are left alone as the motion controller late update already covers them.
+	// OpenVR only updates skeletal data once a frame on the game thread, so this does nothing unless vr.OpenInput.SamplingThread
+	// or another backend can deliver a pose newer than the one the tick used.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SkeletalData|LateUpdate")
+		bool bLateUpdateFingers;
+
+	UFUNCTION(BlueprintCallable, Category = "SkeletalData|LateUpdate")
+		void SetLateUpdateFingers(bool bNewLateUpdateFingers);
+
+	// Used to fill LateUpdateBoneMappings when it is left blank, should match the anim node
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|LateUpdate")
+		EVROpenVRSkeletonType LateUpdateSkeletonType;
+
+	// The bones the late update is allowed to touch, leave blank for the LateUpdateSkeletonType defaults
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|LateUpdate")
+		FBPSkeletalMappingData LateUpdateBoneMappings;
+
+	// Called from the late update view extension, does nothing past the first call in a frame
+	void ApplyLateUpdate();
+
+	uint64 LateUpdateFrame;
+
+	// Mesh bone index per entry in LateUpdateBoneMappings, rebuilt when the mesh changes
+	TArray<int32> LateUpdateMeshBones;
+	TWeakObjectPtr<USkeletalMesh> LateUpdateMappedMesh;
+
+	// Scratch, kept around so the late update doesn't allocate
+	TArray<FTransform> LateUpdateLocalTransforms;
+	TBitArray<> LateUpdateDirtyBones;
+	TArray<FTransform> LateUpdatePredictedTransforms;
+
+	void RefreshLateUpdateBoneMap();
+
 	UPROPERTY(Replicated, Transient, ReplicatedUsing = OnRep_SkeletalTransformLeft)
 		FBPSkeletalRepContainer LeftHandRep;
 
@@ -232,17 +880,41 @@ public:
 		float UpdateRate;
 		TArray<FTransform> NewTransforms;
 
+		// Velocity history over received packets, used to keep the hand moving once the lerp runs out before the next one arrives
+		FOpenInputPosePredictionState PredictionState;
+		float LateTime;
+
+		double LastArrivalTime;
+
 		FTransformLerpManager()
 		{
 			bReplicatedOnce = false;
 			bLerping = false;
 			UpdateCount = 0.0f;
 			UpdateRate = 0.0f;
+			LateTime = 0.0f;
+			LastArrivalTime = 0.0;
 		}
 
-		void NotifyNewData(FBPOpenVRActionInfo& ActionInfo, int NetUpdateRate)
+		void NotifyNewData(FBPOpenVRActionInfo& ActionInfo, float NetUpdateRate, const FBPOpenVRPosePredictionSettings & PredictionSettings)
 		{
-			UpdateRate = (1.0f / NetUpdateRate);
+			// Adaptive senders arrive faster than the base rate, lerp over the gap packets are actually coming in at.
+			// Heartbeats after a pause are capped to the base rate so they don't crawl in over seconds.
+			const double ArrivalTime = FPlatformTime::Seconds();
+			const float BaseInterval = 1.0f / FMath::Max(NetUpdateRate, 1.0f);
+			const float MinLerpTime = 1.0f / 120.0f;
+
+			if (LastArrivalTime > 0.0)
+				UpdateRate = FMath::Lerp(UpdateRate, FMath::Clamp((float)(ArrivalTime - LastArrivalTime), MinLerpTime, BaseInterval), 0.5f);
+			else
+				UpdateRate = BaseInterval;
+
+			LastArrivalTime = ArrivalTime;
+			LateTime = 0.0f;
+
+			if (PredictionSettings.bPredictPose)
+				FOpenInputPosePredictor::AddSample(PredictionState, PredictionSettings, ActionInfo.SkeletalData.SkeletalTransforms, FPlatformTime::Seconds());
+
 			if (bReplicatedOnce)
 			{
 				bLerping = true;
@@ -260,12 +932,19 @@ public:
 			ActionInfo.SkeletalData.SkeletalTransforms[BoneToBlend].Blend(ActionInfo.OldSkeletalTransforms[BoneToBlend], NewTransforms[BoneToBlend], LerpVal);
 		}
 
-		void UpdateManager(float DeltaTime, FBPOpenVRActionInfo& ActionInfo)
+		void UpdateManager(float DeltaTime, FBPOpenVRActionInfo& ActionInfo, const FBPOpenVRPosePredictionSettings & PredictionSettings)
 		{
 			if (!ActionInfo.bHasValidData)
 				return;
 
-			if (bLerping)
+			if (!bLerping && bReplicatedOnce && PredictionSettings.bPredictPose && NewTransforms.Num() == ActionInfo.SkeletalData.SkeletalTransforms.Num())
+			{
+				// Reached the last packet and the next one is late, carry on from it
+				LateTime += DeltaTime;
+				FOpenInputPosePredictor::Extrapolate(PredictionState, PredictionSettings, NewTransforms, 0.0, LateTime, ActionInfo.SkeletalData.SkeletalTransforms);
+				ActionInfo.NotifyPoseChanged();
+			}
+			else if (bLerping)
 			{
 				UpdateCount += DeltaTime;
 				float LerpVal = FMath::Clamp(UpdateCount / UpdateRate, 0.0f, 1.0f);
@@ -275,6 +954,7 @@ public:
 					bLerping = false;
 					UpdateCount = 0.0f;
 					ActionInfo.SkeletalData.SkeletalTransforms = NewTransforms;
+					ActionInfo.NotifyPoseChanged();
 				}
 				else
 				{
@@ -317,6 +997,7 @@ public:
 					ActionInfo.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_MiddleFinger] = ActionInfo.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_MiddleFinger3];
 					ActionInfo.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_RingFinger] = ActionInfo.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_RingFinger3];
 					ActionInfo.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_Aux_PinkyFinger] = ActionInfo.SkeletalData.SkeletalTransforms[(uint8)EVROpenInputBones::eBone_PinkyFinger3];
+					ActionInfo.NotifyPoseChanged();
 				}
 			}
 		}
@@ -329,6 +1010,10 @@ public:
 	UFUNCTION()
 	virtual void OnRep_SkeletalTransformLeft()
 	{
+		// A delta we couldn't apply, the container still holds the last pose and there is nothing new to show or lerp to
+		if (LeftHandRep.bStaleDelta)
+			return;
+
 		for (int i = 0; i < HandSkeletalActions.Num(); i++)
 		{
 			if (HandSkeletalActions[i].SkeletalData.TargetHand == LeftHandRep.TargetHand)
@@ -345,7 +1030,9 @@ public:
 				}
 				
 				if(bSmoothReplicatedSkeletalData)
-					LeftHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations);
+					LeftHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations, RemotePredictionSettings);
+
+				BroadcastNewPose(HandSkeletalActions[i]);
 				break;
 			}
 		}
@@ -354,6 +1041,10 @@ public:
 	UFUNCTION()
 	virtual void OnRep_SkeletalTransformRight()
 	{
+		// A delta we couldn't apply, the container still holds the last pose and there is nothing new to show or lerp to
+		if (RightHandRep.bStaleDelta)
+			return;
+
 		for (int i = 0; i < HandSkeletalActions.Num(); i++)
 		{
 			if (HandSkeletalActions[i].SkeletalData.TargetHand == RightHandRep.TargetHand)
@@ -370,7 +1061,9 @@ public:
 				}
 				
 				if (bSmoothReplicatedSkeletalData)
-					RightHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations);
+					RightHandRepManager.NotifyNewData(HandSkeletalActions[i], ReplicationRateForSkeletalAnimations, RemotePredictionSettings);
+
+				BroadcastNewPose(HandSkeletalActions[i]);
 				break;
 			}
 		}
@@ -383,13 +1076,72 @@ public:
 	// If true we will lerp between updates of the skeletal mesh transforms and smooth the result
 	UPROPERTY(EditAnywhere, Category = SkeletalData)
 		bool bSmoothReplicatedSkeletalData;
+
+	// Extrapolation for remote hands when the next update is late, needs bSmoothReplicatedSkeletalData
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SkeletalData)
+		FBPOpenVRPosePredictionSettings RemotePredictionSettings;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SkeletalData)
 		float ReplicationRateForSkeletalAnimations;
 
+	// Schedule each hand on its own, ReplicationRateForSkeletalAnimations while the fingers are slow rising to MaxReplicationRateForSkeletalAnimations
+	// during fast motion. A packet identical to the last one sent is held back until AdaptiveHeartbeatInterval passes.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|AdaptiveRate")
+		bool bAdaptiveReplicationRate;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|AdaptiveRate", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float MaxReplicationRateForSkeletalAnimations;
+
+	// Curl change per second, in the largest changing finger, at which a hand is sent at the max rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|AdaptiveRate", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float AdaptiveFullRateCurlSpeed;
+
+	// Seconds an adaptively scheduled hand goes without a send before it is resent unchanged, so late joiners and dropped packets converge
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|AdaptiveRate", meta = (ClampMin = "0.0", UIMin = "0.0"))
+		float AdaptiveHeartbeatInterval;
+
+	// Ceiling on the bytes per second both hands may send together, 0 for none. Sends over it wait for the budget to refill.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|AdaptiveRate", meta = (ClampMin = "0", UIMin = "0"))
+		int32 MaxHandBytesPerSecond;
+
+	// Sends per second this hand has been averaging with bAdaptiveReplicationRate
+	UFUNCTION(BlueprintPure, Category = "SkeletalData|AdaptiveRate")
+		float GetAchievedReplicationRate(EVRActionHand TargetHand) const;
+
+	// One per entry in HandSkeletalActions, sized alongside IdleHandStates
+	TArray<FOpenInputHandSendScheduler> HandSendSchedulers;
+
+	// Bytes the hands may still send under MaxHandBytesPerSecond
+	float HandBandwidthBudget;
+
+	// Whether an adaptively scheduled hand goes out, takes its bytes from the budget if it does
+	bool AdmitAdaptiveSend(FOpenInputHandSendScheduler & Scheduler, const FBPSkeletalRepContainer & Container, bool bHeartbeat);
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SkeletalData)
 		EVRSkeletalReplicationType ReplicationType;
 
+	// With Rep_HardTransforms or Rep_OpenInputCompressedTransforms, the server sends each client only the bones that moved since the pose that client last acknowledged,
+	// plus a full keyframe every vr.OpenInput.HardTransformKeyframeInterval sends. Compare with stat OpenInput's hard transform counters,
+	// vr.OpenInput.MeasureHardTransformSavings 1 fills in the full format baseline.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SkeletalData)
+		bool bDeltaCompressHardTransforms;
+
+	// On servers, send each receiving connection only as much of the hands as HandLODSettings gives it for where it is looking from.
+	// Curl replication types drop to curls only and the low rate further out. Transform types are always sent whole, as
+	// nothing builds bones from curls on receivers, and only drop to the low rate.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|HandLOD")
+		bool bUseHandLOD;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SkeletalData|HandLOD")
+		FBPOpenInputHandLODSettings HandLODSettings;
+
+	// Server side, written by UOpenInputHandLODSubsystem and read by LeftHandRep / RightHandRep as they replicate
+	TSharedPtr<FOpenInputHandRepTiers> HandRepTiers;
+
+	// How far Rep_HardTransforms and Rep_OpenInputCompressedTransforms may round each group of bones rotations, smaller errors cost more bits per bone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = SkeletalData)
+		FBPOpenInputRotationErrorBudget HardTransformRotationErrors;
+
 	// Used in Tick() to accumulate before sending updates, didn't want to use a timer in this case, also used for remotes to lerp position
 	float SkeletalNetUpdateCount;
 	// Used in Tick() to accumulate before sending updates, didn't want to use a timer in this case, also used for remotes to lerp position
@@ -413,6 +1165,9 @@ public:
 	EVRActionHand TargetHand;
 	TArray<FBPOpenVRActionSkeletalData> HandSkeletalActionData;
 
+	// PoseSerial of each action when its transforms were last copied, unchanged poses only copy the settings
+	TArray<uint32> CopiedPoseSerials;
+
 };
 
 UCLASS(transient, Blueprintable, hideCategories = AnimInstance, BlueprintType)